@@ -1,13 +1,112 @@
+#include <filesystem>
 #include <iostream>
+#include <string>
 
+#include "asset-store.hpp"
 #include "game.hpp"
 #include "log.hpp"
 
-int main()
+static const std::string ASSET_PACK_FILE = "breakthrough.pak";
+
+static int usage()
+{
+  std::cerr << "Usage: breakthroughgl [--tick-rate <hz>] "
+               "[--max-frame-rate <hz>] [--seed <seed>]\n"
+               "                      [--record <replay file>]\n"
+               "                      [--replay <replay file> "
+               "[--fast-forward]]\n"
+               "                      [--autopilot [--aim-for-bricks] "
+               "[--collect-power-ups]\n"
+               "                       [--miss-rate <fraction>]]\n"
+               "                      [--run-time <minutes>] "
+               "[--balls <count>]\n";
+  return 1;
+}
+
+int main(int argc, char **argv)
 {
+  GameOptions      options;
+  auto             max_frame_rate = 0.0;
+  auto             auto_pilot     = false;
+  AutoPilotOptions auto_pilot_options;
+  for (auto arg = 1; arg < argc; ++arg)
+  {
+    const std::string option = argv[arg];
+
+    auto is_flag = true;
+    if (option == "--fast-forward")
+      options.fast_forward = true;
+    else if (option == "--autopilot")
+      auto_pilot = true;
+    else if (option == "--aim-for-bricks")
+      auto_pilot_options.aim_for_bricks = true;
+    else if (option == "--collect-power-ups")
+      auto_pilot_options.collect_power_ups = true;
+    else
+      is_flag = false;
+
+    if (is_flag)
+      continue;
+
+    if (arg + 1 == argc)
+      return usage();
+    const std::string value = argv[++arg];
+
+    try
+    {
+      if (option == "--tick-rate")
+        options.tick_rate = std::stof(value);
+      else if (option == "--max-frame-rate")
+        max_frame_rate = std::stod(value);
+      else if (option == "--seed")
+        options.seed = std::stoull(value);
+      else if (option == "--record")
+        options.record_file = value;
+      else if (option == "--replay")
+        options.replay_file = value;
+      else if (option == "--miss-rate")
+        auto_pilot_options.miss_rate = std::stof(value);
+      else if (option == "--run-time")
+        options.run_time = std::stod(value) * 60.0;
+      else if (option == "--balls")
+        options.ball_count = std::stoul(value);
+      else
+        return usage();
+    }
+    catch (const std::logic_error &)
+    {
+      return usage();
+    }
+  }
+
+  // A replay brings its own seed and tick rate and is not recorded again
+  if (options.tick_rate <= 0.0f || max_frame_rate < 0.0 ||
+      (!options.replay_file.empty() && !options.record_file.empty()))
+    return usage();
+
+  if (auto_pilot_options.miss_rate < 0.0f ||
+      auto_pilot_options.miss_rate > 1.0f || options.run_time < 0.0)
+    return usage();
+
+  // Replays do not know about the extra balls
+  if (options.ball_count > 0 &&
+      (!options.replay_file.empty() || !options.record_file.empty()))
+    return usage();
+
+  if (auto_pilot)
+    options.auto_pilot = auto_pilot_options;
+
   start_log_system();
 
-  auto res = Game(1280, 720).run();
+  // Without an asset pack the game runs from the loose resource files
+  if (std::filesystem::exists(ASSET_PACK_FILE))
+  {
+    AssetStore::mount(ASSET_PACK_FILE);
+  }
+
+  Game game(1280, 720, options);
+  game.set_max_frame_rate(max_frame_rate);
+  auto res = game.run();
 
   stop_log_system();
 
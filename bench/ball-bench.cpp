@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "game-simulation.hpp"
+#include "mapped-file.hpp"
+
+// Ticks of the game per displayed frame, at 120 Hz and 60 fps
+static const unsigned TICKS_PER_FRAME = 2;
+static const float    TICK_TIME       = 1.0f / 120.0f;
+
+// Frames to spread the balls out before and to measure after
+static const unsigned WARM_UP_FRAMES  = 120;
+static const unsigned MEASURED_FRAMES = 120;
+
+static int usage()
+{
+  std::cerr << "Usage: breakthroughgl_ball_bench <level file> "
+               "[frame budget ms]\n";
+  return 1;
+}
+
+// Mean time in seconds to simulate a frame with this many balls
+static double measure(const LevelData &level_data, unsigned ball_count)
+{
+  GameSimulation simulation(1280, 720);
+  simulation.set_level(level_data);
+  simulation.set_min_ball_count(ball_count);
+
+  const auto frame = [&simulation]() {
+    for (unsigned tick = 0; tick < TICKS_PER_FRAME; ++tick)
+    {
+      // Starts over after each won or lost game, the paddle stays put
+      GameInput input;
+      input.confirm      = simulation.get_state() != GameState::GAME_ACTIVE;
+      input.release_ball = true;
+      simulation.tick(TICK_TIME, input);
+    }
+  };
+
+  for (unsigned i = 0; i < WARM_UP_FRAMES; ++i)
+    frame();
+
+  const auto start = std::chrono::steady_clock::now();
+  for (unsigned i = 0; i < MEASURED_FRAMES; ++i)
+    frame();
+  const std::chrono::duration<double> duration =
+      std::chrono::steady_clock::now() - start;
+
+  return duration.count() / MEASURED_FRAMES;
+}
+
+int main(int argc, char *argv[])
+{
+  if (argc < 2 || argc > 3)
+    return usage();
+
+  const std::string level_file = argv[1];
+  const double      budget = (argc > 2 ? std::atof(argv[2]) : 16.7) / 1000.0;
+  if (budget <= 0.0)
+    return usage();
+
+  LevelData level_data;
+  try
+  {
+    MappedFile mapped_file(level_file);
+    level_data = LevelData::load(mapped_file.data());
+  }
+  catch (const std::exception &error)
+  {
+    std::cerr << level_file << ": " << error.what() << "\n";
+    return 1;
+  }
+
+  const auto fits = [&](unsigned ball_count) {
+    const auto frame_time = measure(level_data, ball_count);
+    std::cout << ball_count << " balls: " << frame_time * 1000.0
+              << " ms per frame\n";
+    return frame_time <= budget;
+  };
+
+  // Doubles the balls until a frame takes too long, then narrows down
+  unsigned good = 0;
+  unsigned bad  = 64;
+  while (fits(bad))
+  {
+    good = bad;
+    bad *= 2;
+  }
+  while (bad - good > std::max(good / 32, 1u))
+  {
+    const auto middle = good + (bad - good) / 2;
+    if (fits(middle))
+      good = middle;
+    else
+      bad = middle;
+  }
+
+  std::cout << good << " balls fit in a frame of " << budget * 1000.0
+            << " ms\n";
+
+  return 0;
+}
@@ -0,0 +1,204 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "collision-kernel.hpp"
+
+namespace
+{
+
+// Mirrors the brick objects and the per brick collision test the game
+// used before bricks were tested in batches
+struct BrickObject
+{
+  glm::vec2 position, size, velocity;
+  glm::vec3 color;
+  float     rotation;
+  bool      solid;
+  bool      destroyed;
+
+  virtual ~BrickObject() {}
+};
+
+HitDirection calc_vector_direction(glm::vec2 target)
+{
+  const glm::vec2 compass[] = {
+      glm::vec2(0.0f, 1.0f),  // up
+      glm::vec2(1.0f, 0.0f),  // right
+      glm::vec2(0.0f, -1.0f), // down
+      glm::vec2(-1.0f, 0.0f)  // left
+  };
+  auto max        = 0.0f;
+  auto best_match = 0u;
+  for (auto i = 0u; i < 4; ++i)
+  {
+    const auto dot_product = glm::dot(glm::normalize(target), compass[i]);
+    if (dot_product > max)
+    {
+      max        = dot_product;
+      best_match = i;
+    }
+  }
+  return static_cast<HitDirection>(best_match);
+}
+
+void collide_objects(const std::vector<CollisionCircle> &             circles,
+                     const std::vector<std::unique_ptr<BrickObject>> &bricks,
+                     std::vector<CollisionHit> &                     hits)
+{
+  for (std::uint32_t i = 0; i < circles.size(); ++i)
+  {
+    const glm::vec2 center(circles[i].center_x, circles[i].center_y);
+
+    for (std::uint32_t j = 0; j < bricks.size(); ++j)
+    {
+      const auto &brick = *bricks[j];
+      if (brick.destroyed)
+        continue;
+
+      const glm::vec2 half_extents(brick.size.x / 2.0f, brick.size.y / 2.0f);
+      const glm::vec2 box_center(brick.position + half_extents);
+      const auto      clamped =
+          glm::clamp(center - box_center, -half_extents, half_extents);
+      const auto difference = box_center + clamped - center;
+
+      const auto distance = glm::length(difference);
+      if (distance < circles[i].radius)
+      {
+        hits.push_back({i,
+                        j,
+                        difference.x,
+                        difference.y,
+                        circles[i].radius - distance,
+                        calc_vector_direction(difference)});
+      }
+    }
+  }
+}
+
+template <typename Function>
+double measure(unsigned iterations, Function function)
+{
+  const auto start = std::chrono::steady_clock::now();
+  for (unsigned i = 0; i < iterations; ++i)
+    function();
+  const std::chrono::duration<double, std::micro> duration =
+      std::chrono::steady_clock::now() - start;
+  return duration.count() / iterations;
+}
+
+bool is_same_hits(const std::vector<CollisionHit> &a,
+                  const std::vector<CollisionHit> &b)
+{
+  if (a.size() != b.size())
+    return false;
+
+  for (std::size_t i = 0; i < a.size(); ++i)
+  {
+    if (a[i].circle != b[i].circle || a[i].box_id != b[i].box_id)
+      return false;
+
+    // The direction of a circle centered inside a box depends on rounding
+    const auto is_inside = b[i].difference_x == 0.0f &&
+                           b[i].difference_y == 0.0f;
+    if (!is_inside && a[i].direction != b[i].direction)
+      return false;
+  }
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+  const unsigned brick_count  = argc > 1 ? std::atoi(argv[1]) : 50000;
+  const unsigned circle_count = argc > 2 ? std::atoi(argv[2]) : 16;
+  const unsigned iterations   = argc > 3 ? std::atoi(argv[3]) : 200;
+
+  // A level of square bricks with the ball radius of the game
+  const auto      columns = 250u;
+  const glm::vec2 brick_size(8.0f, 8.0f);
+  const auto      radius = 12.5f;
+
+  std::mt19937                          random(42);
+  std::uniform_real_distribution<float> x_distribution(
+      0.0f,
+      columns * brick_size.x);
+  std::uniform_real_distribution<float> y_distribution(
+      0.0f,
+      (brick_count / columns + 1) * brick_size.y);
+
+  std::vector<std::unique_ptr<BrickObject>> objects;
+  CollisionBoxes                            boxes;
+  for (unsigned i = 0; i < brick_count; ++i)
+  {
+    auto object      = std::make_unique<BrickObject>();
+    object->position = glm::vec2(i % columns, i / columns) * brick_size;
+    object->size     = brick_size;
+    // Every fourth brick is destroyed, the batch only holds live bricks
+    object->destroyed = i % 4 == 3;
+    if (!object->destroyed)
+    {
+      boxes.add(object->position.x,
+                object->position.y,
+                brick_size.x,
+                brick_size.y,
+                i);
+    }
+    objects.push_back(std::move(object));
+  }
+
+  std::vector<CollisionCircle> circles;
+  for (unsigned i = 0; i < circle_count; ++i)
+    circles.push_back({x_distribution(random), y_distribution(random), radius});
+
+  std::cout << brick_count << " bricks, " << circle_count << " circles, "
+            << iterations << " iterations\n";
+
+  std::vector<CollisionHit> reference_hits;
+  const auto                reference_time = measure(iterations, [&]() {
+    reference_hits.clear();
+    collide_objects(circles, objects, reference_hits);
+  });
+
+  std::cout << std::fixed << std::setprecision(1) << std::setw(8) << "objects"
+            << std::setw(12) << reference_time << " us  "
+            << reference_hits.size() << " hits\n";
+
+  auto success = true;
+  for (const auto kernel : {CollisionKernel::SCALAR,
+                            CollisionKernel::SSE2,
+                            CollisionKernel::AVX2})
+  {
+    if (!is_collision_kernel_supported(kernel))
+    {
+      std::cout << std::setw(8) << get_collision_kernel_name(kernel)
+                << "  not supported\n";
+      continue;
+    }
+
+    std::vector<CollisionHit> hits;
+    const auto                time = measure(iterations, [&]() {
+      hits.clear();
+      collide_circles_with_boxes(kernel, circles, boxes, hits);
+    });
+
+    const auto is_same = is_same_hits(reference_hits, hits);
+    success            = success && is_same;
+
+    std::cout << std::setw(8) << get_collision_kernel_name(kernel)
+              << std::setw(12) << time << " us  " << hits.size() << " hits  "
+              << std::setprecision(2) << reference_time / time << "x"
+              << std::setprecision(1) << (is_same ? "" : "  MISMATCH")
+              << "\n";
+  }
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,92 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "game-environments.hpp"
+#include "mapped-file.hpp"
+
+static int usage()
+{
+  std::cerr << "Usage: breakthroughgl_environment_bench <level file> "
+               "[environments] [steps] [threads]\n";
+  return 1;
+}
+
+int main(int argc, char *argv[])
+{
+  if (argc < 2 || argc > 5)
+    return usage();
+
+  const std::string level_file   = argv[1];
+  const int         environments = argc > 2 ? std::atoi(argv[2]) : 4096;
+  const int         steps        = argc > 3 ? std::atoi(argv[3]) : 1000;
+  const int         threads =
+      argc > 4 ? std::atoi(argv[4]) : ThreadPool::default_thread_count();
+  if (environments <= 0 || steps <= 0 || threads <= 0)
+    return usage();
+
+  LevelData level_data;
+  try
+  {
+    MappedFile mapped_file(level_file);
+    level_data = LevelData::load(mapped_file.data());
+  }
+  catch (const std::exception &error)
+  {
+    std::cerr << level_file << ": " << error.what() << "\n";
+    return 1;
+  }
+
+  // The calling thread steps a range as well
+  ThreadPool       workers(threads - 1);
+  GameEnvironments game_environments(environments, level_data, 0, workers);
+
+  constexpr auto observation_size = GameEnvironments::OBSERVATION_SIZE;
+
+  std::vector<GameInput>    actions(environments);
+  std::vector<float>        observations(environments * observation_size);
+  std::vector<float>        rewards(environments);
+  std::vector<std::uint8_t> done(environments);
+  game_environments.observe(observations);
+
+  double   total_reward = 0.0;
+  unsigned games        = 0;
+
+  const auto start = std::chrono::steady_clock::now();
+  for (int step = 0; step < steps; ++step)
+  {
+    // Keeps each paddle under its ball
+    for (int i = 0; i < environments; ++i)
+    {
+      const auto observation = &observations[i * observation_size];
+      const auto distance    = observation[GameEnvironments::BALL_X] -
+                            observation[GameEnvironments::PADDLE_X];
+
+      actions[i].release_ball = true;
+      actions[i].move_left    = distance < -0.01f;
+      actions[i].move_right   = distance > 0.01f;
+    }
+
+    game_environments.step(actions, observations, rewards, done);
+
+    for (int i = 0; i < environments; ++i)
+    {
+      total_reward += rewards[i];
+      games += done[i];
+    }
+  }
+  const std::chrono::duration<double> duration =
+      std::chrono::steady_clock::now() - start;
+
+  const auto env_steps = static_cast<double>(environments) * steps;
+  std::cout << environments << " environments, " << steps << " steps on "
+            << threads << " threads in " << duration.count() * 1000.0
+            << " ms, " << env_steps / duration.count()
+            << " environment steps/s\n"
+            << games << " games finished, total reward " << total_reward
+            << "\n";
+
+  return 0;
+}
@@ -0,0 +1,70 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "replay.hpp"
+
+static int usage()
+{
+  std::cerr << "Usage: breakthroughgl_replay_bench <replay file> [repeats]\n";
+  return 1;
+}
+
+int main(int argc, char *argv[])
+{
+  if (argc < 2 || argc > 3)
+    return usage();
+
+  const std::string replay_file = argv[1];
+  const int         repeats     = argc > 2 ? std::atoi(argv[2]) : 10;
+  if (repeats <= 0)
+    return usage();
+
+  Replay replay;
+  try
+  {
+    replay = Replay::load(replay_file);
+  }
+  catch (const std::exception &error)
+  {
+    std::cerr << replay_file << ": " << error.what() << "\n";
+    return 1;
+  }
+
+  // Fast forwards the replay without waiting for anything, the best
+  // run is the least disturbed by the rest of the system
+  std::chrono::duration<double> best_duration{0.0};
+  for (int i = 0; i < repeats; ++i)
+  {
+    GameSimulation simulation(replay.get_width(),
+                              replay.get_height(),
+                              replay.get_seed());
+    ReplayPlayer   player(replay);
+
+    const auto start = std::chrono::steady_clock::now();
+    while (!player.is_done())
+      player.tick_simulation(simulation);
+    const std::chrono::duration<double> duration =
+        std::chrono::steady_clock::now() - start;
+
+    if (simulation.get_checksum() != replay.get_checksum())
+    {
+      std::cerr << replay_file << ": playback diverged from the recording\n";
+      return 1;
+    }
+
+    if (i == 0 || duration < best_duration)
+      best_duration = duration;
+  }
+
+  const auto ticks = replay.get_tick_count();
+  std::cout << ticks << " ticks ("
+            << ticks * replay.get_tick_time() << " s of play) in "
+            << best_duration.count() * 1000.0 << " ms, "
+            << ticks / best_duration.count() << " ticks/s, best of "
+            << repeats << "\n";
+
+  return 0;
+}
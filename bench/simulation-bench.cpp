@@ -0,0 +1,76 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "game-simulation.hpp"
+#include "mapped-file.hpp"
+
+static int usage()
+{
+  std::cerr << "Usage: breakthroughgl_simulation_bench <level file> "
+               "[ticks] [tick rate]\n";
+  return 1;
+}
+
+int main(int argc, char *argv[])
+{
+  if (argc < 2 || argc > 4)
+    return usage();
+
+  const std::string level_file = argv[1];
+  const unsigned    ticks      = argc > 2 ? std::atoi(argv[2]) : 1000000;
+  const float       tick_rate  = argc > 3 ? std::atof(argv[3]) : 120.0f;
+  if (tick_rate <= 0.0f)
+    return usage();
+
+  GameSimulation simulation(1280, 720);
+  try
+  {
+    MappedFile mapped_file(level_file);
+    simulation.set_level(LevelData::load(mapped_file.data()));
+  }
+  catch (const std::exception &error)
+  {
+    std::cerr << level_file << ": " << error.what() << "\n";
+    return 1;
+  }
+
+  unsigned bricks_destroyed = 0;
+  unsigned lives_lost       = 0;
+  unsigned wins             = 0;
+
+  const auto start = std::chrono::steady_clock::now();
+  for (unsigned i = 0; i < ticks; ++i)
+  {
+    // Keeps the paddle under the ball and starts over after each game
+    const auto &player   = simulation.get_player();
+    const auto  ball_x   = simulation.get_balls().get_center(0).x;
+    const auto  player_x = player.position.x + player.size.x / 2.0f;
+
+    GameInput input;
+    input.confirm      = simulation.get_state() != GameState::GAME_ACTIVE;
+    input.release_ball = true;
+    input.move_left    = ball_x < player_x - 10.0f;
+    input.move_right   = ball_x > player_x + 10.0f;
+
+    const auto state = simulation.get_state();
+    simulation.tick(1.0f / tick_rate, input);
+
+    const auto &events = simulation.get_events();
+    bricks_destroyed += events.count(GameEvent::Type::BRICK_DESTROYED);
+    lives_lost += events.count(GameEvent::Type::LIFE_LOST);
+    if (state == GameState::GAME_ACTIVE &&
+        simulation.get_state() == GameState::GAME_WIN)
+      ++wins;
+  }
+  const std::chrono::duration<double> duration =
+      std::chrono::steady_clock::now() - start;
+
+  std::cout << ticks << " ticks in " << duration.count() * 1000.0 << " ms, "
+            << ticks / duration.count() << " ticks/s\n"
+            << bricks_destroyed << " bricks destroyed, " << lives_lost
+            << " lives lost, " << wins << " levels won\n";
+
+  return 0;
+}
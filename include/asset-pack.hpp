@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mapped-file.hpp"
+
+/**
+ * @brief On disk header of an asset pack.
+ *
+ * A pack is laid out as header, table of contents, name table and the
+ * entry data. The table of contents is sorted by name hash and every
+ * section as well as every entry is aligned to ASSET_PACK_ALIGNMENT
+ * bytes, so the mapped file can be used in place. All values are
+ * little endian.
+ */
+struct AssetPackHeader
+{
+  char          magic[4];
+  std::uint32_t version;
+  std::uint32_t entry_count;
+  std::uint32_t reserved;
+  std::uint64_t toc_offset;
+  std::uint64_t names_offset;
+};
+
+/**
+ * @brief On disk table of contents entry of an asset pack.
+ */
+struct AssetPackEntry
+{
+  enum Flags : std::uint32_t
+  {
+    COMPRESSED = 1 << 0
+  };
+
+  std::uint64_t name_hash;
+  std::uint64_t content_hash; // hash of the uncompressed data
+  std::uint64_t offset;
+  std::uint64_t stored_size;
+  std::uint64_t size;
+  std::uint32_t name_offset; // relative to the name table
+  std::uint32_t name_length;
+  std::uint32_t flags;
+  std::uint32_t reserved;
+};
+
+static_assert(sizeof(AssetPackHeader) == 32);
+static_assert(sizeof(AssetPackEntry) == 56);
+
+constexpr char          ASSET_PACK_MAGIC[4]  = {'B', 'T', 'P', 'K'};
+constexpr std::uint32_t ASSET_PACK_VERSION   = 1;
+constexpr std::size_t   ASSET_PACK_ALIGNMENT = 64;
+
+/**
+ * @brief Read only view of a memory mapped asset pack.
+ */
+class AssetPack
+{
+public:
+  /**
+   * @brief Maps and validates an asset pack.
+   *
+   * @throws std::runtime_error if the file is not a valid asset pack
+   */
+  explicit AssetPack(const std::string &file);
+
+  /**
+   * @brief Looks up an entry by name.
+   *
+   * @return Entry or nullptr if the pack does not contain the name
+   */
+  const AssetPackEntry *find(std::string_view name) const;
+
+  std::span<const AssetPackEntry> get_entries() const { return entries; }
+
+  std::string_view get_name(const AssetPackEntry &entry) const;
+
+  /**
+   * @brief Data of an entry as stored in the pack.
+   *
+   * For compressed entries this is the compressed block.
+   */
+  std::span<const unsigned char> get_stored_data(
+      const AssetPackEntry &entry) const;
+
+  /**
+   * @brief Decompresses an entry if needed and checks its content hash.
+   *
+   * @return true if the content hash matches
+   */
+  bool verify(const AssetPackEntry &entry) const;
+
+private:
+  MappedFile                      file;
+  std::span<const AssetPackEntry> entries;
+  std::span<const char>           names;
+};
+
+/**
+ * @brief Builds asset packs.
+ */
+class AssetPackWriter
+{
+public:
+  /**
+   * @brief Adds an entry to the pack.
+   *
+   * @param name Name the entry is looked up by
+   * @param data Uncompressed content
+   * @param compress Store the entry compressed if that makes it smaller
+   */
+  void add(const std::string &            name,
+           std::span<const unsigned char> data,
+           bool                           compress);
+
+  void write(const std::string &file) const;
+
+private:
+  struct Entry
+  {
+    std::string                name;
+    std::vector<unsigned char> stored_data;
+    std::uint64_t              size;
+    std::uint64_t              content_hash;
+    bool                       compressed;
+  };
+
+  std::vector<Entry> pending_entries;
+};
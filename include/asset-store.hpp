@@ -0,0 +1,148 @@
+#pragma once
+
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "asset-pack.hpp"
+#include "file-reader.hpp"
+#include "mapped-file.hpp"
+#include "task.hpp"
+
+/**
+ * @brief Content of a single asset.
+ *
+ * The data is either a view into the mounted asset pack, a memory
+ * mapping of a loose file or a buffer holding a decompressed entry.
+ * In all cases the data stays valid as long as the Asset lives.
+ */
+class Asset
+{
+public:
+  explicit Asset(std::span<const unsigned char> data) : bytes(data) {}
+
+  explicit Asset(std::unique_ptr<MappedFile> mapping)
+      : bytes(mapping->data()),
+        mapping(std::move(mapping))
+  {
+  }
+
+  explicit Asset(std::vector<unsigned char> &&buffer)
+      : buffer(std::move(buffer))
+  {
+    bytes = this->buffer;
+  }
+
+  Asset(Asset &&) = default;
+
+  std::span<const unsigned char> data() const { return bytes; }
+
+  std::string_view as_string() const
+  {
+    return {reinterpret_cast<const char *>(bytes.data()), bytes.size()};
+  }
+
+private:
+  std::span<const unsigned char> bytes;
+  std::unique_ptr<MappedFile>    mapping;
+  std::vector<unsigned char>     buffer;
+
+  Asset(Asset &) = delete;
+};
+
+/**
+ * @brief Single entry point for reading game assets.
+ *
+ * Assets are addressed by their path relative to the resources
+ * directory. Files compiled into the binary with
+ * BREAKTHROUGHGL_EMBED_ASSETS take precedence over everything else.
+ * If an asset pack is mounted, assets are served from it
+ * without copying. Everything else falls back to loose files, which
+ * is what development builds use. Loose files are looked up in the
+ * cooked directory written by the build first and in the resources
+ * directory second.
+ */
+class AssetStore
+{
+public:
+  /**
+   * @brief Mounts an asset pack.
+   *
+   * Assets found in the pack take precedence over loose files. The
+   * content hash of every entry is checked here once, reads do not
+   * check it again.
+   *
+   * @throws std::runtime_error if the pack is invalid or corrupt
+   */
+  static void mount(const std::string &pack_file);
+
+  static void unmount();
+
+  static bool is_mounted() { return pack != nullptr; }
+
+  /**
+   * @brief Reads an asset.
+   *
+   * @param path Path relative to the resources directory
+   *
+   * @throws std::runtime_error if the asset does not exist
+   */
+  static Asset read(const std::string &path);
+
+  /**
+   * @brief Reads an asset without blocking.
+   *
+   * Assets in the mounted pack are available right away. Loose files
+   * are read into memory by the file reader, so the awaiting coroutine
+   * continues on the reader's completion thread.
+   *
+   * @throws std::runtime_error if the asset does not exist
+   */
+  static Task<Asset> read_async(FileReader &reader, std::string path);
+
+  /**
+   * @brief Checks whether an asset exists in the pack or as loose file.
+   */
+  static bool exists(const std::string &path);
+
+  /**
+   * @brief Lists the assets below a directory.
+   *
+   * Combines the entries of the mounted pack and the loose files.
+   *
+   * @return Sorted asset paths, relative to the resources directory
+   */
+  static std::vector<std::string> list(const std::string &directory);
+
+  /**
+   * @brief Returns the path of the loose file backing an asset.
+   *
+   * If the asset does not exist, the path below the resources
+   * directory is returned.
+   */
+  static std::string get_loose_path(const std::string &path);
+
+  /**
+   * @brief Whether an asset is read piece by piece while it plays.
+   *
+   * Streamed assets are the ones below the music directory. Asset
+   * packs store them uncompressed, so reading them maps the pack in
+   * place instead of decompressing the whole file to memory.
+   */
+  static bool is_streamed(std::string_view path)
+  {
+    return path.starts_with("music/");
+  }
+
+private:
+  static const std::vector<std::string> loose_directories;
+
+  static std::unique_ptr<AssetPack> pack;
+
+  AssetStore()              = delete;
+  ~AssetStore()             = delete;
+  AssetStore(AssetStore &)  = delete;
+  AssetStore(AssetStore &&) = delete;
+};
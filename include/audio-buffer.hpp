@@ -1,6 +1,6 @@
 #pragma once
 
-#include <vector>
+#include <span>
 
 #include "open-al.hpp"
 
@@ -15,10 +15,9 @@ public:
     STEREO16
   };
 
-  AudioBuffer(const Format                      format,
-              const std::vector<unsigned char> &data,
-              const std::int32_t                sample_rate,
-              const std::size_t                 size);
+  AudioBuffer(const Format                   format,
+              std::span<const unsigned char> data,
+              const std::int32_t             sample_rate);
 
   ~AudioBuffer();
 
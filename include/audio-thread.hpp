@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include <AL/alext.h>
+
+#include "audio-buffer.hpp"
+#include "audio-voice-pool.hpp"
+#include "open-al.hpp"
+#include "spsc-queue.hpp"
+
+/**
+ * @brief Plays sound effects from a thread of its own.
+ *
+ * AL calls take locks inside the AL implementation and check for
+ * errors after every call, which is too slow to do while a frame is
+ * rendered. The game thread only pushes commands into a lock-free
+ * queue, the audio thread runs them on an AudioVoicePool. With
+ * AL_SOFT_events AL reports when voices stop, so only those voices are
+ * asked for their state. Without the extension the pool polls all
+ * busy voices before every sound, on the audio thread.
+ *
+ * Only one thread may queue commands.
+ */
+class AudioThread
+{
+public:
+  static constexpr std::size_t COMMAND_CAPACITY = 256;
+  static constexpr std::size_t EVENT_CAPACITY   = 256;
+
+  explicit AudioThread(unsigned voice_count);
+
+  ~AudioThread();
+
+  AudioThread(const AudioThread &) = delete;
+
+  AudioThread &operator=(const AudioThread &) = delete;
+
+  /**
+   * @brief Queues a sound, see AudioVoicePool::play().
+   *
+   * The buffer has to outlive the audio thread.
+   *
+   * @return False if the queue is full and the sound is dropped
+   */
+  bool play(const AudioBuffer &buffer, unsigned priority, double time);
+
+  /**
+   * @brief Queues stopping all sounds.
+   */
+  bool stop();
+
+  /**
+   * @brief Queues setting the gain of all sounds.
+   */
+  bool set_gain(float gain);
+
+  unsigned get_voice_count() const { return voice_count; }
+
+  /**
+   * @brief Most voices that played at once since the last reset.
+   */
+  unsigned get_peak_count() const
+  {
+    return peak_count.load(std::memory_order_relaxed);
+  }
+
+  void reset_peak_count() { peak_count.store(0, std::memory_order_relaxed); }
+
+  bool has_state_events() const { return event_callback != nullptr; }
+
+private:
+  struct Command
+  {
+    enum class Type : std::uint8_t
+    {
+      PLAY,
+      STOP,
+      SET_GAIN
+    };
+
+    Type               type     = Type::PLAY;
+    const AudioBuffer *buffer   = nullptr;
+    unsigned           priority = 0;
+    float              gain     = 1.0f;
+    double             time     = 0.0;
+  };
+
+  AudioVoicePool voices;
+  const unsigned voice_count;
+
+  SpscQueue<Command, COMMAND_CAPACITY> commands;
+  SpscQueue<ALuint, EVENT_CAPACITY>    stopped_sources;
+
+  // Set if an event did not fit into the queue, the voices are polled
+  // once then
+  std::atomic<bool> lost_events = false;
+
+  // Counts commands and events, the thread sleeps while it is unchanged
+  std::atomic<std::uint32_t> wakeups    = 0;
+  std::atomic<bool>          stopping   = false;
+  std::atomic<unsigned>      peak_count = 0;
+
+  LPALEVENTCONTROLSOFT  event_control  = nullptr;
+  LPALEVENTCALLBACKSOFT event_callback = nullptr;
+
+  std::thread thread;
+
+  bool push(const Command &command);
+
+  void wake();
+
+  void run();
+
+  void execute(const Command &command);
+
+  void raise_peak_count(unsigned count);
+
+  void enable_state_events();
+
+  void disable_state_events();
+
+  /**
+   * @brief Called by AL on a thread of its own.
+   */
+  static void AL_APIENTRY on_event(ALenum        type,
+                                   ALuint        object,
+                                   ALuint        param,
+                                   ALsizei       length,
+                                   const ALchar *message,
+                                   void *        user) noexcept;
+};
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <vector>
+
+#include "audio-buffer.hpp"
+#include "open-al.hpp"
+
+/**
+ * @brief A fixed number of AL sources that sound effects share.
+ *
+ * Every sound plays on a voice of its own, so rapid hits do not cut
+ * each other off, and the number of voices bounds the mixing cost.
+ * When all voices are busy the least important and then the oldest
+ * voice is taken over. The same buffer triggered again within the
+ * merge time is dropped, since it would only add volume.
+ *
+ * Whether a voice is still playing is polled from AL by default. An
+ * owner that is told about state changes, like through AL_SOFT_events,
+ * turns polling off and reports sources that stopped with
+ * source_stopped().
+ */
+class AudioVoicePool
+{
+public:
+  /**
+   * @param merge_time In seconds
+   */
+  AudioVoicePool(unsigned voice_count, double merge_time = 0.01);
+
+  ~AudioVoicePool();
+
+  AudioVoicePool(const AudioVoicePool &) = delete;
+
+  AudioVoicePool &operator=(const AudioVoicePool &) = delete;
+
+  /**
+   * @brief Plays a buffer on a free or stolen voice.
+   *
+   * @param priority Voices with a higher priority are not stolen
+   * @param time Current time in seconds
+   *
+   * @return False if the sound was merged or all voices play more
+   * important sounds
+   */
+  bool play(const AudioBuffer &buffer, unsigned priority, double time);
+
+  unsigned get_voice_count() const
+  {
+    return static_cast<unsigned>(voices.size());
+  }
+
+  /**
+   * @brief Number of voices playing right now.
+   */
+  unsigned get_active_count();
+
+  /**
+   * @brief Most voices that played at once since the last reset.
+   */
+  unsigned get_peak_count() const { return peak_count; }
+
+  void reset_peak_count() { peak_count = 0; }
+
+  void set_polling(bool polling) { this->polling = polling; }
+
+  /**
+   * @brief Asks AL which voices are still playing.
+   */
+  void poll_states();
+
+  /**
+   * @brief Hints that a source stopped playing.
+   *
+   * The report may be older than the last sound played on the voice,
+   * so the state is confirmed with AL before the voice is freed.
+   * Sources that are no voice of the pool are ignored.
+   */
+  void source_stopped(ALuint source);
+
+  void stop_all();
+
+  /**
+   * @brief Sets the gain of all voices.
+   */
+  void set_gain(float gain);
+
+private:
+  struct Voice
+  {
+    ALuint   source     = 0;
+    ALuint   buffer     = 0;
+    unsigned priority   = 0;
+    double   start_time = 0.0;
+    bool     playing    = false;
+  };
+
+  std::vector<Voice> voices;
+  const double       merge_time;
+  unsigned           peak_count = 0;
+  bool               polling    = true;
+};
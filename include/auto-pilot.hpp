@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+#include "game-simulation.hpp"
+#include "random.hpp"
+
+struct AutoPilotOptions
+{
+  // Steers the ball toward the lowest bricks instead of keeping it
+  // close to the middle of the paddle
+  bool aim_for_bricks = false;
+
+  // Catches power-ups that help the player if that still leaves time
+  // to reach the ball
+  bool collect_power_ups = false;
+
+  // Fraction of balls missed on purpose, so lives get lost as well
+  float miss_rate = 0.0f;
+};
+
+/**
+ * @brief Plays the game without a player.
+ *
+ * Produces the input of a tick from the state of the simulation, so it
+ * stands in for the keyboard in unattended soak and performance runs.
+ * The paddle is moved to where the ball that comes down first will
+ * cross the paddle line, accounting for bounces off the walls but not
+ * off bricks.
+ */
+class AutoPilot
+{
+public:
+  /**
+   * @brief Where the ball center crosses the top of the paddle.
+   */
+  struct Landing
+  {
+    float x;
+    float time; // from now, in seconds
+  };
+
+  /**
+   * @param seed Seeds which balls are missed
+   */
+  AutoPilot(const AutoPilotOptions &options, std::uint64_t seed);
+
+  GameInput get_input(const GameSimulation &simulation);
+
+  /**
+   * @brief Predicts where a ball lands, as if no brick is in the way.
+   *
+   * @return Nothing if the ball does not move vertically
+   */
+  static std::optional<Landing>
+  predict_landing(const GameSimulation &simulation, std::size_t ball);
+
+private:
+  const AutoPilotOptions options;
+  Random                 random;
+
+  // State of the current approach of the ball
+  bool  approaching = false;
+  bool  missing     = false;
+  float aim         = 0.0f; // ball position on the paddle, -1 to 1
+
+  void start_approach(const GameSimulation &simulation,
+                      float                 landing_x,
+                      std::size_t           ball);
+
+  float aim_for_bricks(const GameSimulation &simulation,
+                       float                 landing_x,
+                       std::size_t           ball);
+
+  /**
+   * @brief Center of a power-up the paddle can catch before it has to
+   * be under the ball.
+   */
+  std::optional<float> find_power_up(const GameSimulation &simulation,
+                                     float                 target_x,
+                                     const Landing &       landing) const;
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+/**
+ * @brief All balls in play in structure of arrays layout.
+ *
+ * All arrays have the same length and all balls share one radius.
+ * Positions are the top left corner of the bounding box of a ball,
+ * like the position of a Transform. Removing a ball moves the last
+ * ball into its slot, so indices are not stable across removals.
+ */
+struct BallPool
+{
+  enum Flags : std::uint8_t
+  {
+    STUCK        = 1, // rides on the paddle until released
+    STICKY       = 2,
+    PASS_THROUGH = 4 // flies through breakable bricks
+  };
+
+  float radius = 0.0f;
+
+  std::vector<float>        position_x;
+  std::vector<float>        position_y;
+  std::vector<float>        previous_x; // position of the last tick
+  std::vector<float>        previous_y;
+  std::vector<float>        velocity_x;
+  std::vector<float>        velocity_y;
+  std::vector<std::uint8_t> flags;
+
+  std::size_t size() const { return position_x.size(); }
+
+  void add(glm::vec2 position, glm::vec2 velocity, std::uint8_t flags);
+
+  void remove(std::size_t index);
+
+  void clear();
+
+  glm::vec2 get_position(std::size_t index) const
+  {
+    return {position_x[index], position_y[index]};
+  }
+
+  void set_position(std::size_t index, glm::vec2 position)
+  {
+    position_x[index] = position.x;
+    position_y[index] = position.y;
+  }
+
+  glm::vec2 get_center(std::size_t index) const
+  {
+    return get_position(index) + radius;
+  }
+
+  glm::vec2 get_velocity(std::size_t index) const
+  {
+    return {velocity_x[index], velocity_y[index]};
+  }
+
+  void set_velocity(std::size_t index, glm::vec2 velocity)
+  {
+    velocity_x[index] = velocity.x;
+    velocity_y[index] = velocity.y;
+  }
+
+  bool has_flag(std::size_t index, Flags flag) const
+  {
+    return flags[index] & flag;
+  }
+
+  void set_flag(std::size_t index, Flags flag, bool value);
+
+  /**
+   * @brief Sets or clears a flag of every ball.
+   */
+  void set_flag(Flags flag, bool value);
+
+  /**
+   * @brief Keeps the current positions as the ones of the last tick.
+   */
+  void store_previous_positions();
+
+  /**
+   * @brief Position between the last two ticks.
+   *
+   * @param alpha 0 returns the previous position, 1 the current one
+   */
+  glm::vec2 get_interpolated_position(std::size_t index, float alpha) const
+  {
+    return glm::mix(glm::vec2(previous_x[index], previous_y[index]),
+                    get_position(index),
+                    alpha);
+  }
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * @brief Axis aligned boxes in structure of arrays layout.
+ *
+ * All arrays have the same length. Keeping the components apart lets
+ * the narrowphase load 4 or 8 boxes with one instruction.
+ */
+struct CollisionBoxes
+{
+  std::vector<float>         center_x;
+  std::vector<float>         center_y;
+  std::vector<float>         half_width;
+  std::vector<float>         half_height;
+  std::vector<std::uint32_t> ids; // passed through to the hits
+
+  std::size_t size() const { return center_x.size(); }
+
+  void clear();
+
+  void add(float         x,
+           float         y,
+           float         width,
+           float         height,
+           std::uint32_t id);
+};
+
+struct CollisionCircle
+{
+  float center_x;
+  float center_y;
+  float radius;
+};
+
+/**
+ * @brief Direction from the circle center to the closest point of the box.
+ */
+enum class HitDirection : std::uint8_t
+{
+  UP    = 0,
+  RIGHT = 1,
+  DOWN  = 2,
+  LEFT  = 3
+};
+
+struct CollisionHit
+{
+  std::uint32_t circle;
+  std::uint32_t box_id;
+  float         difference_x; // closest point on the box minus center
+  float         difference_y;
+  float         penetration;
+  HitDirection  direction;
+};
+
+enum class CollisionKernel
+{
+  SCALAR,
+  SSE2,
+  AVX2
+};
+
+/**
+ * @brief The fastest kernel the CPU supports, determined once.
+ */
+CollisionKernel get_best_collision_kernel();
+
+bool is_collision_kernel_supported(CollisionKernel kernel);
+
+const char *get_collision_kernel_name(CollisionKernel kernel);
+
+/**
+ * @brief Tests circles against a batch of boxes.
+ *
+ * A circle hits a box if the distance between its center and the
+ * closest point of the box is less than its radius. Hits are appended
+ * circle by circle, in box order.
+ *
+ * @return Number of hits appended
+ */
+std::size_t collide_circles_with_boxes(std::span<const CollisionCircle> circles,
+                                       const CollisionBoxes &           boxes,
+                                       std::vector<CollisionHit> &      hits);
+
+std::size_t collide_circles_with_boxes(CollisionKernel                  kernel,
+                                       std::span<const CollisionCircle> circles,
+                                       const CollisionBoxes &           boxes,
+                                       std::vector<CollisionHit> &      hits);
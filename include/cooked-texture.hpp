@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+/**
+ * @brief On disk header of a cooked texture.
+ *
+ * A cooked texture holds a complete mip chain in a format that can be
+ * handed to the GPU as is. The header is followed by one
+ * CookedTextureLevel record per mip level, largest level first, and
+ * the level data. All values are little endian.
+ */
+struct CookedTextureHeader
+{
+  char          magic[4];
+  std::uint32_t version;
+  std::uint32_t format;
+  std::uint32_t width;
+  std::uint32_t height;
+  std::uint32_t level_count;
+  std::uint64_t source_hash; // hash of the image the texture was cooked from
+};
+
+struct CookedTextureLevel
+{
+  std::uint32_t width;
+  std::uint32_t height;
+  std::uint64_t offset;
+  std::uint64_t size;
+};
+
+static_assert(sizeof(CookedTextureHeader) == 32);
+static_assert(sizeof(CookedTextureLevel) == 24);
+
+constexpr char          COOKED_TEXTURE_MAGIC[4]   = {'B', 'T', 'T', 'X'};
+constexpr std::uint32_t COOKED_TEXTURE_VERSION    = 1;
+constexpr char          COOKED_TEXTURE_EXTENSION[] = ".btex";
+
+/**
+ * @brief A parsed cooked texture.
+ *
+ * Level data points into the memory the texture was parsed from, so
+ * that memory has to outlive the CookedTexture.
+ */
+class CookedTexture
+{
+public:
+  enum class Format : std::uint32_t
+  {
+    RGB8  = 0,
+    RGBA8 = 1,
+    BC1   = 2, // S3TC DXT1, opaque
+    BC3   = 3  // S3TC DXT5, with alpha
+  };
+
+  struct Level
+  {
+    unsigned                       width;
+    unsigned                       height;
+    std::span<const unsigned char> data;
+  };
+
+  /**
+   * @brief Parses a cooked texture.
+   *
+   * @throws std::runtime_error if the data is not a valid cooked texture
+   */
+  explicit CookedTexture(std::span<const unsigned char> data);
+
+  Format get_format() const { return format; }
+
+  bool is_compressed() const
+  {
+    return format == Format::BC1 || format == Format::BC3;
+  }
+
+  std::uint64_t get_source_hash() const { return source_hash; }
+
+  const std::vector<Level> &get_levels() const { return levels; }
+
+  /**
+   * @brief Size in bytes of a level of the given dimensions.
+   */
+  static std::size_t level_size(Format format, unsigned width, unsigned height);
+
+  /**
+   * @brief Writes a cooked texture to disk.
+   *
+   * @param levels Mip levels, largest level first
+   */
+  static void write(const std::string &       file,
+                    Format                    format,
+                    std::uint64_t             source_hash,
+                    const std::vector<Level> &levels);
+
+private:
+  Format             format      = Format::RGBA8;
+  std::uint64_t      source_hash = 0;
+  std::vector<Level> levels;
+};
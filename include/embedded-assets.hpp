@@ -0,0 +1,179 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+
+#include "level-data.hpp"
+
+/**
+ * @brief A file compiled into the binary.
+ */
+struct EmbeddedFile
+{
+  std::string_view               path;
+  std::span<const unsigned char> data;
+};
+
+/**
+ * @brief A level compiled into the binary as a table of tile codes.
+ */
+struct EmbeddedLevel
+{
+  std::string_view               path;
+  std::size_t                    rows;
+  std::size_t                    columns;
+  std::span<const unsigned char> tiles;
+
+  /**
+   * @brief Copies the tiles into a level with the default palette,
+   * grown like for a text level loaded from a file.
+   */
+  LevelData to_level_data() const;
+};
+
+struct LevelSize
+{
+  std::size_t rows    = 0;
+  std::size_t columns = 0;
+};
+
+namespace detail
+{
+
+constexpr bool is_level_space(unsigned char c)
+{
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+constexpr bool is_level_digit(unsigned char c) { return c >= '0' && c <= '9'; }
+
+/**
+ * @brief Calls back with the row, column and code of every tile.
+ *
+ * Used by the constexpr level parser, which fails compilation by
+ * throwing if a level is malformed.
+ */
+template <typename Visitor>
+constexpr LevelSize visit_level(std::span<const unsigned char> content,
+                                Visitor                        visitor)
+{
+  LevelSize   size;
+  std::size_t column    = 0;
+  bool        empty_row = false;
+
+  for (std::size_t i = 0; i < content.size();)
+  {
+    const auto c = content[i];
+    if (is_level_space(c))
+    {
+      ++i;
+    }
+    else if (c == '\n')
+    {
+      // Empty rows are only allowed at the end, like parse_text does
+      if (column == 0)
+      {
+        empty_row = true;
+        ++i;
+        continue;
+      }
+      if (size.rows > 0 && column != size.columns)
+        throw std::invalid_argument("Level rows differ in length");
+
+      size.columns = column;
+      ++size.rows;
+      column = 0;
+      ++i;
+    }
+    else if (is_level_digit(c))
+    {
+      if (empty_row)
+        throw std::invalid_argument("Level contains an empty row");
+
+      unsigned code = 0;
+      for (; i < content.size() && is_level_digit(content[i]); ++i)
+      {
+        code = code * 10 + (content[i] - '0');
+        if (code > 255)
+          throw std::invalid_argument("Level tile code is out of range");
+      }
+
+      visitor(size.rows, column, static_cast<unsigned char>(code));
+      ++column;
+    }
+    else
+    {
+      throw std::invalid_argument("Level contains an invalid character");
+    }
+  }
+
+  // The last row does not need a trailing newline
+  if (column > 0)
+  {
+    if (size.rows > 0 && column != size.columns)
+      throw std::invalid_argument("Level rows differ in length");
+
+    size.columns = column;
+    ++size.rows;
+  }
+
+  if (size.rows == 0)
+    throw std::invalid_argument("Level is empty");
+
+  return size;
+}
+
+} // namespace detail
+
+/**
+ * @brief Determines the dimensions of a level at compile time.
+ */
+constexpr LevelSize measure_level(std::span<const unsigned char> content)
+{
+  return detail::visit_level(content,
+                             [](std::size_t, std::size_t, unsigned char) {});
+}
+
+/**
+ * @brief Parses a level into a row-major table of tile codes.
+ *
+ * Meant for constant evaluation, where a malformed level fails the
+ * build. The dimensions come from measure_level().
+ */
+template <std::size_t Rows, std::size_t Columns>
+constexpr std::array<unsigned char, Rows * Columns>
+parse_level(std::span<const unsigned char> content)
+{
+  std::array<unsigned char, Rows * Columns> tiles{};
+
+  const auto size = detail::visit_level(
+      content,
+      [&tiles](std::size_t row, std::size_t column, unsigned char code) {
+        if (row < Rows && column < Columns)
+          tiles[row * Columns + column] = code;
+      });
+
+  if (size.rows != Rows || size.columns != Columns)
+    throw std::invalid_argument("Level does not match its dimensions");
+
+  return tiles;
+}
+
+/**
+ * @brief Looks up a file compiled in with BREAKTHROUGHGL_EMBED_ASSETS.
+ *
+ * @param path Path relative to the resources directory
+ *
+ * @return The file or nullptr if it is not embedded
+ */
+const EmbeddedFile *find_embedded_file(std::string_view path);
+
+/**
+ * @brief Looks up a level compiled in with BREAKTHROUGHGL_EMBED_ASSETS.
+ *
+ * @return The level or nullptr if it is not embedded
+ */
+const EmbeddedLevel *find_embedded_level(std::string_view path);
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "thread-pool.hpp"
+
+/**
+ * @brief Reads whole files into memory in batches.
+ *
+ * On Linux all reads that are requested while the reader is busy are
+ * submitted together through io_uring, so loading many loose files
+ * costs one round of parallel I/O instead of a chain of serial reads.
+ * Only the reads are batched: the files of a batch are still opened
+ * and sized with a blocking open() and fstat() each on the completion
+ * thread before the batch is submitted. That is cheap for the few
+ * dozen files of the game, whose data sits in the page cache, but a
+ * batch of many small cold files spends most of its time there.
+ * If io_uring is not available, e.g. because of an old kernel or a
+ * seccomp filter, every read runs on the fallback thread pool instead.
+ *
+ * Callbacks run on the reader's completion thread or on a pool worker
+ * and should hand heavy work off instead of doing it in place.
+ */
+class FileReader
+{
+public:
+  using Callback =
+      std::function<void(std::vector<unsigned char> data,
+                         std::exception_ptr         error)>;
+
+  explicit FileReader(ThreadPool &fallback_workers);
+
+  ~FileReader();
+
+  /**
+   * @brief Reads a file and calls back with its content or the error.
+   */
+  void read(std::string file, Callback callback);
+
+  std::future<std::vector<unsigned char>> read(std::string file);
+
+  /**
+   * @brief Reads a file and continues the awaiting coroutine on the
+   * completion thread.
+   *
+   * @throws std::runtime_error if the file can not be read
+   */
+  auto read_async(std::string file)
+  {
+    struct Awaiter
+    {
+      FileReader &               reader;
+      std::string                file;
+      std::vector<unsigned char> data;
+      std::exception_ptr         error;
+
+      bool await_ready() noexcept { return false; }
+
+      void await_suspend(std::coroutine_handle<> handle)
+      {
+        // The callback may resume us before read() returns, so nothing
+        // here may touch the awaiter after the call
+        reader.read(file,
+                    [this, handle](std::vector<unsigned char> data,
+                                   std::exception_ptr         error) {
+                      this->data  = std::move(data);
+                      this->error = error;
+                      handle.resume();
+                    });
+      }
+
+      std::vector<unsigned char> await_resume()
+      {
+        if (error)
+          std::rethrow_exception(error);
+        return std::move(data);
+      }
+    };
+    return Awaiter{*this, std::move(file), {}, {}};
+  }
+
+  bool is_using_io_uring() const { return ring != nullptr; }
+
+private:
+  struct Request;
+  struct Ring;
+
+  ThreadPool &fallback_workers;
+
+  std::unique_ptr<Ring>                 ring;
+  std::deque<std::unique_ptr<Request>>  pending_requests;
+  std::mutex                            mutex;
+  std::condition_variable               condition;
+  bool                                  stopping = false;
+  std::thread                           completion_thread;
+
+  void process_requests();
+
+  static void read_blocking(Request &request);
+
+  FileReader(FileReader &)  = delete;
+  FileReader(FileReader &&) = delete;
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+
+/**
+ * @brief Distribution of frame times in constant memory.
+ *
+ * Frame times are counted in buckets of 0.1 ms up to 200 ms, longer
+ * frames share the last bucket. So runs of many hours cost as much as
+ * a single frame and percentiles are exact to a bucket.
+ */
+class FrameTimeStats
+{
+public:
+  static constexpr double      BUCKET_WIDTH = 0.0001;
+  static constexpr std::size_t BUCKET_COUNT = 2000;
+
+  /**
+   * @param frame_time In seconds
+   */
+  void add(double frame_time);
+
+  void reset();
+
+  std::uint64_t get_count() const { return count; }
+
+  double get_mean() const { return count > 0 ? sum / count : 0.0; }
+
+  double get_max() const { return max; }
+
+  /**
+   * @brief Frame time that the given fraction of frames does not exceed.
+   *
+   * @param fraction Between 0 and 1
+   *
+   * @return Upper end of the bucket holding the percentile
+   */
+  double get_percentile(double fraction) const;
+
+private:
+  std::array<std::uint64_t, BUCKET_COUNT> buckets{};
+
+  std::uint64_t count = 0;
+  double        sum   = 0.0;
+  double        max   = 0.0;
+};
+
+/**
+ * @brief Writes frame count, mean, percentiles and max in milliseconds.
+ */
+std::ostream &operator<<(std::ostream &out, const FrameTimeStats &stats);
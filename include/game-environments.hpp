@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "game-simulation.hpp"
+#include "thread-pool.hpp"
+
+/**
+ * @brief Many independent games stepped together, for bots and training.
+ *
+ * Every environment is a GameSimulation with its own seed, so the rules
+ * are the ones of the game. A step runs one tick of all environments,
+ * split into contiguous ranges over the workers and the calling thread.
+ *
+ * Results are written straight into buffers of the caller, laid out as
+ * one array per quantity with one entry per environment, so they can
+ * live in shared memory or a tensor without another copy. Stepping
+ * large batches amortizes handing the ranges to the workers.
+ */
+class GameEnvironments
+{
+public:
+  /**
+   * @brief Layout of the observation of one environment.
+   *
+   * Positions are divided by the size of the play field, velocities by
+   * the size of the play field per second.
+   */
+  enum Observation : std::size_t
+  {
+    PADDLE_X, // center
+    PADDLE_WIDTH,
+    BALL_X, // center
+    BALL_Y,
+    BALL_VELOCITY_X,
+    BALL_VELOCITY_Y,
+    BALL_STUCK,
+    LIVES,
+    BRICKS_LEFT,
+    OBSERVATION_SIZE
+  };
+
+  static constexpr float BRICK_REWARD     = 1.0f;
+  static constexpr float LIFE_LOST_REWARD = -5.0f;
+  static constexpr float WIN_REWARD       = 10.0f;
+
+  /**
+   * @param count Number of environments
+   * @param seed Environment i is seeded with seed + i
+   * @param workers Has to outlive the environments
+   */
+  GameEnvironments(std::size_t      count,
+                   const LevelData &level_data,
+                   std::uint64_t    seed,
+                   ThreadPool &     workers,
+                   float            tick_time = 1.0f / 120.0f,
+                   unsigned         width     = 1280,
+                   unsigned         height    = 720);
+
+  std::size_t size() const { return simulations.size(); }
+
+  const GameSimulation &get_simulation(std::size_t index) const
+  {
+    return simulations[index];
+  }
+
+  /**
+   * @brief Writes the current observations without stepping.
+   *
+   * @param observations OBSERVATION_SIZE floats per environment
+   */
+  void observe(std::span<float> observations) const;
+
+  /**
+   * @brief Runs one tick of every environment.
+   *
+   * Environments whose game is not running start a new one, so a
+   * finished game restarts with the next step.
+   *
+   * @param actions Input of every environment
+   * @param observations OBSERVATION_SIZE floats per environment
+   * @param rewards Reward of every environment for this step
+   * @param done Set to 1 for environments whose game ended in this
+   * step, to 0 otherwise
+   */
+  void step(std::span<const GameInput> actions,
+            std::span<float>           observations,
+            std::span<float>           rewards,
+            std::span<std::uint8_t>    done);
+
+private:
+  ThreadPool &workers;
+  const float tick_time;
+
+  std::vector<GameSimulation> simulations;
+
+  void step_range(std::size_t                begin,
+                  std::size_t                end,
+                  std::span<const GameInput> actions,
+                  std::span<float>           observations,
+                  std::span<float>           rewards,
+                  std::span<std::uint8_t>    done);
+
+  static void write_observation(const GameSimulation &simulation,
+                                float *               observation);
+};
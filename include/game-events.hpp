@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "power-up.hpp"
+
+/**
+ * @brief Something that happened in the game, for the side effects.
+ */
+struct GameEvent
+{
+  enum class Type : std::uint8_t
+  {
+    BRICK_DESTROYED,
+    SOLID_BRICK_HIT,
+    PADDLE_HIT,
+    POWER_UP_COLLECTED,
+    LIFE_LOST
+  };
+
+  Type type;
+
+  // Only set for POWER_UP_COLLECTED
+  std::optional<PowerUp::Type> power_up = std::nullopt;
+
+  glm::vec2 position = glm::vec2(0.0f); // where it happened
+};
+
+const std::size_t GAME_EVENT_TYPE_COUNT = 5;
+
+/**
+ * @brief The events of one tick in the order they happened.
+ *
+ * Gameplay code only pushes events. Sound, effects, power-up spawning
+ * and stats read the whole buffer once per tick and can merge events
+ * of a type through their counts. The buffer keeps its memory across
+ * ticks.
+ */
+class GameEvents
+{
+public:
+  void push(const GameEvent &event)
+  {
+    events.push_back(event);
+    ++counts[static_cast<std::size_t>(event.type)];
+  }
+
+  void clear()
+  {
+    events.clear();
+    counts.fill(0);
+  }
+
+  unsigned count(GameEvent::Type type) const
+  {
+    return counts[static_cast<std::size_t>(type)];
+  }
+
+  std::size_t size() const { return events.size(); }
+
+  std::vector<GameEvent>::const_iterator begin() const
+  {
+    return events.begin();
+  }
+
+  std::vector<GameEvent>::const_iterator end() const { return events.end(); }
+
+private:
+  std::vector<GameEvent>                      events;
+  std::array<unsigned, GAME_EVENT_TYPE_COUNT> counts{};
+};
@@ -1,25 +1,64 @@
 #pragma once
 
-#include "game-object.hpp"
+#include <string_view>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "level-data.hpp"
 
 /**
  * @brief A level of the game.
  *
  * GameLevel holds all tiles as part of a Breakout level and
- * hosts functionality to load/render levels from the harddisk.
+ * hosts functionality to load levels from the harddisk. Drawing is
+ * left to the presentation, so levels hold no GL state.
+ *
+ * Bricks are stored as a dense grid of tile codes into the level
+ * palette plus a bitset of destroyed grid cells. Empty cells count as
+ * destroyed, so a brick is alive if its bit is clear. A brick takes a
+ * byte and two bits, position and size follow from its cell.
  */
 class GameLevel
 {
 public:
+  /**
+   * @brief A brick as seen by collision handling.
+   */
+  struct Brick
+  {
+    glm::vec2 position;
+    glm::vec2 size;
+    bool      is_solid;
+  };
+
+  /**
+   * @brief A block of grid cells, the end row and column are exclusive.
+   */
+  struct CellRange
+  {
+    unsigned first_row    = 0;
+    unsigned end_row      = 0;
+    unsigned first_column = 0;
+    unsigned end_column   = 0;
+  };
+
   GameLevel(const std::string &file,
             unsigned           level_width,
             unsigned           level_height);
 
-  GameLevel(GameLevel &&game_level);
+  /**
+   * @brief Creates a level from already parsed level data.
+   */
+  GameLevel(LevelData level_data,
+            unsigned  level_width,
+            unsigned  level_height);
+
+  GameLevel(GameLevel &&) = default;
 
-  void operator=(GameLevel &&game_level);
+  GameLevel &operator=(GameLevel &&) = default;
 
-  void draw(std::shared_ptr<SpriteRenderer> renderer) const;
+  const LevelData &get_level_data() const { return level_data; }
 
   /**
    * @brief Check if the level is completed.
@@ -28,25 +67,73 @@ public:
    *
    * @return true on completed, false otherwise
    */
-  bool is_completed();
+  bool is_completed() const { return live_breakable_count == 0; }
+
+  /**
+   * @brief Number of breakable bricks still alive.
+   */
+  std::size_t get_breakable_count() const { return live_breakable_count; }
+
+  /**
+   * @brief Number of grid cells, alive or not.
+   */
+  std::size_t get_cell_count() const { return destroyed.size(); }
+
+  bool is_alive(std::size_t cell) const { return !destroyed[cell]; }
+
+  std::size_t get_cell(unsigned row, unsigned column) const
+  {
+    return std::size_t(row) * level_data.get_columns() + column;
+  }
+
+  /**
+   * @brief Returns the cells touched by an axis aligned box.
+   *
+   * Bricks sit on a regular grid, so this is the broadphase for
+   * collisions. The range is empty if the box misses the level.
+   */
+  CellRange get_cells(glm::vec2 min, glm::vec2 max) const;
 
-  std::vector<GameObject> &get_bricks() { return bricks; }
+  Brick get_brick(std::size_t cell) const;
+
+  /**
+   * @brief Tile code of a grid cell, an index into the level palette.
+   */
+  std::uint8_t get_tile(std::size_t cell) const
+  {
+    return level_data.get_tiles()[cell];
+  }
+
+  /**
+   * @brief Destroys the brick in a grid cell.
+   */
+  void destroy_brick(std::size_t cell);
 
   void reset();
 
-private:
-  std::vector<GameObject> bricks;
+  /**
+   * @brief Reads a level file, can run on any thread.
+   *
+   * A binary version of the level written by the level converter is
+   * preferred over the text file.
+   */
+  static LevelData load_from_file(const std::string &file);
 
-  std::vector<std::vector<unsigned>> tile_data;
+  /**
+   * @brief Returns the file a level should be read from.
+   */
+  static std::string get_level_file(const std::string &file);
+
+private:
+  LevelData level_data;
+  glm::vec2 brick_size{0.0f, 0.0f};
 
-  unsigned level_width  = 0;
-  unsigned level_height = 0;
+  std::vector<bool> destroyed;
+  std::vector<bool> initial_destroyed;
+  std::size_t       live_breakable_count    = 0;
+  std::size_t       initial_breakable_count = 0;
 
-  void load_from_file(const std::string &file,
-                      unsigned           level_width,
-                      unsigned           level_height);
+  void init(unsigned level_width, unsigned level_height);
 
-  void init(std::vector<std::vector<unsigned int>> tile_data,
-            unsigned                               level_width,
-            unsigned                               level_height);
+  glm::vec2 get_position(std::size_t cell) const;
 };
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "ball-pool.hpp"
+#include "collision-kernel.hpp"
+#include "game-events.hpp"
+#include "game-level.hpp"
+#include "power-up-effects.hpp"
+#include "power-up.hpp"
+#include "random.hpp"
+#include "swept-collision.hpp"
+#include "transform.hpp"
+
+enum class GameState
+{
+  GAME_ACTIVE,
+  GAME_MENU,
+  GAME_WIN
+};
+
+/**
+ * @brief Player input for one tick.
+ */
+struct GameInput
+{
+  bool move_left    = false;
+  bool move_right   = false;
+  bool release_ball = false;
+  bool confirm      = false; // starts a game or leaves the win screen
+};
+
+enum class BallHitTarget
+{
+  WALL,
+  PADDLE,
+  BRICK
+};
+
+struct BallHit
+{
+  SweepHit      sweep;
+  BallHitTarget target;
+  std::size_t   cell; // of the brick
+};
+
+const glm::vec2 PLAYER_SIZE(100.0f, 20.0f);
+
+const float PLAYER_VELOCITY(500.0f);
+
+const glm::vec2 INITIAL_BALL_VELOCITY(100.0f, -350.0f);
+
+const float BALL_RADIUS = 12.5f;
+
+// Contacts a ball resolves per update, the rest of the motion is
+// dropped if it gets wedged
+const unsigned MAX_BALL_BOUNCES = 8;
+
+// Balls the multi-ball power-up adds, split off at this angle in
+// radians to both sides of the ball
+const unsigned MULTI_BALL_COUNT = 2;
+const float    MULTI_BALL_ANGLE = 0.5f;
+
+/**
+ * @brief The rules of the game without any window, rendering or audio.
+ *
+ * Advances paddle, ball, bricks and power-ups in ticks driven by
+ * GameInput. The presentation reads the state and the events of the
+ * last tick, so the simulation also runs headless for tests, bots and
+ * benchmarks.
+ */
+class GameSimulation
+{
+public:
+  /**
+   * @param width Width of the play field
+   * @param height Height of the play field, the level fills the upper
+   * half
+   * @param seed Seeds all randomness, equal seeds and inputs give equal
+   * games
+   */
+  GameSimulation(unsigned width, unsigned height, std::uint64_t seed = 0);
+
+  /**
+   * @brief Replaces the level, the player keeps lives and position.
+   */
+  void set_level(const LevelData &level_data);
+
+  bool has_level() const { return game_level != nullptr; }
+
+  const GameLevel &get_level() const { return *game_level; }
+
+  void tick(float delta_time, const GameInput &input);
+
+  GameState get_state() const { return state; }
+
+  /**
+   * @brief Events of the last tick.
+   */
+  const GameEvents &get_events() const { return events; }
+
+  const Transform &get_player() const { return player; }
+
+  /**
+   * @brief The balls in play, there is always at least one.
+   */
+  const BallPool &get_balls() const { return balls; }
+
+  /**
+   * @brief Keeps at least this many balls in play while the game is
+   * running, as a stress test.
+   *
+   * Missing balls are launched from the paddle in every tick.
+   */
+  void set_min_ball_count(unsigned count) { min_ball_count = count; }
+
+  /**
+   * @brief The falling power-ups.
+   */
+  const PowerUpPool &get_power_ups() const { return power_ups; }
+
+  unsigned get_lives() const { return lives_count; }
+
+  bool is_shaking() const { return shake_time > 0.0f; }
+
+  bool is_confused() const { return confused; }
+
+  bool is_chaotic() const { return chaotic; }
+
+  unsigned get_width() const { return width; }
+
+  unsigned get_height() const { return height; }
+
+  std::uint64_t get_seed() const { return seed; }
+
+  /**
+   * @brief Hash of the whole game state, to check that a replay
+   * reproduced a game.
+   */
+  std::uint64_t get_checksum() const;
+
+private:
+  const unsigned width;
+  const unsigned height;
+
+  const std::uint64_t seed;
+
+  Random power_up_random;
+
+  GameState  state = GameState::GAME_MENU;
+  GameEvents events;
+
+  std::unique_ptr<GameLevel> game_level;
+
+  CollisionBoxes            brick_boxes;
+  std::vector<CollisionHit> brick_hits;
+
+  float shake_time = 0.0f;
+  bool  confused   = false;
+  bool  chaotic    = false;
+
+  const unsigned lives_max = 3;
+
+  unsigned lives_count = lives_max;
+
+  // Simulated seconds, power-up effects end at deadlines in it
+  double time = 0.0;
+
+  PowerUpPool    power_ups;
+  PowerUpEffects power_up_effects;
+
+  Transform player;
+
+  BallPool balls;
+
+  // Balls swept in this update, the others fly freely
+  std::vector<std::size_t> colliding_balls;
+
+  unsigned min_ball_count = 0;
+  unsigned launched_balls = 0; // by the stress test, spreads them out
+
+  void process_input(float delta_time, const GameInput &input);
+
+  void update(float delta_time);
+
+  /**
+   * @brief Moves all balls, balls far away from walls, paddle and bricks
+   * in one pass.
+   */
+  void update_balls(float delta_time);
+
+  /**
+   * @brief Moves a ball and bounces it off everything it hits on the
+   * way.
+   */
+  void update_ball(std::size_t index, float delta_time);
+
+  /**
+   * @brief Earliest contact of a ball with a wall, the paddle or a
+   * brick during a motion of its center.
+   */
+  std::optional<BallHit> find_ball_hit(const glm::vec2 center,
+                                       const glm::vec2 motion);
+
+  void resolve_ball_hit(std::size_t index, const BallHit &hit);
+
+  /**
+   * @brief Applies the brick events of the tick, once all balls moved.
+   */
+  void process_brick_events();
+
+  void bounce_off_paddle(std::size_t index);
+
+  /**
+   * @brief Removes balls that left the bottom edge, losing the last
+   * ball costs a life.
+   */
+  void update_lost_balls();
+
+  /**
+   * @brief Tops the balls up to the minimum ball count.
+   */
+  void launch_balls();
+
+  void split_ball();
+
+  bool check_collision(const Transform &transform,
+                       const glm::vec2  position,
+                       const glm::vec2  size);
+
+  void reset_level();
+
+  void reset_player();
+
+  /**
+   * @brief Drops a power-up from a destroyed brick, by chance.
+   */
+  void spawn_power_up(const glm::vec2 position);
+
+  /**
+   * @brief Moves and collects power-ups and ends expired effects.
+   */
+  void update_power_ups(float delta_time);
+
+  void activate_power_up(PowerUp::Type type);
+
+  /**
+   * @brief Undoes the effect of a type once no power-up holds it.
+   */
+  void end_power_up(PowerUp::Type type);
+};
@@ -1,65 +1,77 @@
 #pragma once
 
 #include "audio-master.hpp"
-#include "audio-source.hpp"
-#include "ball-object.hpp"
-#include "game-level.hpp"
+#include "audio-thread.hpp"
+#include "auto-pilot.hpp"
+#include "frame-time-stats.hpp"
+#include "game-simulation.hpp"
+#include "level-catalog.hpp"
+#include "music-stream.hpp"
 #include "particle-generator.hpp"
 #include "post-processor.hpp"
-#include "power-up.hpp"
+#include "replay.hpp"
+#include "resource-manager.hpp"
 #include "sprite-renderer.hpp"
 #include "text-renderer.hpp"
 #include "window.hpp"
 
-enum class GameState
-{
-  GAME_ACTIVE,
-  GAME_MENU,
-  GAME_WIN
-};
+// Simulation ticks per second
+const float DEFAULT_TICK_RATE = 120.0f;
 
-enum class Direction
-{
-  UP    = 0,
-  RIGHT = 1,
-  DOWN  = 2,
-  LEFT  = 3
-};
+// Longest frame time that is simulated, after a hitch the game slows
+// down instead of running many ticks to catch up
+const float MAX_FRAME_TIME = 0.25f;
+
+// Time per frame spent ticking while a replay fast forwards
+const double FAST_FORWARD_TIME = 0.015;
 
-class Collision
+// Seconds between two logs of the frame times
+const double FRAME_STATS_INTERVAL = 60.0;
+
+// AL sources shared by all sound effects
+const unsigned SOUND_VOICE_COUNT = 16;
+
+// Balls that leave a trail of particles, with more balls the particles
+// would replace each other before they fade
+const std::size_t TRAILED_BALL_COUNT = 8;
+
+struct GameOptions
 {
-public:
-  Collision(bool            is_collision,
-            const Direction direction,
-            const glm::vec2 difference_center_closest_point)
-      : is_collision(is_collision),
-        direction(direction),
-        difference_center_closest_point(difference_center_closest_point){};
-
-  const bool      is_collision;
-  const Direction direction;
-  const glm::vec2 difference_center_closest_point;
-};
+  float tick_rate = DEFAULT_TICK_RATE;
+
+  // A random seed is picked if none is given
+  std::optional<std::uint64_t> seed;
+
+  // Records the session into this replay file if set
+  std::string record_file;
+
+  // Plays this replay file instead of taking input if set
+  std::string replay_file;
 
-const glm::vec2 PLAYER_SIZE(100.0f, 20.0f);
+  // Plays the replay as fast as possible
+  bool fast_forward = false;
 
-const float PLAYER_VELOCITY(500.0f);
+  // Plays without a player if set
+  std::optional<AutoPilotOptions> auto_pilot;
 
-const glm::vec2 INITIAL_BALL_VELOCITY(100.0f, -350.0f);
+  // Seconds until the game quits by itself, 0 runs until it is closed
+  double run_time = 0.0;
 
-const float BALL_RADIUS = 12.5f;
+  // Keeps at least this many balls in play as a stress test if set
+  unsigned ball_count = 0;
+};
 
 /**
  * @brief Represents the game.
  *
- * Game holds all game-related state and functionality. Combines all
- * game-related data into a single class for easy access to each of
- * the components and manageability.
+ * Game is the presentation of a GameSimulation. It loads the
+ * resources, turns keys into input, runs the simulation in fixed
+ * ticks and draws and plays its state.
  */
 class Game : public Window
 {
 public:
-  Game(unsigned width, unsigned height);
+  Game(unsigned width, unsigned height, const GameOptions &options = {});
 
   ~Game();
 
@@ -68,50 +80,84 @@ public:
   void draw() override;
 
 protected:
-  GameState game_state;
-
-  void process_input(float delta_time);
+  /**
+   * @brief Advances the simulation by one fixed tick.
+   */
+  void tick();
 
-  void update(float delta_time);
+  GameInput process_input();
 
-  void render();
+  void play_sounds(const GameEvents &events);
 
-  void init();
+  void play_sound(AudioHandle sound, unsigned priority);
 
-  void update_collisions();
+  /**
+   * @param alpha Fraction of a tick passed since the last tick
+   */
+  void render(float alpha);
 
-  bool check_collision(const GameObject &one, const GameObject &two);
+  void draw_level(const GameLevel &game_level);
 
-  Collision check_collision(const BallObject &one, const GameObject &two);
+  void draw_balls(const BallPool &balls, float alpha);
 
-  void reset_level();
+  TextureHandle get_power_up_texture(PowerUp::Type type) const;
 
-  void reset_player();
+  void init();
 
-  void spawn_power_ups(GameObject &block);
+  /**
+   * @brief Loads all resources and sets up the game objects.
+   *
+   * Runs while the loading screen is shown. Reading and decoding is
+   * spread over the loader workers, GL and AL uploads are resumed on
+   * the main thread by draining the upload queue each frame.
+   */
+  Task<void> load();
 
-  void update_power_ups(float delta_time);
+  void update_loading();
 
-  bool power_up_should_spawn(unsigned chance);
+  void render_loading_screen();
 
 private:
-  std::shared_ptr<SpriteRenderer> sprite_renderer;
+  struct BrickStyle
+  {
+    TextureHandle texture;
+    glm::vec3     color;
+  };
 
-  std::vector<GameLevel> game_levels;
+  const GameOptions options;
 
-  unsigned level = 0;
+  const std::optional<Replay>   replay;
+  std::unique_ptr<ReplayPlayer> replay_player;
+  std::unique_ptr<Replay>       recording;
+  std::unique_ptr<AutoPilot>    auto_pilot;
+
+  const float tick_time;
+  float       accumulated_time = 0.0f;
+
+  GameSimulation simulation;
 
-  float shake_time = 0.0f;
+  ThreadPool  loader_workers;
+  UploadQueue upload_queue;
+  FileReader  file_reader{loader_workers};
+  Task<void>  loading;
+  bool        loaded          = false;
+  std::size_t load_count      = 0;
+  std::size_t loaded_count    = 0;
+  double      load_start_time = 0.0;
 
-  const unsigned lives_max = 3;
+  FrameTimeStats frame_stats;
+  FrameTimeStats interval_frame_stats;
+  double         next_frame_stats_time = 0.0;
 
-  unsigned lives_count = lives_max;
+  std::shared_ptr<SpriteRenderer> sprite_renderer;
+
+  LevelCatalog level_catalog{loader_workers};
 
-  std::vector<PowerUp> power_ups;
+  unsigned game_level_index = 0;
 
-  std::unique_ptr<GameObject> player;
+  unsigned level = 0;
 
-  std::unique_ptr<BallObject> ball;
+  std::vector<BrickStyle> brick_styles;
 
   std::unique_ptr<ParticleGenerator> particle_generator;
 
@@ -121,24 +167,45 @@ private:
 
   AudioMaster audio_master;
 
-  std::unique_ptr<AudioSource> audio_source_solid;
-  std::unique_ptr<AudioSource> audio_source_breakout;
-  std::unique_ptr<AudioSource> audio_source_bleep;
-  std::unique_ptr<AudioSource> audio_source_powerup;
-  std::unique_ptr<AudioSource> audio_source_nonsolid;
+  std::unique_ptr<MusicStream> music;
+
+  std::unique_ptr<AudioThread> sound_thread;
 
-  std::shared_ptr<Texture2D> texture_speed       = nullptr;
-  std::shared_ptr<Texture2D> texture_sticky      = nullptr;
-  std::shared_ptr<Texture2D> texture_passthrough = nullptr;
-  std::shared_ptr<Texture2D> texture_increase    = nullptr;
-  std::shared_ptr<Texture2D> texture_confuse     = nullptr;
-  std::shared_ptr<Texture2D> texture_chaos       = nullptr;
+  AudioHandle sound_solid;
+  AudioHandle sound_bleep;
+  AudioHandle sound_powerup;
+  AudioHandle sound_nonsolid;
 
-  void load_textures();
+  TextureHandle texture_background;
+  TextureHandle texture_face;
+  TextureHandle texture_paddle;
+  TextureHandle texture_block;
+  TextureHandle texture_block_solid;
+  TextureHandle texture_speed;
+  TextureHandle texture_sticky;
+  TextureHandle texture_passthrough;
+  TextureHandle texture_increase;
+  TextureHandle texture_confuse;
+  TextureHandle texture_chaos;
 
-  void load_shaders();
+  void load_textures(LoadContext context, std::vector<Task<void>> &loads);
 
-  void load_audio();
+  void load_shaders(LoadContext context, std::vector<Task<void>> &loads);
+
+  void load_audio(LoadContext context, std::vector<Task<void>> &loads);
+
+  /**
+   * @brief Awaits a load and counts it towards the loading progress.
+   */
+  template <typename T>
+  Task<void> track_load(Task<T> task, T *result = nullptr);
+
+  /**
+   * @brief Rasterizes the game font on a worker.
+   *
+   * @param glyphs Receives the glyphs, has to outlive the task
+   */
+  Task<void> rasterize_font(LoadContext context, std::vector<Glyph> &glyphs);
 
   void configure_audio();
 
@@ -146,22 +213,42 @@ private:
 
   void init_sprite_renderer();
 
-  void load_levels();
+  /**
+   * @brief Lists the installed levels, their content loads on selection.
+   */
+  void init_levels();
 
-  void configure_game_objects();
+  void select_level(unsigned index);
 
-  Direction calc_vector_direction(const glm::vec2 target);
+  /**
+   * @brief Replaces the shown level once the selected level is loaded.
+   *
+   * @param wait Block until the selected level is loaded
+   *
+   * @return False if the selected level is still loading or failed to
+   * load
+   */
+  bool update_game_level(bool wait);
 
-  void init_particle_generator();
+  void update_brick_styles(const LevelData &level_data);
 
-  void init_post_processor();
+  /**
+   * @brief Reports whether the replay was reproduced and hands control
+   * back to the player.
+   */
+  void finish_replay();
+
+  void write_recording();
 
-  void init_text_renderer();
+  /**
+   * @brief Counts the last frame and logs the frame times of the last
+   * interval once it passed.
+   */
+  void update_frame_stats();
 
-  void activate_power_up(PowerUp &power_up);
+  void init_particle_generator();
 
-  bool is_other_power_up_active(const std::vector<PowerUp> &power_ups,
-                                const PowerUp::Type         type) const;
+  void init_post_processor();
 
-  void update_audio();
+  void init_text_renderer(const std::vector<Glyph> &glyphs);
 };
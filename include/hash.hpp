@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+constexpr std::uint64_t FNV1A_OFFSET_BASIS = 0xcbf29ce484222325ull;
+constexpr std::uint64_t FNV1A_PRIME        = 0x100000001b3ull;
+
+/**
+ * @brief 64 bit FNV-1a hash.
+ *
+ * Used for asset names, content hashes and simulation checksums. Not
+ * cryptographic, but stable across platforms and runs, so hashes can
+ * be stored on disk.
+ *
+ * @param hash Hash of the data before, to hash data in pieces
+ */
+constexpr std::uint64_t hash_fnv1a(std::span<const unsigned char> data,
+                                   std::uint64_t hash = FNV1A_OFFSET_BASIS)
+{
+  for (const auto byte : data)
+  {
+    hash ^= byte;
+    hash *= FNV1A_PRIME;
+  }
+  return hash;
+}
+
+constexpr std::uint64_t hash_fnv1a(std::string_view data,
+                                   std::uint64_t    hash = FNV1A_OFFSET_BASIS)
+{
+  for (const auto c : data)
+  {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= FNV1A_PRIME;
+  }
+  return hash;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "level-data.hpp"
+#include "thread-pool.hpp"
+
+/**
+ * @brief Index of all installed levels that loads their content lazily.
+ *
+ * Only the level files are listed up front. The content of a level is
+ * read on the workers when the level or one of its neighbours gets
+ * selected, and levels far away from the selection are evicted once
+ * the loaded levels exceed the memory budget. A level that fails to
+ * load is logged and marked failed instead of throwing; it is loaded
+ * again once it was evicted and gets selected anew. All member
+ * functions have to be called from the same thread.
+ */
+class LevelCatalog
+{
+public:
+  static constexpr std::size_t DEFAULT_MEMORY_BUDGET = 4 * 1024 * 1024;
+
+  explicit LevelCatalog(ThreadPool &workers,
+                        std::size_t memory_budget = DEFAULT_MEMORY_BUDGET);
+
+  /**
+   * @brief Adds the built-in levels followed by all other levels found
+   * in a directory, in alphabetical order.
+   *
+   * Only lists the files, no level is read.
+   */
+  void discover(const std::vector<std::string> &built_in_files,
+                const std::string &             directory);
+
+  void add(std::string file);
+
+  std::size_t size() const { return entries.size(); }
+
+  const std::string &get_file(std::size_t index) const
+  {
+    return entries[index].file;
+  }
+
+  /**
+   * @brief Starts loading a level and its neighbours.
+   *
+   * Returns right away. Levels that are neither the selected level nor
+   * its neighbours are evicted while the memory budget is exceeded.
+   */
+  void select(std::size_t index);
+
+  /**
+   * @brief Returns a level if it finished loading.
+   *
+   * @return The level or nullptr if it is not loaded yet or failed
+   */
+  std::shared_ptr<const LevelData> try_get(std::size_t index);
+
+  /**
+   * @brief Returns a level, waiting for it to load if necessary.
+   *
+   * @return The level or nullptr if it failed to load
+   */
+  std::shared_ptr<const LevelData> get(std::size_t index);
+
+  /**
+   * @brief Whether a level finished loading without a result.
+   */
+  bool has_failed(std::size_t index) const;
+
+  /**
+   * @brief Memory held by loaded levels in bytes.
+   */
+  std::size_t get_memory_usage() const;
+
+private:
+  using LevelFuture = std::shared_future<std::shared_ptr<const LevelData>>;
+
+  struct Entry
+  {
+    std::string file;
+    LevelFuture data;
+  };
+
+  ThreadPool &             workers;
+  std::size_t              memory_budget;
+  std::vector<Entry>       entries;
+  std::vector<std::size_t> resident_entries;
+
+  void prefetch(std::size_t index);
+
+  void evict(std::size_t selected);
+
+  std::size_t get_distance(std::size_t index, std::size_t selected) const;
+
+  static bool is_ready(const LevelFuture &data);
+
+  static bool is_failed(const LevelFuture &data);
+
+  static std::size_t get_memory_size(const LevelFuture &data);
+};
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief On disk header of a binary level.
+ *
+ * The header is followed by palette_size LevelFileBrickType records and
+ * tile_data_size bytes of tile codes, one byte per tile in row-major
+ * order. If the RLE flag is set, the tiles are stored as pairs of run
+ * length and tile code. All values are little endian.
+ */
+struct LevelFileHeader
+{
+  char          magic[4];
+  std::uint16_t version;
+  std::uint16_t flags;
+  std::uint32_t rows;
+  std::uint32_t columns;
+  std::uint32_t palette_size;
+  std::uint32_t tile_data_size;
+};
+
+struct LevelFileBrickType
+{
+  std::uint8_t flags;
+  std::uint8_t padding[3];
+  float        color[3];
+};
+
+static_assert(sizeof(LevelFileHeader) == 24);
+static_assert(sizeof(LevelFileBrickType) == 16);
+
+constexpr char          LEVEL_FILE_MAGIC[4]      = {'B', 'T', 'L', 'V'};
+constexpr std::uint16_t LEVEL_FILE_VERSION       = 1;
+constexpr std::uint16_t LEVEL_FILE_RLE           = 1;
+constexpr std::uint8_t  LEVEL_FILE_SOLID         = 1;
+constexpr char          LEVEL_BINARY_EXTENSION[] = ".btlv";
+
+/**
+ * @brief How the bricks of a tile code look and behave.
+ */
+struct BrickType
+{
+  bool  is_solid = false;
+  float color[3] = {1.0f, 1.0f, 1.0f};
+};
+
+/**
+ * @brief The tiles of a level as a flat grid plus its palette.
+ *
+ * Tile code 0 is an empty tile, every other code indexes the palette.
+ * Levels are stored either as text, with whitespace separated tile
+ * codes and one row per line, or in the binary format.
+ */
+class LevelData
+{
+public:
+  static constexpr std::uint8_t EMPTY_TILE = 0;
+
+  LevelData() = default;
+
+  /**
+   * @throws std::runtime_error if the tiles do not fill the grid or use
+   * codes outside of the palette
+   */
+  LevelData(unsigned                  rows,
+            unsigned                  columns,
+            std::vector<std::uint8_t> tiles,
+            std::vector<BrickType>    palette = default_palette());
+
+  unsigned get_rows() const { return rows; }
+
+  unsigned get_columns() const { return columns; }
+
+  bool is_empty() const { return tiles.empty(); }
+
+  std::uint8_t get_tile(unsigned row, unsigned column) const
+  {
+    return tiles[std::size_t(row) * columns + column];
+  }
+
+  const std::vector<std::uint8_t> &get_tiles() const { return tiles; }
+
+  const std::vector<BrickType> &get_palette() const { return palette; }
+
+  const BrickType &get_brick_type(std::uint8_t tile) const
+  {
+    return palette[tile];
+  }
+
+  /**
+   * @brief The brick types of the original text levels.
+   */
+  static const std::vector<BrickType> &default_palette();
+
+  /**
+   * @brief The default palette grown to cover every tile code in use.
+   *
+   * Tile codes beyond the default palette become white breakable
+   * bricks, as they always did in text levels.
+   */
+  static std::vector<BrickType>
+  default_palette_for(std::span<const std::uint8_t> tiles);
+
+  /**
+   * @brief Parses a level in the text format.
+   *
+   * Tile codes beyond the default palette become white breakable
+   * bricks, as they always did.
+   *
+   * @throws std::runtime_error if the level is empty, contains rows of
+   * different length or anything but tile codes
+   */
+  static LevelData parse_text(std::string_view content);
+
+  /**
+   * @brief Reads a level in the binary format.
+   *
+   * @throws std::runtime_error if the data is not a valid binary level
+   */
+  static LevelData read_binary(std::span<const unsigned char> data);
+
+  /**
+   * @brief Reads a level in either format.
+   */
+  static LevelData load(std::span<const unsigned char> data);
+
+  static bool is_binary(std::span<const unsigned char> data);
+
+  /**
+   * @brief Serializes the level in the binary format.
+   *
+   * @param compress Run length encode the tiles if that makes them
+   * smaller
+   */
+  std::vector<unsigned char> to_binary(bool compress) const;
+
+  void write_binary(const std::string &file, bool compress) const;
+
+private:
+  unsigned                  rows    = 0;
+  unsigned                  columns = 0;
+  std::vector<std::uint8_t> tiles;
+  std::vector<BrickType>    palette;
+};
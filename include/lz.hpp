@@ -0,0 +1,27 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+/**
+ * @brief Fast LZ77 style block compression.
+ *
+ * The block format follows LZ4: a sequence is a token byte holding the
+ * literal and match length, the literals, a 16 bit little endian
+ * offset and optional length extension bytes. The last sequence only
+ * holds literals. Compression ratio is modest, but decompression is a
+ * plain byte copy loop.
+ */
+std::vector<unsigned char> lz_compress(std::span<const unsigned char> source);
+
+/**
+ * @brief Decompresses a block created by lz_compress().
+ *
+ * @param source Compressed block
+ * @param destination Buffer of exactly the uncompressed size
+ *
+ * @throws std::runtime_error if the block is corrupt or does not
+ * decompress to exactly the size of the destination
+ */
+void lz_decompress(std::span<const unsigned char> source,
+                   std::span<unsigned char>       destination);
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+
+/**
+ * @brief Read only memory mapping of a whole file.
+ *
+ * The mapping stays valid as long as the MappedFile lives. Pages are
+ * loaded lazily by the kernel, so mapping a large file is cheap.
+ */
+class MappedFile
+{
+public:
+  /**
+   * @brief Maps a file into memory.
+   *
+   * @param file Path of the file to map
+   *
+   * @throws std::runtime_error if the file can not be opened or mapped
+   */
+  explicit MappedFile(const std::string &file);
+
+  ~MappedFile();
+
+  std::span<const unsigned char> data() const
+  {
+    return {static_cast<const unsigned char *>(address), size};
+  }
+
+  std::size_t get_size() const { return size; }
+
+private:
+  void *      address = nullptr;
+  std::size_t size    = 0;
+
+  MappedFile(MappedFile &)  = delete;
+  MappedFile(MappedFile &&) = delete;
+};
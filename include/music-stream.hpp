@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "asset-store.hpp"
+#include "open-al.hpp"
+#include "wav-loader.hpp"
+
+/**
+ * @brief Plays a music track in a loop without loading it into memory.
+ *
+ * A thread of its own reads the track in chunks into a small ring of
+ * AL buffers queued on one source. Played buffers are refilled with the
+ * next chunk and queued again, and the end of the track continues with
+ * its start in the same buffer, so the loop has no gap. The track is
+ * read from its memory mapping, which asset packs keep uncompressed for
+ * streamed assets (see AssetStore::is_streamed()), so memory stays at
+ * BUFFER_COUNT chunks plus the pages the kernel keeps however long the
+ * track is. The game does not have to look after the music once it
+ * started.
+ */
+class MusicStream
+{
+public:
+  static constexpr std::size_t BUFFER_COUNT = 4;
+
+  // Seconds of music per buffer
+  static constexpr double BUFFER_TIME = 0.25;
+
+  // Time between two checks for played buffers
+  static constexpr auto POLL_INTERVAL = std::chrono::milliseconds(50);
+
+  /**
+   * @brief Starts playing a wav file.
+   *
+   * @throws std::runtime_error if the file is missing or not a
+   * supported wav file
+   */
+  explicit MusicStream(const std::string &file);
+
+  ~MusicStream();
+
+  MusicStream(const MusicStream &) = delete;
+
+  MusicStream &operator=(const MusicStream &) = delete;
+
+private:
+  const Asset   asset;
+  const WavView wav;
+  ALenum        format;
+
+  std::size_t                chunk_size    = 0;
+  std::size_t                read_position = 0;
+  std::vector<unsigned char> chunk;
+
+  ALuint                             source = 0;
+  std::array<ALuint, BUFFER_COUNT> buffers{};
+
+  std::mutex              mutex;
+  std::condition_variable stop_condition;
+  bool                    stopping = false;
+  std::thread             thread;
+
+  void run();
+
+  /**
+   * @brief Fills a buffer with the next chunk of the track.
+   */
+  void fill(ALuint buffer);
+};
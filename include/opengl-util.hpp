@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <string_view>
 
 #include <glad/glad.h>
 
@@ -14,3 +15,8 @@ void gl_clear_error();
 void gl_check_error(const char *             function,
                     const char *             file,
                     const std::uint_fast32_t line);
+
+/**
+ * @brief Checks whether the current context supports an extension.
+ */
+bool gl_has_extension(std::string_view name);
@@ -1,10 +1,13 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
-#include "game-object.hpp"
-#include "shader.hpp"
-#include "texture.hpp"
+#include <glm/glm.hpp>
+
+#include "random.hpp"
+#include "renderer.hpp"
+#include "resource-registry.hpp"
 
 /**
  * @brief Represents a single particle and it's state.
@@ -27,20 +30,31 @@ struct Particle
 class ParticleGenerator
 {
 public:
-  ParticleGenerator(const std::shared_ptr<Shader>    shader,
-                    const std::shared_ptr<Texture2D> texture,
-                    unsigned                         amount,
-                    const std::shared_ptr<Renderer>  renderer);
+  /**
+   * @param seed Seeds the scatter of the particles
+   */
+  ParticleGenerator(const ShaderHandle              shader,
+                    const TextureHandle             texture,
+                    unsigned                        amount,
+                    const std::shared_ptr<Renderer> renderer,
+                    std::uint64_t                   seed);
+
+  /**
+   * @brief Spawns particles at a position, replacing the oldest ones
+   *
+   * @param velocity Of the emitting object
+   */
+  void spawn(const glm::vec2 &position,
+             const glm::vec2 &velocity,
+             const unsigned   new_particles,
+             const glm::vec2 &offset = glm::vec2(0.0f, 0.0f));
 
   /**
    * @brief Update all particles
    *
    * @param delta_time Delta time
    */
-  void update(const float       delta_time,
-              const GameObject &object,
-              const unsigned    new_particles,
-              const glm::vec2 & offset = glm::vec2(0.0f, 0.0f));
+  void update(const float delta_time);
 
   /**
    * @brief Render all particles
@@ -52,25 +66,23 @@ private:
 
   std::vector<Particle> particles;
   const unsigned        amount;
+  Random                random;
 
   // Render state
 
-  const std::shared_ptr<Renderer>  renderer;
-  const std::shared_ptr<Shader>    shader;
-  const std::shared_ptr<Texture2D> texture;
-  VertexArray                      vertex_array;
-  unsigned                         last_used_particle = 0;
+  const std::shared_ptr<Renderer> renderer;
+  const ShaderHandle              shader;
+  const TextureHandle             texture;
+  VertexArray                     vertex_array;
 
-  void init();
+  // All particles live equally long, so the next one in the ring is
+  // the oldest
+  unsigned next_particle = 0;
 
-  /**
-   * @brief Returns first unused particle index.
-   *
-   * @return Index of first unused particle or 0 if no unused particle
-   */
-  unsigned first_unused_particle();
+  void init();
 
-  void respawn_particle(Particle &        particle,
-                        const GameObject &object,
-                        const glm::vec2 & offset = glm::vec2(0.0f, 0.0f));
+  void respawn_particle(Particle &       particle,
+                        const glm::vec2 &position,
+                        const glm::vec2 &velocity,
+                        const glm::vec2 &offset);
 };
@@ -5,6 +5,7 @@
 #include "framebuffer.hpp"
 #include "renderbuffer.hpp"
 #include "renderer.hpp"
+#include "resource-registry.hpp"
 #include "shader.hpp"
 #include "texture.hpp"
 #include "vertex-array.hpp"
@@ -24,7 +25,7 @@ class PostProcessor
 {
 public:
   PostProcessor(const std::shared_ptr<Renderer> renderer,
-                const std::shared_ptr<Shader>   shader,
+                const ShaderHandle              shader,
                 unsigned                        width,
                 unsigned                        height);
   /**
@@ -64,8 +65,8 @@ private:
 
   bool confuse = false, chaos = false, shake = false;
 
-  std::shared_ptr<Shader>    post_processing_shader = nullptr;
-  std::shared_ptr<Texture2D> texture                = nullptr;
+  const ShaderHandle         post_processing_shader;
+  std::shared_ptr<Texture2D> texture = nullptr;
   unsigned                   width = 0, height = 0;
 
   void init_render_data();
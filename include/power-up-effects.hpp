@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <functional>
+#include <queue>
+#include <vector>
+
+#include "power-up.hpp"
+
+/**
+ * @brief The effects of collected power-ups that last for a while.
+ *
+ * Every collected power-up holds a reference on the effect of its
+ * type until its deadline, the effect ends with the last reference.
+ * Deadlines are kept in a min-heap, so a tick only looks at the
+ * effects that end in it.
+ */
+class PowerUpEffects
+{
+public:
+  /**
+   * @brief Holds the effect of a type until the given time.
+   */
+  void add(PowerUp::Type type, double deadline);
+
+  /**
+   * @brief Drops the references that end at the given time.
+   *
+   * @param on_end Called with each type whose last reference ended
+   */
+  void expire(double time, const std::function<void(PowerUp::Type)> &on_end);
+
+  bool is_active(PowerUp::Type type) const
+  {
+    return counts[static_cast<std::size_t>(type)] > 0;
+  }
+
+  unsigned get_count(PowerUp::Type type) const
+  {
+    return counts[static_cast<std::size_t>(type)];
+  }
+
+  /**
+   * @brief Ends all effects without reporting them.
+   */
+  void clear();
+
+private:
+  struct Deadline
+  {
+    double        time;
+    PowerUp::Type type;
+
+    bool operator>(const Deadline &other) const { return time > other.time; }
+  };
+
+  std::array<unsigned, POWER_UP_TYPE_COUNT> counts{};
+
+  std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>>
+      deadlines;
+};
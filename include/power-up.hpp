@@ -1,45 +1,97 @@
-#include "game-object.hpp"
+#pragma once
 
-const glm::vec2 SIZE(60.0f, 20.0f);
-const glm::vec2 VELOCITY(0.0f, 150.0f);
+#include <array>
+#include <cstdint>
 
-class PowerUp : public GameObject
+#include <glm/glm.hpp>
+
+const glm::vec2 POWER_UP_SIZE(60.0f, 20.0f);
+const glm::vec2 POWER_UP_VELOCITY(0.0f, 150.0f);
+
+/**
+ * @brief A power-up falling down from a destroyed brick.
+ *
+ * Plain data, size and velocity are the same for all power-ups.
+ */
+struct PowerUp
 {
-public:
-  enum class Type
+  enum class Type : std::uint8_t
   {
     SPEED,
     STICKY,
     PASS_THROUGH,
     PAD_SIZE_INCREASE,
     CONFUSE,
-    CHAOS
+    CHAOS,
+    MULTI_BALL
   };
 
-  PowerUp(Type                       type,
-          glm::vec3                  color,
-          float                      duration,
-          glm::vec2                  position,
-          std::shared_ptr<Texture2D> texture)
-      : GameObject(position, SIZE, texture, false, color, VELOCITY),
-        type(type),
-        duration(duration),
-        activated(true)
+  Type      type;
+  glm::vec2 position;
+  glm::vec2 previous_position; // of the last tick
+
+  /**
+   * @brief Position between the last two ticks.
+   *
+   * @param alpha 0 returns the previous position, 1 the current one
+   */
+  glm::vec2 get_interpolated_position(float alpha) const
   {
+    return glm::mix(previous_position, position, alpha);
   }
+};
 
-  void set_activated(bool value) { activated = value; }
+const std::size_t POWER_UP_TYPE_COUNT = 7;
 
-  void set_duration(float value) { duration = value; }
+// Spawn chances are out of this many destroyed bricks
+const unsigned POWER_UP_SPAWN_RANGE = 75;
 
-  bool is_activated() const { return activated; }
+/**
+ * @brief What all power-ups of a type share.
+ */
+struct PowerUpKind
+{
+  glm::vec3 color;
+  float     duration; // of the effect in seconds, 0 for instant effects
+  unsigned  spawn_chance;
+};
+
+const PowerUpKind &get_power_up_kind(PowerUp::Type type);
+
+/**
+ * @brief The falling power-ups in a fixed amount of memory.
+ *
+ * Removing a power-up moves the last one into its slot, so the live
+ * power-ups are always the first ones.
+ */
+class PowerUpPool
+{
+public:
+  static constexpr std::size_t CAPACITY = 128;
+
+  /**
+   * @return False if the pool is full and the power-up was dropped
+   */
+  bool add(PowerUp::Type type, glm::vec2 position);
+
+  void remove(std::size_t index);
+
+  void clear() { count = 0; }
+
+  std::size_t size() const { return count; }
+
+  PowerUp &operator[](std::size_t index) { return power_ups[index]; }
+
+  const PowerUp &operator[](std::size_t index) const
+  {
+    return power_ups[index];
+  }
 
-  float get_duration() const { return duration; }
+  const PowerUp *begin() const { return power_ups.data(); }
 
-  Type get_type() const { return type; }
+  const PowerUp *end() const { return power_ups.data() + count; }
 
 private:
-  Type  type;
-  float duration  = 0.0f;
-  bool  activated = true;
+  std::array<PowerUp, CAPACITY> power_ups;
+  std::size_t                   count = 0;
 };
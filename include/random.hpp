@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+
+/**
+ * @brief Independent random sequences of one seed.
+ *
+ * Every subsystem draws from its own stream, so drawing more particles
+ * does not change which power-ups spawn.
+ */
+enum class RandomStream : std::uint64_t
+{
+  POWER_UPS  = 1,
+  PARTICLES  = 2,
+  AUTO_PILOT = 3
+};
+
+/**
+ * @brief Seeded pseudo random number generator (PCG32).
+ *
+ * The same seed and stream always produce the same numbers on every
+ * platform, which makes sessions reproducible.
+ */
+class Random
+{
+public:
+  Random(std::uint64_t seed, RandomStream stream)
+      : increment((static_cast<std::uint64_t>(stream) << 1u) | 1u)
+  {
+    next();
+    state += seed;
+    next();
+  }
+
+  std::uint32_t next()
+  {
+    const auto old_state = state;
+    state = old_state * 6364136223846793005ULL + increment;
+
+    const auto xorshifted =
+        static_cast<std::uint32_t>(((old_state >> 18u) ^ old_state) >> 27u);
+    const auto rotation = static_cast<std::uint32_t>(old_state >> 59u);
+    return (xorshifted >> rotation) | (xorshifted << ((-rotation) & 31u));
+  }
+
+  /**
+   * @brief Uniform number in [0, bound), bound has to be positive.
+   */
+  std::uint32_t next_below(std::uint32_t bound)
+  {
+    // Rejects the few values that would make low numbers more likely
+    const auto threshold = (0u - bound) % bound;
+    while (true)
+    {
+      const auto value = next();
+      if (value >= threshold)
+        return value % bound;
+    }
+  }
+
+  /**
+   * @brief Uniform number in [0, 1).
+   */
+  float next_float() { return (next() >> 8u) * (1.0f / 16777216.0f); }
+
+  /**
+   * @brief A seed for sessions that do not need to be reproduced.
+   */
+  static std::uint64_t make_seed()
+  {
+    std::random_device device;
+    return (static_cast<std::uint64_t>(device()) << 32u) | device();
+  }
+
+private:
+  std::uint64_t state = 0;
+  std::uint64_t increment;
+};
@@ -26,6 +26,16 @@ public:
                     const std::size_t width,
                     const std::size_t height) const;
 
+  /**
+   * @brief Restricts clearing and drawing to a rectangle.
+   */
+  void set_scissor(const int         x,
+                   const int         y,
+                   const std::size_t width,
+                   const std::size_t height) const;
+
+  void disable_scissor() const;
+
   void init(GLADloadproc loadProc);
 
   void blit_framebuffer(int        srcx0,
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "game-simulation.hpp"
+#include "level-data.hpp"
+
+/**
+ * @brief On disk header of a replay.
+ *
+ * The header is followed by level_count levels, each a ReplayFileLevel
+ * and its binary level, and input_run_count ReplayFileInputRun records.
+ * All values are little endian.
+ */
+struct ReplayFileHeader
+{
+  char          magic[4];
+  std::uint16_t version;
+  std::uint16_t flags;
+  std::uint64_t seed;
+  std::uint64_t checksum;
+  std::uint32_t width;
+  std::uint32_t height;
+  float         tick_time;
+  std::uint32_t tick_count;
+  std::uint32_t level_count;
+  std::uint32_t input_run_count;
+};
+
+struct ReplayFileLevel
+{
+  std::uint32_t tick; // the level is set before this tick
+  std::uint32_t size;
+};
+
+/**
+ * @brief Ticks in a row with the same input.
+ */
+struct ReplayFileInputRun
+{
+  std::uint8_t  input; // GameInput packed into bits
+  std::uint8_t  padding;
+  std::uint16_t length;
+};
+
+static_assert(sizeof(ReplayFileHeader) == 48);
+static_assert(sizeof(ReplayFileLevel) == 8);
+static_assert(sizeof(ReplayFileInputRun) == 4);
+
+constexpr char          REPLAY_FILE_MAGIC[4] = {'B', 'T', 'R', 'P'};
+constexpr std::uint16_t REPLAY_FILE_VERSION  = 1;
+
+/**
+ * @brief The seed, levels and per tick input of a game.
+ *
+ * The simulation only depends on these, so playing them back into a
+ * simulation with the same seed reproduces the game exactly. Input is
+ * stored as runs of equal ticks, which keeps replays of long sessions
+ * small.
+ */
+class Replay
+{
+public:
+  Replay() = default;
+
+  Replay(unsigned width, unsigned height, float tick_time, std::uint64_t seed);
+
+  /**
+   * @brief Records a level that is set before the next tick.
+   */
+  void add_level(const LevelData &level_data);
+
+  void add_tick(const GameInput &input);
+
+  /**
+   * @brief Stores the state after the last tick to verify playback.
+   */
+  void set_checksum(std::uint64_t value) { checksum = value; }
+
+  unsigned get_width() const { return width; }
+
+  unsigned get_height() const { return height; }
+
+  float get_tick_time() const { return tick_time; }
+
+  std::uint64_t get_seed() const { return seed; }
+
+  std::uint64_t get_checksum() const { return checksum; }
+
+  std::uint32_t get_tick_count() const { return tick_count; }
+
+  /**
+   * @brief Reads a replay.
+   *
+   * @throws std::runtime_error if the data is not a valid replay
+   */
+  static Replay read(std::span<const unsigned char> data);
+
+  /**
+   * @throws std::runtime_error if the file could not be read or is not
+   * a valid replay
+   */
+  static Replay load(const std::string &file);
+
+  std::vector<unsigned char> to_binary() const;
+
+  void write(const std::string &file) const;
+
+private:
+  struct LevelChange
+  {
+    std::uint32_t tick;
+    LevelData     level_data;
+  };
+
+  struct InputRun
+  {
+    std::uint8_t  input;
+    std::uint32_t length;
+  };
+
+  unsigned      width      = 0;
+  unsigned      height     = 0;
+  float         tick_time  = 0.0f;
+  std::uint64_t seed       = 0;
+  std::uint64_t checksum   = 0;
+  std::uint32_t tick_count = 0;
+
+  std::vector<LevelChange> levels;
+  std::vector<InputRun>    input_runs;
+
+  friend class ReplayPlayer;
+};
+
+/**
+ * @brief Feeds a replay into a simulation tick by tick.
+ */
+class ReplayPlayer
+{
+public:
+  /**
+   * @param replay Has to outlive the player
+   */
+  explicit ReplayPlayer(const Replay &replay);
+
+  bool is_done() const { return tick == replay.get_tick_count(); }
+
+  std::uint32_t get_tick() const { return tick; }
+
+  /**
+   * @brief Sets the levels recorded for the next tick and runs it with
+   * the recorded input.
+   *
+   * @return true if a level was set
+   */
+  bool tick_simulation(GameSimulation &simulation);
+
+private:
+  const Replay &replay;
+  std::uint32_t tick        = 0;
+  std::size_t   level_index = 0;
+  std::size_t   run_index   = 0;
+  std::uint32_t run_tick    = 0; // ticks played of the current run
+};
@@ -1,62 +1,211 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
 
 #include <glad/glad.h>
 
+#include "asset-store.hpp"
 #include "audio-buffer.hpp"
+#include "file-reader.hpp"
+#include "resource-registry.hpp"
 #include "shader.hpp"
+#include "task.hpp"
 #include "texture.hpp"
+#include "thread-pool.hpp"
+#include "upload-queue.hpp"
+#include "wav-loader.hpp"
+
+/**
+ * @brief Where the stages of an asynchronous load run.
+ *
+ * Loose files are read in batches by the file reader, decoding happens
+ * on the workers and creating GL and AL objects on the thread draining
+ * the upload queue.
+ */
+struct LoadContext
+{
+  ThreadPool & workers;
+  UploadQueue &uploads;
+  FileReader & files;
+};
 
+/**
+ * @brief Loads and owns all shared resources of the game.
+ *
+ * Resources are loaded once by name and afterwards addressed through
+ * typed handles. Names are only meant for the loading phase, hot paths
+ * should keep the handle around and resolve it with get_*(). Loading a
+ * resource of any type under a name in use replaces the old resource,
+ * so its handles become stale.
+ */
 class ResourceManager
 {
 public:
-  static std::shared_ptr<Shader>
-  load_shader(const std::string &vertex_shader_file,
-              const std::string &fragment_shader_file,
-              const std::string &geometry_shader_file,
-              const std::string &name);
-
-  static std::shared_ptr<Shader>
-  load_shader(const std::string &vertex_shader_file,
-              const std::string &fragment_shader_file,
-              const std::string &name);
-
-  static std::shared_ptr<Shader> get_shader(const std::string &name);
-
-  static std::shared_ptr<Texture2D> load_texture(const std::string &file,
-                                                 const bool         alpha,
-                                                 const std::string &name);
-
-  static std::shared_ptr<Texture2D> get_texture(const std::string &name);
-
-  static std::shared_ptr<AudioBuffer> load_audio(const std::string &audio_file,
-                                                 const std::string &name);
-
-  static std::shared_ptr<AudioBuffer> get_audio(const std::string &name);
+  static ShaderHandle load_shader(const std::string &vertex_shader_file,
+                                  const std::string &fragment_shader_file,
+                                  const std::string &geometry_shader_file,
+                                  const std::string &name);
+
+  static ShaderHandle load_shader(const std::string &vertex_shader_file,
+                                  const std::string &fragment_shader_file,
+                                  const std::string &name);
+
+  static ShaderHandle find_shader(const std::string &name);
+
+  static Shader &get_shader(ShaderHandle handle)
+  {
+    return shaders.get(handle);
+  }
+
+  static TextureHandle load_texture(const std::string &file,
+                                    const bool         alpha,
+                                    const std::string &name);
+
+  static TextureHandle find_texture(const std::string &name);
+
+  static Texture2D &get_texture(TextureHandle handle)
+  {
+    return textures.get(handle);
+  }
+
+  static AudioHandle load_audio(const std::string &audio_file,
+                                const std::string &name);
+
+  static AudioHandle find_audio(const std::string &name);
+
+  static AudioBuffer &get_audio(AudioHandle handle)
+  {
+    return audio_buffers.get(handle);
+  }
+
+  /**
+   * @brief Loads a shader without blocking the calling thread.
+   *
+   * The async loaders have to be started on the thread that owns the
+   * GL and AL contexts and finish on the thread draining the upload
+   * queue, which has to be the same thread.
+   */
+  static Task<ShaderHandle> load_shader_async(LoadContext context,
+                                              std::string vertex_shader_file,
+                                              std::string fragment_shader_file,
+                                              std::string name);
+
+  static Task<TextureHandle> load_texture_async(LoadContext context,
+                                                std::string file,
+                                                bool        alpha,
+                                                std::string name);
+
+  static Task<AudioHandle> load_audio_async(LoadContext context,
+                                            std::string audio_file,
+                                            std::string name);
 
   static void clear();
 
 private:
-  static const std::string resources_directory;
-
-  static std::unordered_map<std::string, std::shared_ptr<Shader>>    shaders;
-  static std::unordered_map<std::string, std::shared_ptr<Texture2D>> textures;
-  static std::unordered_map<std::string, std::shared_ptr<AudioBuffer>>
-      audio_buffers;
+  struct ShaderSources
+  {
+    Asset                vertex_shader;
+    Asset                fragment_shader;
+    std::optional<Asset> geometry_shader;
+  };
+
+  /**
+   * @brief A texture ready for upload, either cooked or decoded pixels.
+   */
+  struct TextureData
+  {
+    std::optional<Asset>         cooked_asset;
+    std::optional<CookedTexture> cooked;
+
+    int                                            width  = 0;
+    int                                            height = 0;
+    std::unique_ptr<unsigned char, void (*)(void *)> pixels{nullptr, nullptr};
+  };
+
+  static ResourceRegistry<Shader>      shaders;
+  static ResourceRegistry<Texture2D>   textures;
+  static ResourceRegistry<AudioBuffer> audio_buffers;
+
+  static std::unordered_map<std::string, ShaderHandle>  shader_names;
+  static std::unordered_map<std::string, TextureHandle> texture_names;
+  static std::unordered_map<std::string, AudioHandle>   audio_names;
 
   ResourceManager()                   = delete;
   ~ResourceManager()                  = delete;
   ResourceManager(ResourceManager &)  = delete;
   ResourceManager(ResourceManager &&) = delete;
 
-  static std::shared_ptr<Shader>
+  static std::unique_ptr<Shader>
   load_shader_from_file(const std::string &vertex_shader_file,
                         const std::string &fragment_shader_file,
                         const std::string &geometry_shader_file = "");
 
-  static std::shared_ptr<Texture2D>
+  static ShaderSources
+  read_shader_sources(const std::string &vertex_shader_file,
+                      const std::string &fragment_shader_file,
+                      const std::string &geometry_shader_file = "");
+
+  static std::unique_ptr<Shader> create_shader(const ShaderSources &sources);
+
+  static std::unique_ptr<Texture2D>
   load_texture_from_file(const std::string &file, const bool alpha);
+
+  /**
+   * @brief Reads a texture, preferring its cooked version.
+   *
+   * Does not touch GL, so it can run on any thread.
+   *
+   * @param use_compressed Whether S3TC cooked textures can be uploaded
+   */
+  static TextureData decode_texture(const std::string &file,
+                                    const bool         use_compressed);
+
+  /**
+   * @brief Takes over a cooked texture unless it can not be used.
+   *
+   * Returns nothing if the cooked texture is stale or compressed while
+   * S3TC is not supported, the source texture has to be decoded then.
+   */
+  static std::optional<TextureData>
+  decode_cooked_texture(const std::string &file,
+                        Asset              cooked_asset,
+                        const bool         use_compressed);
+
+  static TextureData decode_source_texture(const std::string &file,
+                                           const Asset &      asset);
+
+  static std::unique_ptr<Texture2D> create_texture(const TextureData &data,
+                                                   const bool         alpha);
+
+  static bool supports_compressed_textures();
+
+  static std::unique_ptr<AudioBuffer>
+  create_audio_buffer(const WavView &wav);
+
+  static Task<void> read_into(Task<Asset> read, std::optional<Asset> &asset);
+
+  /**
+   * @brief Inserts a resource under a name.
+   *
+   * A resource that was previously registered under the same name is
+   * released, so handles to it become stale.
+   */
+  template <typename T>
+  static ResourceHandle<T>
+  insert(ResourceRegistry<T> &                               registry,
+         std::unordered_map<std::string, ResourceHandle<T>> &names,
+         const std::string &                                 name,
+         std::unique_ptr<T>                                  resource)
+  {
+    const auto it = names.find(name);
+    if (it != names.end())
+      registry.remove(it->second);
+
+    const auto handle = registry.insert(std::move(resource));
+    names[name]       = handle;
+    return handle;
+  }
 };
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "asseration.hpp"
+
+/**
+ * @brief Typed, generational handle to a resource.
+ *
+ * A handle is an index into the dense storage of a ResourceRegistry
+ * plus the generation of the slot at the time the resource was
+ * inserted. Once the resource is removed the slot generation changes
+ * and all outstanding handles to it become stale. A default
+ * constructed handle is invalid.
+ */
+template <typename T>
+struct ResourceHandle
+{
+  std::uint32_t index      = 0;
+  std::uint32_t generation = 0;
+
+  bool is_valid() const { return generation != 0; }
+
+  bool operator==(const ResourceHandle &other) const = default;
+};
+
+class AudioBuffer;
+class Shader;
+class Texture2D;
+
+using AudioHandle   = ResourceHandle<AudioBuffer>;
+using ShaderHandle  = ResourceHandle<Shader>;
+using TextureHandle = ResourceHandle<Texture2D>;
+
+/**
+ * @brief Dense storage for resources of one type.
+ *
+ * Resources are kept in a contiguous array of slots and addressed by
+ * ResourceHandle. Lookup is a plain array access without any hashing
+ * or reference counting. Handles are validated in debug builds only.
+ */
+template <typename T>
+class ResourceRegistry
+{
+public:
+  ResourceHandle<T> insert(std::unique_ptr<T> resource)
+  {
+    std::uint32_t index;
+    if (!free_slots.empty())
+    {
+      index = free_slots.back();
+      free_slots.pop_back();
+    }
+    else
+    {
+      index = static_cast<std::uint32_t>(resources.size());
+      resources.emplace_back();
+      // Generation 0 is reserved for invalid handles
+      generations.push_back(1);
+    }
+
+    resources[index] = std::move(resource);
+
+    return ResourceHandle<T>{index, generations[index]};
+  }
+
+  T &get(ResourceHandle<T> handle) const
+  {
+#ifndef NDEBUG
+    ASSERT(contains(handle));
+#endif
+    return *resources[handle.index];
+  }
+
+  bool contains(ResourceHandle<T> handle) const
+  {
+    return handle.is_valid() && handle.index < resources.size() &&
+           generations[handle.index] == handle.generation &&
+           resources[handle.index] != nullptr;
+  }
+
+  void remove(ResourceHandle<T> handle)
+  {
+    if (!contains(handle))
+      return;
+
+    release(handle.index);
+  }
+
+  void clear()
+  {
+    for (std::uint32_t i = 0; i < resources.size(); ++i)
+      if (resources[i])
+        release(i);
+  }
+
+private:
+  std::vector<std::unique_ptr<T>> resources;
+  std::vector<std::uint32_t>      generations;
+  std::vector<std::uint32_t>      free_slots;
+
+  void release(std::uint32_t index)
+  {
+    resources[index].reset();
+
+    // Skip the reserved invalid generation on wrap around
+    if (++generations[index] == 0)
+      generations[index] = 1;
+
+    free_slots.push_back(index);
+  }
+};
@@ -2,6 +2,7 @@
 
 #include <array>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 
 #include <glad/glad.h>
@@ -22,13 +23,13 @@ public:
   /**
    * Creates a new Shader
    *
-   * @param vertexShaderProgram Path to vertex shader
-   * @param fragmentShaderProgram Path to fragment shader
-   * @param geometryShaderProgram Path to geometry shader. This is optional
+   * @param vertexShaderProgram Source of vertex shader
+   * @param fragmentShaderProgram Source of fragment shader
+   * @param geometryShaderProgram Source of geometry shader. This is optional
    */
-  Shader(const std::string &vertexShaderProgram,
-         const std::string &fragmentShaderProgram,
-         const std::string &geometryShaderProgram = "");
+  Shader(std::string_view vertexShaderProgram,
+         std::string_view fragmentShaderProgram,
+         std::string_view geometryShaderProgram = {});
 
   /**
    * Get the id of the shader
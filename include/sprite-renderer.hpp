@@ -3,6 +3,7 @@
 #include <memory>
 
 #include "renderer.hpp"
+#include "resource-registry.hpp"
 #include "shader.hpp"
 #include "texture.hpp"
 #include "vertex-array.hpp"
@@ -11,17 +12,23 @@ class SpriteRenderer
 {
 public:
   SpriteRenderer(const std::shared_ptr<Renderer> renderer,
-                 const std::shared_ptr<Shader>   shader);
+                 const ShaderHandle              shader);
 
-  void draw_sprite(const std::shared_ptr<Texture2D> texture,
-                   const glm::vec2 &                position,
-                   const glm::vec2 &                size   = glm::vec2(10.0f),
-                   const float                      rotate = 0.0f,
-                   const glm::vec3 &                color  = glm::vec3(1.0f));
+  void draw_sprite(const Texture2D &texture,
+                   const glm::vec2 &position,
+                   const glm::vec2 &size   = glm::vec2(10.0f),
+                   const float      rotate = 0.0f,
+                   const glm::vec3 &color  = glm::vec3(1.0f));
+
+  void draw_sprite(const TextureHandle texture,
+                   const glm::vec2 &   position,
+                   const glm::vec2 &   size   = glm::vec2(10.0f),
+                   const float         rotate = 0.0f,
+                   const glm::vec3 &   color  = glm::vec3(1.0f));
 
 private:
   const std::shared_ptr<Renderer> renderer;
-  const std::shared_ptr<Shader>   shader;
+  const ShaderHandle              shader;
   VertexArray                     vertex_array;
 
   void init_render_data();
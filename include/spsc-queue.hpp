@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+
+/**
+ * @brief Bounded lock-free queue between exactly one producer thread
+ * and one consumer thread.
+ *
+ * Head and tail are free running counters, each written by one side
+ * only, so neither push nor pop ever waits or allocates. They live on
+ * cache lines of their own to keep both sides from invalidating each
+ * other's line on every operation.
+ */
+template <typename T, std::size_t CAPACITY> class SpscQueue
+{
+  static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0,
+                "Capacity has to be a power of two");
+
+public:
+  /**
+   * @brief Called by the producer.
+   *
+   * @return False if the queue is full
+   */
+  bool try_push(const T &value)
+  {
+    const auto tail = this->tail.load(std::memory_order_relaxed);
+    if (tail - head.load(std::memory_order_acquire) == CAPACITY)
+      return false;
+
+    values[tail & (CAPACITY - 1)] = value;
+    this->tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Called by the consumer.
+   */
+  std::optional<T> try_pop()
+  {
+    const auto head = this->head.load(std::memory_order_relaxed);
+    if (head == tail.load(std::memory_order_acquire))
+      return std::nullopt;
+
+    const auto value = values[head & (CAPACITY - 1)];
+    this->head.store(head + 1, std::memory_order_release);
+    return value;
+  }
+
+private:
+  static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+  alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> head = 0;
+  alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> tail = 0;
+  alignas(CACHE_LINE_SIZE) std::array<T, CAPACITY> values{};
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <optional>
+
+#include <glm/glm.hpp>
+
+/**
+ * @brief First contact of a moving circle.
+ */
+struct SweepHit
+{
+  float     time;   // fraction of the motion until the contact, 0 to 1
+  glm::vec2 normal; // unit normal of the surface at the contact
+};
+
+/**
+ * @brief Sweeps a circle against an axis aligned box.
+ *
+ * Tests the motion against the box grown by the radius, with rounded
+ * corners. A circle that already overlaps the box hits at time 0.
+ *
+ * @return The contact or nothing if the circle does not move into the
+ * box during the motion
+ */
+std::optional<SweepHit> sweep_circle_box(glm::vec2 center,
+                                         float     radius,
+                                         glm::vec2 motion,
+                                         glm::vec2 box_min,
+                                         glm::vec2 box_max);
+
+/**
+ * @brief Sweeps a circle against the boundary of a half plane.
+ *
+ * @param point Any point on the boundary
+ * @param normal Unit normal pointing to the side the circle stays on
+ *
+ * @return The contact or nothing if the circle does not cross the
+ * boundary during the motion
+ */
+std::optional<SweepHit> sweep_circle_plane(glm::vec2 center,
+                                           float     radius,
+                                           glm::vec2 motion,
+                                           glm::vec2 point,
+                                           glm::vec2 normal);
+
+/**
+ * @brief Mirrors a velocity at a surface with the given unit normal.
+ */
+glm::vec2 reflect_velocity(glm::vec2 velocity, glm::vec2 normal);
@@ -0,0 +1,296 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "asseration.hpp"
+
+template <typename T> class Task;
+
+namespace detail
+{
+
+class TaskPromiseBase;
+
+struct FinalAwaiter
+{
+  bool await_ready() noexcept { return false; }
+
+  // Hand over to whoever awaited the task without growing the stack
+  template <typename Promise>
+  std::coroutine_handle<>
+  await_suspend(std::coroutine_handle<Promise> handle) noexcept;
+
+  void await_resume() noexcept {}
+};
+
+class TaskPromiseBase
+{
+public:
+  std::suspend_always initial_suspend() noexcept { return {}; }
+
+  FinalAwaiter final_suspend() noexcept { return {}; }
+
+  void unhandled_exception() { exception = std::current_exception(); }
+
+  void set_continuation(std::coroutine_handle<> continuation)
+  {
+    this->continuation = continuation;
+  }
+
+  bool is_done() const { return done.load(std::memory_order_acquire); }
+
+protected:
+  friend struct FinalAwaiter;
+
+  std::coroutine_handle<> continuation;
+  std::exception_ptr      exception;
+  std::atomic<bool>       done = false;
+
+  void rethrow_if_failed()
+  {
+    if (exception)
+      std::rethrow_exception(exception);
+  }
+};
+
+template <typename Promise>
+std::coroutine_handle<>
+FinalAwaiter::await_suspend(std::coroutine_handle<Promise> handle) noexcept
+{
+  // Once done is set, a polling owner may destroy the frame, so the
+  // promise must not be touched afterwards
+  TaskPromiseBase &promise      = handle.promise();
+  const auto       continuation = promise.continuation;
+  promise.done.store(true, std::memory_order_release);
+  if (continuation)
+    return continuation;
+  return std::noop_coroutine();
+}
+
+template <typename T> class TaskPromise : public TaskPromiseBase
+{
+public:
+  Task<T> get_return_object();
+
+  template <typename U> void return_value(U &&value)
+  {
+    result.emplace(std::forward<U>(value));
+  }
+
+  T take_result()
+  {
+    rethrow_if_failed();
+    return std::move(*result);
+  }
+
+private:
+  std::optional<T> result;
+};
+
+template <> class TaskPromise<void> : public TaskPromiseBase
+{
+public:
+  Task<void> get_return_object();
+
+  void return_void() {}
+
+  void take_result() { rethrow_if_failed(); }
+};
+
+} // namespace detail
+
+/**
+ * @brief A lazily started coroutine producing a value of type T.
+ *
+ * The coroutine does not run until it is awaited or started. Where it
+ * continues after a co_await depends on the awaited object, e.g.
+ * ThreadPool::schedule() moves it to a worker and
+ * UploadQueue::schedule() moves it back to the thread owning the GL
+ * and AL contexts. Exceptions are rethrown to the awaiting coroutine.
+ *
+ * Coroutine parameters have to be taken by value since the task may
+ * outlive the caller's arguments.
+ */
+template <typename T = void> class [[nodiscard]] Task
+{
+public:
+  using promise_type = detail::TaskPromise<T>;
+
+  Task() = default;
+
+  explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+  Task(Task &&other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+
+  Task &operator=(Task &&other) noexcept
+  {
+    if (this != &other)
+    {
+      destroy();
+      handle = std::exchange(other.handle, nullptr);
+    }
+    return *this;
+  }
+
+  ~Task() { destroy(); }
+
+  bool is_valid() const { return handle != nullptr; }
+
+  /**
+   * @brief Runs the task until its first suspension point.
+   *
+   * Used for the outermost task, which nobody awaits. Poll is_done()
+   * to find out when it finished.
+   */
+  void start()
+  {
+    ASSERT(handle);
+    handle.resume();
+  }
+
+  bool is_done() const { return handle && handle.promise().is_done(); }
+
+  /**
+   * @brief Returns the result of a finished task.
+   *
+   * @throws Whatever the coroutine threw
+   */
+  T get()
+  {
+    ASSERT(is_done());
+    return handle.promise().take_result();
+  }
+
+  auto operator co_await() noexcept
+  {
+    struct Awaiter
+    {
+      std::coroutine_handle<promise_type> handle;
+
+      bool await_ready() noexcept { return false; }
+
+      std::coroutine_handle<>
+      await_suspend(std::coroutine_handle<> continuation) noexcept
+      {
+        handle.promise().set_continuation(continuation);
+        return handle;
+      }
+
+      T await_resume() { return handle.promise().take_result(); }
+    };
+    return Awaiter{handle};
+  }
+
+private:
+  std::coroutine_handle<promise_type> handle;
+
+  void destroy()
+  {
+    if (handle)
+      handle.destroy();
+    handle = nullptr;
+  }
+
+  Task(const Task &) = delete;
+  Task &operator=(const Task &) = delete;
+};
+
+namespace detail
+{
+
+template <typename T> Task<T> TaskPromise<T>::get_return_object()
+{
+  return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object()
+{
+  return Task<void>(
+      std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+struct WhenAllState
+{
+  std::atomic<std::size_t> remaining;
+  std::coroutine_handle<>  continuation;
+  std::mutex               exception_mutex;
+  std::exception_ptr       exception;
+};
+
+/**
+ * @brief Eagerly started coroutine that destroys itself when done.
+ */
+struct DetachedTask
+{
+  struct promise_type
+  {
+    DetachedTask        get_return_object() { return {}; }
+    std::suspend_never  initial_suspend() noexcept { return {}; }
+    std::suspend_never  final_suspend() noexcept { return {}; }
+    void                return_void() {}
+    [[noreturn]] void   unhandled_exception() { std::terminate(); }
+  };
+};
+
+// The state lives in the awaiting frame, which may be gone as soon as
+// the continuation was resumed, so that has to be the last access
+inline DetachedTask run_when_all_part(Task<void> task, WhenAllState *state)
+{
+  try
+  {
+    co_await task;
+  }
+  catch (...)
+  {
+    std::lock_guard<std::mutex> lock(state->exception_mutex);
+    if (!state->exception)
+      state->exception = std::current_exception();
+  }
+
+  if (state->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    state->continuation.resume();
+}
+
+} // namespace detail
+
+/**
+ * @brief Runs tasks concurrently and waits for all of them.
+ *
+ * The awaiting coroutine continues on the thread that finished the
+ * last task. If tasks failed, the first exception is rethrown after
+ * all tasks are done.
+ */
+inline Task<void> when_all(std::vector<Task<void>> tasks)
+{
+  struct Awaiter
+  {
+    std::vector<Task<void>> &tasks;
+    detail::WhenAllState     state;
+
+    bool await_ready() { return tasks.empty(); }
+
+    bool await_suspend(std::coroutine_handle<> continuation)
+    {
+      // One extra count so no part can resume us before all started
+      state.remaining    = tasks.size() + 1;
+      state.continuation = continuation;
+      for (auto &task : tasks)
+        detail::run_when_all_part(std::move(task), &state);
+      return state.remaining.fetch_sub(1, std::memory_order_acq_rel) != 1;
+    }
+
+    void await_resume()
+    {
+      if (state.exception)
+        std::rethrow_exception(state.exception);
+    }
+  };
+
+  co_await Awaiter{tasks, {}};
+}
@@ -1,11 +1,14 @@
 #pragma once
 
 #include <unordered_map>
+#include <vector>
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
+#include "asset-store.hpp"
 #include "renderer.hpp"
+#include "resource-registry.hpp"
 #include "shader.hpp"
 #include "texture.hpp"
 #include "vertex-array.hpp"
@@ -56,6 +59,18 @@ struct Character
   // }
 };
 
+/**
+ * A rasterized glyph that is not yet uploaded to the GPU
+ */
+struct Glyph
+{
+  char                       character;
+  std::vector<unsigned char> bitmap;
+  glm::ivec2                 size;
+  glm::ivec2                 bearing;
+  long                       advance;
+};
+
 /**
  * A renderer class for rendering text displayed by a font loaded
  * using the FreeType library. A single font is loaded, processed into
@@ -65,7 +80,7 @@ class TextRenderer
 {
 public:
   TextRenderer(const std::shared_ptr<Renderer> renderer,
-               std::shared_ptr<Shader>         text_shader,
+               const ShaderHandle              text_shader,
                unsigned                        width,
                unsigned                        height);
 
@@ -74,6 +89,22 @@ public:
    */
   void load(const std::string font, unsigned font_size);
 
+  /**
+   * @brief Rasterizes the characters of a font without touching GL.
+   *
+   * Can run on any thread, the result is uploaded with load().
+   */
+  static std::vector<Glyph> rasterize(const std::string &font,
+                                      unsigned           font_size);
+
+  static std::vector<Glyph> rasterize(const Asset &font_asset,
+                                      unsigned     font_size);
+
+  /**
+   * @brief Uploads rasterized glyphs as the list of characters.
+   */
+  void load(const std::vector<Glyph> &glyphs);
+
   /**
    * @brief Renders a string of text using the precompiled list of characters.
    */
@@ -88,7 +119,7 @@ private:
 
   std::unique_ptr<VertexBuffer>   vertex_buffer = nullptr;
   const std::shared_ptr<Renderer> renderer      = nullptr;
-  std::shared_ptr<Shader>         text_shader   = nullptr;
+  const ShaderHandle              text_shader;
 
   // Holds a list of pre-compiled characters
   std::unordered_map<char, std::shared_ptr<Character>> characters;
@@ -2,6 +2,8 @@
 
 #include <glad/glad.h>
 
+#include "cooked-texture.hpp"
+
 class Texture2D
 {
 public:
@@ -15,6 +17,15 @@ public:
             unsigned             wrap_s          = GL_REPEAT,
             unsigned             wrap_t          = GL_REPEAT);
 
+  /**
+   * @brief Uploads all mip levels of a cooked texture.
+   *
+   * Compressed textures require EXT_texture_compression_s3tc.
+   */
+  explicit Texture2D(const CookedTexture &cooked,
+                     unsigned             wrap_s = GL_REPEAT,
+                     unsigned             wrap_t = GL_REPEAT);
+
   ~Texture2D();
 
   void bind(unsigned slot = 0) const;
@@ -38,4 +49,6 @@ private:
   unsigned filter_max = 0; // filtering mode if texture pixels > screen pixels
 
   void generate(const unsigned char *data);
+
+  void generate(const CookedTexture &cooked);
 };
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <coroutine>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed set of worker threads executing queued jobs.
+ *
+ * Jobs run in submission order on whichever worker is free first.
+ * Pending jobs are still executed when the pool is destroyed.
+ */
+class ThreadPool
+{
+public:
+  /**
+   * @param thread_count Number of workers, defaults to one per core
+   */
+  explicit ThreadPool(unsigned thread_count = default_thread_count());
+
+  ~ThreadPool();
+
+  void post(std::function<void()> job);
+
+  /**
+   * @brief Continues the awaiting coroutine on a worker thread.
+   */
+  auto schedule()
+  {
+    struct Awaiter
+    {
+      ThreadPool &pool;
+
+      bool await_ready() noexcept { return false; }
+
+      void await_suspend(std::coroutine_handle<> handle)
+      {
+        pool.post([handle]() { handle.resume(); });
+      }
+
+      void await_resume() noexcept {}
+    };
+    return Awaiter{*this};
+  }
+
+  std::size_t get_thread_count() const { return threads.size(); }
+
+  static unsigned default_thread_count()
+  {
+    return std::max(1u, std::thread::hardware_concurrency());
+  }
+
+private:
+  std::vector<std::thread>          threads;
+  std::queue<std::function<void()>> jobs;
+  std::mutex                        mutex;
+  std::condition_variable           condition;
+  bool                              stopping = false;
+
+  void work();
+
+  ThreadPool(ThreadPool &)  = delete;
+  ThreadPool(ThreadPool &&) = delete;
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+/**
+ * @brief Box of an entity in the play field.
+ *
+ * Plain data without virtual functions, entities hold only the
+ * components they use. Many entities of a kind are kept in pools of
+ * their own instead, see BallPool and PowerUpPool.
+ */
+struct Transform
+{
+  glm::vec2 position{0.0f};
+  glm::vec2 size{0.0f};
+  glm::vec2 previous_position{0.0f}; // of the last tick
+
+  /**
+   * @brief Keeps the current position as the one of the last tick.
+   */
+  void store_previous_position() { previous_position = position; }
+
+  /**
+   * @brief Position between the last two ticks.
+   *
+   * @param alpha 0 returns the previous position, 1 the current one
+   */
+  glm::vec2 get_interpolated_position(float alpha) const
+  {
+    return glm::mix(previous_position, position, alpha);
+  }
+};
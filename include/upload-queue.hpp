@@ -0,0 +1,57 @@
+#pragma once
+
+#include <chrono>
+#include <coroutine>
+#include <deque>
+#include <mutex>
+
+/**
+ * @brief Hands coroutines back to the thread owning the GL and AL
+ * contexts.
+ *
+ * Loading coroutines decode on worker threads and then co_await
+ * schedule() to do their uploads. The owning thread calls drain()
+ * once per frame, which resumes waiting coroutines until the frame's
+ * time budget is used up, so loading never stalls rendering for long.
+ */
+class UploadQueue
+{
+public:
+  auto schedule()
+  {
+    struct Awaiter
+    {
+      UploadQueue &queue;
+
+      bool await_ready() noexcept { return false; }
+
+      void await_suspend(std::coroutine_handle<> handle)
+      {
+        queue.push(handle);
+      }
+
+      void await_resume() noexcept {}
+    };
+    return Awaiter{*this};
+  }
+
+  /**
+   * @brief Resumes waiting coroutines on the calling thread.
+   *
+   * At least one coroutine is resumed, so progress is made even if a
+   * single upload takes longer than the budget.
+   *
+   * @return Number of resumed coroutines
+   */
+  std::size_t drain(std::chrono::microseconds budget);
+
+  bool is_empty();
+
+private:
+  std::deque<std::coroutine_handle<>> handles;
+  std::mutex                          mutex;
+
+  void push(std::coroutine_handle<> handle);
+
+  bool pop(std::coroutine_handle<> &handle);
+};
@@ -1,34 +1,30 @@
 #pragma once
 
-#include <array>
-#include <vector>
+#include <cstdint>
+#include <span>
+#include <string>
 
-#include "open-al.hpp"
-
-class WavFile
+/**
+ * @brief Format of a wav file and a view of its samples.
+ */
+struct WavView
 {
-public:
-  const std::string                name;
-  const std::uint8_t               channels;
-  const std::int32_t               sample_rate;
-  const std::uint8_t               bits_per_sample;
-  const std::size_t                size;
-  const std::vector<unsigned char> data;
-
-  WavFile(const std::string &               name,
-          const std::uint8_t                channels,
-          const std::int32_t                sample_rate,
-          const std::uint8_t                bits_per_sample,
-          const std::size_t                 size,
-          const std::vector<unsigned char> &data)
-      : name(name),
-        channels(channels),
-        sample_rate(sample_rate),
-        bits_per_sample(bits_per_sample),
-        size(size),
-        data(data)
-  {
-  }
+  std::uint8_t                   channels;
+  std::int32_t                   sample_rate;
+  std::uint8_t                   bits_per_sample;
+  std::span<const unsigned char> samples;
 };
 
-WavFile load_wav(const std::string &filename);
+/**
+ * @brief Parses a wav file in memory, the samples are not copied.
+ *
+ * Walks the RIFF chunks of the file, so chunks other than "fmt " and
+ * "data" like LIST are skipped wherever they are. Plain PCM and PCM in
+ * the WAVE_FORMAT_EXTENSIBLE layout are supported.
+ *
+ * @param name Name of the file, used for error messages
+ * @param data Content of the wav file, has to outlive the view
+ *
+ * @throws std::runtime_error if the file is no valid PCM wav file
+ */
+WavView view_wav(const std::string &name, std::span<const unsigned char> data);
@@ -27,6 +27,13 @@ public:
 
   void set_should_close(bool value);
 
+  /**
+   * @brief Limits how often a frame is drawn.
+   *
+   * @param frame_rate Frames per second or 0 for no limit
+   */
+  void set_max_frame_rate(double frame_rate) { max_frame_rate = frame_rate; }
+
 protected:
   const std::string         title;
   int                       window_width  = 1280;
@@ -51,8 +58,9 @@ protected:
   unsigned long long frames_count = 0;
 
 private:
-  GLFWwindow *window     = nullptr;
-  bool        fullscreen = false;
+  GLFWwindow *window         = nullptr;
+  bool        fullscreen     = false;
+  double      max_frame_rate = 0.0;
 
   friend void
   window_framebuffer_size_callback(GLFWwindow *window, int width, int height);
@@ -67,4 +75,6 @@ private:
   void initRenderer();
 
   void calcDeltaTime();
+
+  void wait_for_next_frame();
 };
@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "asset-pack.hpp"
+#include "hash.hpp"
+#include "log.hpp"
+#include "lz.hpp"
+
+static const std::string LOG_TAG = "AssetPack";
+
+static std::uint64_t align_up(std::uint64_t value)
+{
+  return (value + ASSET_PACK_ALIGNMENT - 1) & ~(ASSET_PACK_ALIGNMENT - 1);
+}
+
+AssetPack::AssetPack(const std::string &file) : file(file)
+{
+  if constexpr (std::endian::native != std::endian::little)
+  {
+    throw std::runtime_error("Asset packs are only supported on little "
+                             "endian platforms");
+  }
+
+  const auto data = this->file.data();
+
+  AssetPackHeader header;
+  if (data.size() < sizeof(header))
+  {
+    throw std::runtime_error("Asset pack \"" + file + "\" is truncated");
+  }
+  std::memcpy(&header, data.data(), sizeof(header));
+
+  if (std::memcmp(header.magic, ASSET_PACK_MAGIC, sizeof(header.magic)) != 0)
+  {
+    throw std::runtime_error("\"" + file + "\" is not an asset pack");
+  }
+
+  if (header.version != ASSET_PACK_VERSION)
+  {
+    throw std::runtime_error("Asset pack \"" + file + "\" has version " +
+                             std::to_string(header.version) + ", expected " +
+                             std::to_string(ASSET_PACK_VERSION));
+  }
+
+  const auto toc_size =
+      static_cast<std::uint64_t>(header.entry_count) * sizeof(AssetPackEntry);
+  if (header.toc_offset % alignof(AssetPackEntry) != 0 ||
+      header.toc_offset > data.size() ||
+      toc_size > data.size() - header.toc_offset ||
+      header.names_offset > data.size())
+  {
+    throw std::runtime_error("Asset pack \"" + file +
+                             "\" has a corrupt table of contents");
+  }
+
+  entries = {reinterpret_cast<const AssetPackEntry *>(data.data() +
+                                                      header.toc_offset),
+             header.entry_count};
+
+  names = {reinterpret_cast<const char *>(data.data() + header.names_offset),
+           data.size() - header.names_offset};
+
+  for (const auto &entry : entries)
+  {
+    if (entry.offset > data.size() ||
+        entry.stored_size > data.size() - entry.offset ||
+        entry.name_offset > names.size() ||
+        entry.name_length > names.size() - entry.name_offset)
+    {
+      throw std::runtime_error("Asset pack \"" + file +
+                               "\" has an entry out of bounds");
+    }
+  }
+
+  Log().i(LOG_TAG) << "Mounted asset pack " << file << " with "
+                   << entries.size() << " entries";
+}
+
+const AssetPackEntry *AssetPack::find(std::string_view name) const
+{
+  const auto name_hash = hash_fnv1a(name);
+
+  auto it = std::lower_bound(entries.begin(),
+                             entries.end(),
+                             name_hash,
+                             [](const AssetPackEntry &entry, std::uint64_t h) {
+                               return entry.name_hash < h;
+                             });
+
+  // Walk all entries with the same hash in case of collisions
+  for (; it != entries.end() && it->name_hash == name_hash; ++it)
+  {
+    if (get_name(*it) == name)
+      return &*it;
+  }
+
+  return nullptr;
+}
+
+std::string_view AssetPack::get_name(const AssetPackEntry &entry) const
+{
+  return {names.data() + entry.name_offset, entry.name_length};
+}
+
+std::span<const unsigned char>
+AssetPack::get_stored_data(const AssetPackEntry &entry) const
+{
+  return file.data().subspan(entry.offset, entry.stored_size);
+}
+
+bool AssetPack::verify(const AssetPackEntry &entry) const
+{
+  const auto stored_data = get_stored_data(entry);
+
+  if (!(entry.flags & AssetPackEntry::COMPRESSED))
+    return hash_fnv1a(stored_data) == entry.content_hash;
+
+  std::vector<unsigned char> data(entry.size);
+  try
+  {
+    lz_decompress(stored_data, data);
+  }
+  catch (const std::runtime_error &)
+  {
+    return false;
+  }
+  return hash_fnv1a(data) == entry.content_hash;
+}
+
+void AssetPackWriter::add(const std::string &            name,
+                          std::span<const unsigned char> data,
+                          bool                           compress)
+{
+  Entry entry{name, {}, data.size(), hash_fnv1a(data), false};
+
+  if (compress)
+  {
+    auto compressed = lz_compress(data);
+    // Only keep the compressed block if it saves a meaningful amount
+    if (compressed.size() < data.size() - data.size() / 8)
+    {
+      entry.stored_data = std::move(compressed);
+      entry.compressed  = true;
+    }
+  }
+
+  if (!entry.compressed)
+    entry.stored_data.assign(data.begin(), data.end());
+
+  pending_entries.push_back(std::move(entry));
+}
+
+void AssetPackWriter::write(const std::string &file) const
+{
+  if constexpr (std::endian::native != std::endian::little)
+  {
+    throw std::runtime_error("Asset packs are only supported on little "
+                             "endian platforms");
+  }
+
+  std::vector<const Entry *> sorted_entries;
+  for (const auto &entry : pending_entries)
+    sorted_entries.push_back(&entry);
+  std::sort(sorted_entries.begin(),
+            sorted_entries.end(),
+            [](const Entry *a, const Entry *b) {
+              return hash_fnv1a(a->name) < hash_fnv1a(b->name);
+            });
+
+  // Lay out header, table of contents, names and data
+  AssetPackHeader header{};
+  std::memcpy(header.magic, ASSET_PACK_MAGIC, sizeof(header.magic));
+  header.version     = ASSET_PACK_VERSION;
+  header.entry_count = static_cast<std::uint32_t>(sorted_entries.size());
+  header.toc_offset  = align_up(sizeof(AssetPackHeader));
+  header.names_offset =
+      align_up(header.toc_offset +
+               sorted_entries.size() * sizeof(AssetPackEntry));
+
+  std::string                 names;
+  std::vector<AssetPackEntry> toc;
+  for (const auto *entry : sorted_entries)
+  {
+    AssetPackEntry toc_entry{};
+    toc_entry.name_hash    = hash_fnv1a(entry->name);
+    toc_entry.content_hash = entry->content_hash;
+    toc_entry.stored_size  = entry->stored_data.size();
+    toc_entry.size         = entry->size;
+    toc_entry.name_offset  = static_cast<std::uint32_t>(names.size());
+    toc_entry.name_length  = static_cast<std::uint32_t>(entry->name.size());
+    toc_entry.flags =
+        entry->compressed ? std::uint32_t(AssetPackEntry::COMPRESSED) : 0u;
+    names += entry->name;
+    toc.push_back(toc_entry);
+  }
+
+  auto offset = align_up(header.names_offset + names.size());
+  for (auto &toc_entry : toc)
+  {
+    toc_entry.offset = offset;
+    offset           = align_up(offset + toc_entry.stored_size);
+  }
+
+  std::ofstream out(file, std::ios::binary | std::ios::trunc);
+  if (!out)
+  {
+    throw std::runtime_error("Could not open \"" + file + "\" for writing");
+  }
+
+  const auto pad_to = [&out](std::uint64_t position) {
+    static const char zeros[ASSET_PACK_ALIGNMENT] = {};
+    const auto        current = static_cast<std::uint64_t>(out.tellp());
+    out.write(zeros, static_cast<std::streamsize>(position - current));
+  };
+
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  pad_to(header.toc_offset);
+  out.write(reinterpret_cast<const char *>(toc.data()),
+            static_cast<std::streamsize>(toc.size() * sizeof(AssetPackEntry)));
+  pad_to(header.names_offset);
+  out.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+  for (std::size_t i = 0; i < sorted_entries.size(); ++i)
+  {
+    const auto &stored_data = sorted_entries[i]->stored_data;
+    pad_to(toc[i].offset);
+    out.write(reinterpret_cast<const char *>(stored_data.data()),
+              static_cast<std::streamsize>(stored_data.size()));
+  }
+
+  if (!out)
+  {
+    throw std::runtime_error("Could not write asset pack \"" + file + "\"");
+  }
+}
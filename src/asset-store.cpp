@@ -0,0 +1,128 @@
+#include <filesystem>
+#include <set>
+#include <stdexcept>
+
+#include "asset-store.hpp"
+#include "embedded-assets.hpp"
+#include "log.hpp"
+#include "lz.hpp"
+
+static const std::string LOG_TAG = "AssetStore";
+
+const std::vector<std::string> AssetStore::loose_directories = {"cooked",
+                                                                 "resources"};
+
+std::unique_ptr<AssetPack> AssetStore::pack;
+
+void AssetStore::mount(const std::string &pack_file)
+{
+  auto mounted_pack = std::make_unique<AssetPack>(pack_file);
+
+  // Checked once for all entries instead of on every read, which would
+  // hash a streamed track whenever it is opened
+  for (const auto &entry : mounted_pack->get_entries())
+  {
+    if (!mounted_pack->verify(entry))
+    {
+      throw std::runtime_error("Asset " +
+                               std::string(mounted_pack->get_name(entry)) +
+                               " in pack \"" + pack_file +
+                               "\" does not match its content hash");
+    }
+  }
+
+  pack = std::move(mounted_pack);
+}
+
+void AssetStore::unmount() { pack.reset(); }
+
+Asset AssetStore::read(const std::string &path)
+{
+  if (const auto file = find_embedded_file(path))
+    return Asset(file->data);
+
+  if (pack)
+  {
+    if (const auto entry = pack->find(path))
+    {
+      const auto stored_data = pack->get_stored_data(*entry);
+
+      if (!(entry->flags & AssetPackEntry::COMPRESSED))
+        return Asset(stored_data);
+
+      std::vector<unsigned char> data(entry->size);
+      lz_decompress(stored_data, data);
+      return Asset(std::move(data));
+    }
+
+    Log().w(LOG_TAG) << "Asset " << path
+                     << " not in asset pack, falling back to loose file";
+  }
+
+  return Asset(std::make_unique<MappedFile>(get_loose_path(path)));
+}
+
+Task<Asset> AssetStore::read_async(FileReader &reader, std::string path)
+{
+  // Embedded files and pack entries are in memory already
+  if (find_embedded_file(path) || (pack && pack->find(path)))
+    co_return read(path);
+
+  co_return Asset(co_await reader.read_async(get_loose_path(path)));
+}
+
+bool AssetStore::exists(const std::string &path)
+{
+  if (find_embedded_file(path))
+    return true;
+
+  if (pack && pack->find(path))
+    return true;
+
+  return std::filesystem::exists(get_loose_path(path));
+}
+
+std::vector<std::string> AssetStore::list(const std::string &directory)
+{
+  const auto prefix = directory + "/";
+
+  std::set<std::string> paths;
+  if (pack)
+  {
+    for (const auto &entry : pack->get_entries())
+    {
+      const auto name = pack->get_name(entry);
+      if (name.starts_with(prefix))
+        paths.emplace(name);
+    }
+  }
+
+  for (const auto &loose_directory : loose_directories)
+  {
+    const auto root = std::filesystem::path(loose_directory);
+    if (!std::filesystem::is_directory(root / directory))
+      continue;
+
+    for (const auto &entry :
+         std::filesystem::recursive_directory_iterator(root / directory))
+    {
+      if (entry.is_regular_file())
+        paths.insert(
+            std::filesystem::relative(entry.path(), root).generic_string());
+    }
+  }
+
+  return {paths.begin(), paths.end()};
+}
+
+std::string AssetStore::get_loose_path(const std::string &path)
+{
+  for (const auto &directory : loose_directories)
+  {
+    auto loose_path = directory + "/" + path;
+    if (std::filesystem::exists(loose_path))
+      return loose_path;
+  }
+
+  return loose_directories.back() + "/" + path;
+}
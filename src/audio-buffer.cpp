@@ -4,17 +4,16 @@
 
 static const std::string LOG_TAG = "AudioBuffer";
 
-AudioBuffer::AudioBuffer(const Format                      format,
-                         const std::vector<unsigned char> &data,
-                         const std::int32_t                sample_rate,
-                         const std::size_t                 size)
+AudioBuffer::AudioBuffer(const Format                   format,
+                         std::span<const unsigned char> data,
+                         const std::int32_t             sample_rate)
 {
   AL_CALL(alGenBuffers, 1, &id);
   AL_CALL(alBufferData,
           id,
           format_to_al_enum(format),
           data.data(),
-          size,
+          static_cast<ALsizei>(data.size()),
           sample_rate);
 }
 
@@ -0,0 +1,167 @@
+#include "audio-thread.hpp"
+
+static const std::string LOG_TAG = "AudioThread";
+
+AudioThread::AudioThread(unsigned voice_count)
+    : voices(voice_count),
+      voice_count(voice_count)
+{
+  enable_state_events();
+  thread = std::thread(&AudioThread::run, this);
+}
+
+AudioThread::~AudioThread()
+{
+  // No callback runs anymore once it is unregistered
+  disable_state_events();
+
+  stopping.store(true, std::memory_order_release);
+  wake();
+  thread.join();
+}
+
+bool AudioThread::play(const AudioBuffer &buffer,
+                       unsigned           priority,
+                       double             time)
+{
+  Command command;
+  command.type     = Command::Type::PLAY;
+  command.buffer   = &buffer;
+  command.priority = priority;
+  command.time     = time;
+  return push(command);
+}
+
+bool AudioThread::stop()
+{
+  Command command;
+  command.type = Command::Type::STOP;
+  return push(command);
+}
+
+bool AudioThread::set_gain(float gain)
+{
+  Command command;
+  command.type = Command::Type::SET_GAIN;
+  command.gain = gain;
+  return push(command);
+}
+
+bool AudioThread::push(const Command &command)
+{
+  if (!commands.try_push(command))
+    return false;
+
+  wake();
+  return true;
+}
+
+void AudioThread::wake()
+{
+  wakeups.fetch_add(1, std::memory_order_release);
+  wakeups.notify_one();
+}
+
+void AudioThread::run()
+{
+  while (!stopping.load(std::memory_order_acquire))
+  {
+    const auto seen = wakeups.load(std::memory_order_acquire);
+
+    // State changes first, so stopped voices are free for new sounds
+    while (const auto source = stopped_sources.try_pop())
+      voices.source_stopped(*source);
+    if (lost_events.exchange(false, std::memory_order_acq_rel))
+      voices.poll_states();
+
+    while (const auto command = commands.try_pop())
+      execute(*command);
+
+    wakeups.wait(seen, std::memory_order_acquire);
+  }
+}
+
+void AudioThread::execute(const Command &command)
+{
+  switch (command.type)
+  {
+  case Command::Type::PLAY:
+    voices.play(*command.buffer, command.priority, command.time);
+    raise_peak_count(voices.get_peak_count());
+    voices.reset_peak_count();
+    break;
+  case Command::Type::STOP:
+    voices.stop_all();
+    break;
+  case Command::Type::SET_GAIN:
+    voices.set_gain(command.gain);
+    break;
+  }
+}
+
+void AudioThread::raise_peak_count(unsigned count)
+{
+  auto peak = peak_count.load(std::memory_order_relaxed);
+  while (count > peak &&
+         !peak_count.compare_exchange_weak(peak,
+                                           count,
+                                           std::memory_order_relaxed))
+  {
+  }
+}
+
+void AudioThread::enable_state_events()
+{
+  if (!alIsExtensionPresent("AL_SOFT_events"))
+  {
+    Log().i(LOG_TAG) << "AL_SOFT_events not supported, poll voices";
+    return;
+  }
+
+  event_control = reinterpret_cast<LPALEVENTCONTROLSOFT>(
+      alGetProcAddress("alEventControlSOFT"));
+  event_callback = reinterpret_cast<LPALEVENTCALLBACKSOFT>(
+      alGetProcAddress("alEventCallbackSOFT"));
+  if (!event_control || !event_callback)
+  {
+    event_control  = nullptr;
+    event_callback = nullptr;
+    return;
+  }
+
+  const ALenum type = AL_EVENT_TYPE_SOURCE_STATE_CHANGED_SOFT;
+  AL_CALL(event_callback, &AudioThread::on_event, this);
+  AL_CALL(event_control, 1, &type, AL_TRUE);
+  voices.set_polling(false);
+}
+
+void AudioThread::disable_state_events()
+{
+  if (!has_state_events())
+    return;
+
+  const ALenum type = AL_EVENT_TYPE_SOURCE_STATE_CHANGED_SOFT;
+  AL_CALL(event_control, 1, &type, AL_FALSE);
+  AL_CALL(event_callback, nullptr, nullptr);
+}
+
+void AL_APIENTRY AudioThread::on_event(ALenum type,
+                                       ALuint object,
+                                       ALuint param,
+                                       ALsizei,
+                                       const ALchar *,
+                                       void *user) noexcept
+{
+  // Voices are marked playing when a sound starts, only the end of a
+  // sound is of interest
+  if (type != AL_EVENT_TYPE_SOURCE_STATE_CHANGED_SOFT ||
+      static_cast<ALint>(param) == AL_PLAYING)
+    return;
+
+  // AL must not be called from here, the audio thread confirms the
+  // state change
+  auto &audio_thread = *static_cast<AudioThread *>(user);
+  if (!audio_thread.stopped_sources.try_push(object))
+    audio_thread.lost_events.store(true, std::memory_order_release);
+  audio_thread.wake();
+}
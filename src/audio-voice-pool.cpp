@@ -0,0 +1,136 @@
+#include <algorithm>
+
+#include "audio-voice-pool.hpp"
+
+static const std::string LOG_TAG = "AudioVoicePool";
+
+AudioVoicePool::AudioVoicePool(unsigned voice_count, double merge_time)
+    : voices(voice_count),
+      merge_time(merge_time)
+{
+  for (auto &voice : voices)
+  {
+    AL_CALL(alGenSources, 1, &voice.source);
+    AL_CALL(alSourcef, voice.source, AL_PITCH, 1);
+    AL_CALL(alSourcef, voice.source, AL_GAIN, 1.0f);
+    AL_CALL(alSource3f, voice.source, AL_POSITION, 0, 0, 0);
+    AL_CALL(alSource3f, voice.source, AL_VELOCITY, 0, 0, 0);
+    AL_CALL(alSourcei, voice.source, AL_LOOPING, AL_FALSE);
+  }
+  Log().d(LOG_TAG) << "Created " << voice_count << " voices";
+}
+
+AudioVoicePool::~AudioVoicePool()
+{
+  for (auto &voice : voices)
+    AL_CALL(alDeleteSources, 1, &voice.source);
+}
+
+bool AudioVoicePool::play(const AudioBuffer &buffer,
+                          unsigned           priority,
+                          double             time)
+{
+  if (polling)
+    poll_states();
+
+  const auto buffer_id   = static_cast<ALuint>(buffer.get_id());
+  Voice *    free_voice  = nullptr;
+  Voice *    steal_voice = nullptr;
+  unsigned   active      = 0;
+  for (auto &voice : voices)
+  {
+    if (!voice.playing)
+    {
+      if (!free_voice)
+        free_voice = &voice;
+      continue;
+    }
+    ++active;
+
+    if (voice.buffer == buffer_id && time - voice.start_time < merge_time)
+      return false;
+
+    if (!steal_voice || voice.priority < steal_voice->priority ||
+        (voice.priority == steal_voice->priority &&
+         voice.start_time < steal_voice->start_time))
+      steal_voice = &voice;
+  }
+
+  auto voice = free_voice;
+  if (!voice)
+  {
+    if (!steal_voice || steal_voice->priority > priority)
+      return false;
+
+    voice = steal_voice;
+    AL_CALL(alSourceStop, voice->source);
+    --active;
+  }
+
+  AL_CALL(alSourcei, voice->source, AL_BUFFER, static_cast<ALint>(buffer_id));
+  AL_CALL(alSourcePlay, voice->source);
+
+  voice->buffer     = buffer_id;
+  voice->priority   = priority;
+  voice->start_time = time;
+  voice->playing    = true;
+
+  peak_count = std::max(peak_count, active + 1);
+  return true;
+}
+
+unsigned AudioVoicePool::get_active_count()
+{
+  if (polling)
+    poll_states();
+
+  unsigned active = 0;
+  for (const auto &voice : voices)
+  {
+    if (voice.playing)
+      ++active;
+  }
+  return active;
+}
+
+void AudioVoicePool::poll_states()
+{
+  for (auto &voice : voices)
+  {
+    if (!voice.playing)
+      continue;
+
+    ALint state;
+    AL_CALL(alGetSourcei, voice.source, AL_SOURCE_STATE, &state);
+    voice.playing = state == AL_PLAYING;
+  }
+}
+
+void AudioVoicePool::source_stopped(ALuint source)
+{
+  for (auto &voice : voices)
+  {
+    if (voice.source != source || !voice.playing)
+      continue;
+
+    ALint state;
+    AL_CALL(alGetSourcei, voice.source, AL_SOURCE_STATE, &state);
+    voice.playing = state == AL_PLAYING;
+  }
+}
+
+void AudioVoicePool::stop_all()
+{
+  for (auto &voice : voices)
+  {
+    if (voice.playing)
+      AL_CALL(alSourceStop, voice.source);
+    voice.playing = false;
+  }
+}
+
+void AudioVoicePool::set_gain(float gain)
+{
+  for (auto &voice : voices)
+    AL_CALL(alSourcef, voice.source, AL_GAIN, gain);
+}
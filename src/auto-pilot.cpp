@@ -0,0 +1,225 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "auto-pilot.hpp"
+
+// Distance of the paddle to its target that is not corrected, so the
+// paddle does not jitter around it
+static const float DEAD_ZONE = 4.0f;
+
+// Largest aim, hitting the ball with the very edge of the paddle is
+// not reliable
+static const float MAX_AIM = 0.8f;
+
+// Mirrors a position into [min, max] as often as the ball would bounce
+static float fold(float x, float min, float max)
+{
+  const auto length = max - min;
+  if (length <= 0.0f)
+    return (min + max) / 2.0f;
+
+  auto offset = std::fmod(x - min, 2.0f * length);
+  if (offset < 0.0f)
+    offset += 2.0f * length;
+  if (offset > length)
+    offset = 2.0f * length - offset;
+  return min + offset;
+}
+
+static bool is_helpful(PowerUp::Type type)
+{
+  return type != PowerUp::Type::CONFUSE && type != PowerUp::Type::CHAOS;
+}
+
+AutoPilot::AutoPilot(const AutoPilotOptions &options, std::uint64_t seed)
+    : options(options),
+      random(seed, RandomStream::AUTO_PILOT)
+{
+}
+
+std::optional<AutoPilot::Landing>
+AutoPilot::predict_landing(const GameSimulation &simulation, std::size_t ball)
+{
+  const auto &balls    = simulation.get_balls();
+  const auto  radius   = balls.radius;
+  const auto  center   = balls.get_center(ball);
+  const auto  velocity = balls.get_velocity(ball);
+  const auto  line_y   = simulation.get_player().position.y - radius;
+
+  if (velocity.y == 0.0f)
+    return std::nullopt;
+
+  // Upwards the ball first travels to the top wall and back
+  auto distance = line_y - center.y;
+  if (velocity.y < 0.0f)
+    distance = (center.y - radius) + (line_y - radius);
+
+  const auto time = std::max(distance / std::abs(velocity.y), 0.0f);
+  const auto x    = fold(center.x + velocity.x * time,
+                      radius,
+                      simulation.get_width() - radius);
+  return Landing{x, time};
+}
+
+GameInput AutoPilot::get_input(const GameSimulation &simulation)
+{
+  GameInput input;
+  if (simulation.get_state() != GameState::GAME_ACTIVE)
+  {
+    approaching   = false;
+    input.confirm = true;
+    return input;
+  }
+
+  const auto &balls    = simulation.get_balls();
+  const auto &player   = simulation.get_player();
+  const auto  paddle_x = player.position.x + player.size.x / 2.0f;
+
+  for (std::size_t i = 0; i < balls.size(); ++i)
+  {
+    if (balls.has_flag(i, BallPool::STUCK))
+    {
+      input.release_ball = true;
+      return input;
+    }
+  }
+
+  // Goes for the ball that comes down first, or follows the first ball
+  // while all of them go up
+  std::size_t            ball = 0;
+  std::optional<Landing> landing;
+  for (std::size_t i = 0; i < balls.size(); ++i)
+  {
+    if (balls.velocity_y[i] <= 0.0f)
+      continue;
+
+    const auto ball_landing = predict_landing(simulation, i);
+    if (ball_landing && (!landing || ball_landing->time < landing->time))
+    {
+      ball    = i;
+      landing = ball_landing;
+    }
+  }
+  if (!landing)
+    landing = predict_landing(simulation, ball);
+  if (!landing)
+    return input;
+
+  if (balls.velocity_y[ball] > 0.0f && !approaching)
+    start_approach(simulation, landing->x, ball);
+  else if (balls.velocity_y[ball] < 0.0f)
+    approaching = false;
+
+  // The ball leaves the paddle depending on where it hits it
+  auto target_x = landing->x - aim * player.size.x / 2.0f;
+  if (missing)
+  {
+    // Waits on the side with more room until the ball is past
+    const auto gap = player.size.x / 2.0f + balls.radius * 4.0f;
+    target_x = landing->x < simulation.get_width() / 2.0f ? landing->x + gap
+                                                          : landing->x - gap;
+  }
+  else if (options.collect_power_ups)
+  {
+    target_x = find_power_up(simulation, target_x, *landing).value_or(target_x);
+  }
+
+  input.move_left  = paddle_x > target_x + DEAD_ZONE;
+  input.move_right = paddle_x < target_x - DEAD_ZONE;
+  return input;
+}
+
+void AutoPilot::start_approach(const GameSimulation &simulation,
+                               float                 landing_x,
+                               std::size_t           ball)
+{
+  approaching = true;
+  missing     = random.next_float() < options.miss_rate;
+
+  // Off center hits keep the ball from bouncing straight up and down
+  if (options.aim_for_bricks)
+    aim = aim_for_bricks(simulation, landing_x, ball);
+  else
+    aim = (random.next_float() - 0.5f) * MAX_AIM;
+}
+
+float AutoPilot::aim_for_bricks(const GameSimulation &simulation,
+                                float                 landing_x,
+                                std::size_t           ball)
+{
+  if (!simulation.has_level())
+    return 0.0f;
+
+  // The lowest breakable bricks are the least likely to be covered
+  const auto &level = simulation.get_level();
+  auto        best  = std::numeric_limits<float>::lowest();
+  glm::vec2   target(landing_x, 0.0f);
+  for (std::size_t cell = 0; cell < level.get_cell_count(); ++cell)
+  {
+    if (!level.is_alive(cell))
+      continue;
+
+    const auto brick = level.get_brick(cell);
+    if (brick.is_solid)
+      continue;
+
+    const auto center = brick.position + brick.size / 2.0f;
+    const auto score  = center.y - std::abs(center.x - landing_x) * 0.1f;
+    if (score > best)
+    {
+      best   = score;
+      target = center;
+    }
+  }
+
+  if (best == std::numeric_limits<float>::lowest())
+    return 0.0f;
+
+  // The paddle turns the ball by INITIAL_BALL_VELOCITY.x times twice
+  // the aim and keeps its vertical speed
+  const auto speed  = std::abs(simulation.get_balls().velocity_y[ball]);
+  const auto line_y = simulation.get_player().position.y;
+  const auto rise   = std::max(line_y - target.y, 1.0f);
+  const auto slope  = (target.x - landing_x) / rise;
+  const auto turn   = 2.0f * INITIAL_BALL_VELOCITY.x;
+  return std::clamp(slope * speed / turn,
+                    -MAX_AIM,
+                    MAX_AIM);
+}
+
+std::optional<float>
+AutoPilot::find_power_up(const GameSimulation &simulation,
+                         float                 target_x,
+                         const Landing &       landing) const
+{
+  const auto &player   = simulation.get_player();
+  const auto  paddle_x = player.position.x + player.size.x / 2.0f;
+  const auto  paddle_y = player.position.y;
+
+  std::optional<float> power_up_x;
+  auto                 earliest_time = landing.time;
+  for (const auto &power_up : simulation.get_power_ups())
+  {
+    if (!is_helpful(power_up.type))
+      continue;
+
+    const auto position = power_up.position;
+    const auto size     = POWER_UP_SIZE;
+    const auto center_x = position.x + size.x / 2.0f;
+    const auto time     = std::max(paddle_y - (position.y + size.y), 0.0f) /
+                      POWER_UP_VELOCITY.y;
+
+    // Under the power-up when it arrives and back under the ball in time
+    const auto time_there = std::abs(center_x - paddle_x) / PLAYER_VELOCITY;
+    const auto time_back  = std::abs(target_x - center_x) / PLAYER_VELOCITY;
+    if (time < earliest_time && time_there <= time &&
+        time + time_back < landing.time)
+    {
+      earliest_time = time;
+      power_up_x    = center_x;
+    }
+  }
+
+  return power_up_x;
+}
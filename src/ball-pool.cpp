@@ -0,0 +1,59 @@
+#include "ball-pool.hpp"
+
+void BallPool::add(glm::vec2 position, glm::vec2 velocity, std::uint8_t flags)
+{
+  position_x.push_back(position.x);
+  position_y.push_back(position.y);
+  previous_x.push_back(position.x);
+  previous_y.push_back(position.y);
+  velocity_x.push_back(velocity.x);
+  velocity_y.push_back(velocity.y);
+  this->flags.push_back(flags);
+}
+
+void BallPool::remove(std::size_t index)
+{
+  const auto remove_from = [index](auto &values) {
+    values[index] = values.back();
+    values.pop_back();
+  };
+
+  remove_from(position_x);
+  remove_from(position_y);
+  remove_from(previous_x);
+  remove_from(previous_y);
+  remove_from(velocity_x);
+  remove_from(velocity_y);
+  remove_from(flags);
+}
+
+void BallPool::clear()
+{
+  position_x.clear();
+  position_y.clear();
+  previous_x.clear();
+  previous_y.clear();
+  velocity_x.clear();
+  velocity_y.clear();
+  flags.clear();
+}
+
+void BallPool::set_flag(std::size_t index, Flags flag, bool value)
+{
+  if (value)
+    flags[index] |= flag;
+  else
+    flags[index] &= ~flag;
+}
+
+void BallPool::set_flag(Flags flag, bool value)
+{
+  for (std::size_t i = 0; i < size(); ++i)
+    set_flag(i, flag, value);
+}
+
+void BallPool::store_previous_positions()
+{
+  previous_x = position_x;
+  previous_y = position_y;
+}
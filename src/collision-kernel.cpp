@@ -0,0 +1,311 @@
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#include "collision-kernel.hpp"
+
+// The SIMD kernels are compiled with per function target attributes, so
+// the rest of the game keeps building for the baseline instruction set
+#if (defined(__GNUC__) || defined(__clang__)) &&                               \
+    (defined(__x86_64__) || defined(__i386__))
+#define HAVE_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+void CollisionBoxes::clear()
+{
+  center_x.clear();
+  center_y.clear();
+  half_width.clear();
+  half_height.clear();
+  ids.clear();
+}
+
+void CollisionBoxes::add(float         x,
+                         float         y,
+                         float         width,
+                         float         height,
+                         std::uint32_t id)
+{
+  center_x.push_back(x + width / 2.0f);
+  center_y.push_back(y + height / 2.0f);
+  half_width.push_back(width / 2.0f);
+  half_height.push_back(height / 2.0f);
+  ids.push_back(id);
+}
+
+// Picks the compass direction with the largest positive dot product
+static HitDirection get_hit_direction(float x, float y)
+{
+  auto  direction = HitDirection::UP;
+  float max       = y;
+  if (x > max)
+  {
+    direction = HitDirection::RIGHT;
+    max       = x;
+  }
+  if (-y > max)
+  {
+    direction = HitDirection::DOWN;
+    max       = -y;
+  }
+  if (-x > max)
+    direction = HitDirection::LEFT;
+  return direction;
+}
+
+static void add_hit(std::vector<CollisionHit> &hits,
+                    std::uint32_t              circle_index,
+                    const CollisionCircle &    circle,
+                    std::uint32_t              box_id,
+                    float                      difference_x,
+                    float                      difference_y)
+{
+  const auto distance = std::sqrt(difference_x * difference_x +
+                                  difference_y * difference_y);
+  hits.push_back({circle_index,
+                  box_id,
+                  difference_x,
+                  difference_y,
+                  circle.radius - distance,
+                  get_hit_direction(difference_x, difference_y)});
+}
+
+static void collide_scalar(std::uint32_t              circle_index,
+                           const CollisionCircle &    circle,
+                           const CollisionBoxes &     boxes,
+                           std::size_t                begin,
+                           std::vector<CollisionHit> &hits)
+{
+  const auto radius_squared = circle.radius * circle.radius;
+
+  for (auto i = begin; i < boxes.size(); ++i)
+  {
+    const auto distance_x = circle.center_x - boxes.center_x[i];
+    const auto distance_y = circle.center_y - boxes.center_y[i];
+
+    // Closest point of the box relative to the circle center
+    const auto difference_x =
+        std::clamp(distance_x, -boxes.half_width[i], boxes.half_width[i]) -
+        distance_x;
+    const auto difference_y =
+        std::clamp(distance_y, -boxes.half_height[i], boxes.half_height[i]) -
+        distance_y;
+
+    if (difference_x * difference_x + difference_y * difference_y <
+        radius_squared)
+    {
+      add_hit(hits,
+              circle_index,
+              circle,
+              boxes.ids[i],
+              difference_x,
+              difference_y);
+    }
+  }
+}
+
+#ifdef HAVE_X86_KERNELS
+
+__attribute__((target("sse2"))) static void
+collide_sse2(std::uint32_t              circle_index,
+             const CollisionCircle &    circle,
+             const CollisionBoxes &     boxes,
+             std::vector<CollisionHit> &hits)
+{
+  const auto center_x       = _mm_set1_ps(circle.center_x);
+  const auto center_y       = _mm_set1_ps(circle.center_y);
+  const auto radius_squared = _mm_set1_ps(circle.radius * circle.radius);
+  const auto zero           = _mm_setzero_ps();
+
+  std::size_t i = 0;
+  for (; i + 4 <= boxes.size(); i += 4)
+  {
+    const auto half_width  = _mm_loadu_ps(&boxes.half_width[i]);
+    const auto half_height = _mm_loadu_ps(&boxes.half_height[i]);
+    const auto distance_x =
+        _mm_sub_ps(center_x, _mm_loadu_ps(&boxes.center_x[i]));
+    const auto distance_y =
+        _mm_sub_ps(center_y, _mm_loadu_ps(&boxes.center_y[i]));
+
+    const auto difference_x = _mm_sub_ps(
+        _mm_min_ps(_mm_max_ps(distance_x, _mm_sub_ps(zero, half_width)),
+                   half_width),
+        distance_x);
+    const auto difference_y = _mm_sub_ps(
+        _mm_min_ps(_mm_max_ps(distance_y, _mm_sub_ps(zero, half_height)),
+                   half_height),
+        distance_y);
+
+    const auto distance_squared =
+        _mm_add_ps(_mm_mul_ps(difference_x, difference_x),
+                   _mm_mul_ps(difference_y, difference_y));
+
+    auto mask = static_cast<unsigned>(
+        _mm_movemask_ps(_mm_cmplt_ps(distance_squared, radius_squared)));
+    if (mask == 0)
+      continue;
+
+    alignas(16) float differences_x[4];
+    alignas(16) float differences_y[4];
+    _mm_store_ps(differences_x, difference_x);
+    _mm_store_ps(differences_y, difference_y);
+
+    for (; mask != 0; mask &= mask - 1)
+    {
+      const auto lane = std::countr_zero(mask);
+      add_hit(hits,
+              circle_index,
+              circle,
+              boxes.ids[i + lane],
+              differences_x[lane],
+              differences_y[lane]);
+    }
+  }
+
+  collide_scalar(circle_index, circle, boxes, i, hits);
+}
+
+__attribute__((target("avx2"))) static void
+collide_avx2(std::uint32_t              circle_index,
+             const CollisionCircle &    circle,
+             const CollisionBoxes &     boxes,
+             std::vector<CollisionHit> &hits)
+{
+  const auto center_x       = _mm256_set1_ps(circle.center_x);
+  const auto center_y       = _mm256_set1_ps(circle.center_y);
+  const auto radius_squared = _mm256_set1_ps(circle.radius * circle.radius);
+  const auto zero           = _mm256_setzero_ps();
+
+  std::size_t i = 0;
+  for (; i + 8 <= boxes.size(); i += 8)
+  {
+    const auto half_width  = _mm256_loadu_ps(&boxes.half_width[i]);
+    const auto half_height = _mm256_loadu_ps(&boxes.half_height[i]);
+    const auto distance_x =
+        _mm256_sub_ps(center_x, _mm256_loadu_ps(&boxes.center_x[i]));
+    const auto distance_y =
+        _mm256_sub_ps(center_y, _mm256_loadu_ps(&boxes.center_y[i]));
+
+    const auto difference_x = _mm256_sub_ps(
+        _mm256_min_ps(
+            _mm256_max_ps(distance_x, _mm256_sub_ps(zero, half_width)),
+            half_width),
+        distance_x);
+    const auto difference_y = _mm256_sub_ps(
+        _mm256_min_ps(
+            _mm256_max_ps(distance_y, _mm256_sub_ps(zero, half_height)),
+            half_height),
+        distance_y);
+
+    const auto distance_squared =
+        _mm256_add_ps(_mm256_mul_ps(difference_x, difference_x),
+                      _mm256_mul_ps(difference_y, difference_y));
+
+    auto mask = static_cast<unsigned>(_mm256_movemask_ps(
+        _mm256_cmp_ps(distance_squared, radius_squared, _CMP_LT_OQ)));
+    if (mask == 0)
+      continue;
+
+    alignas(32) float differences_x[8];
+    alignas(32) float differences_y[8];
+    _mm256_store_ps(differences_x, difference_x);
+    _mm256_store_ps(differences_y, difference_y);
+
+    for (; mask != 0; mask &= mask - 1)
+    {
+      const auto lane = std::countr_zero(mask);
+      add_hit(hits,
+              circle_index,
+              circle,
+              boxes.ids[i + lane],
+              differences_x[lane],
+              differences_y[lane]);
+    }
+  }
+
+  collide_scalar(circle_index, circle, boxes, i, hits);
+}
+
+#endif
+
+CollisionKernel get_best_collision_kernel()
+{
+  static const auto best_kernel = []() {
+    if (is_collision_kernel_supported(CollisionKernel::AVX2))
+      return CollisionKernel::AVX2;
+    if (is_collision_kernel_supported(CollisionKernel::SSE2))
+      return CollisionKernel::SSE2;
+    return CollisionKernel::SCALAR;
+  }();
+  return best_kernel;
+}
+
+bool is_collision_kernel_supported(CollisionKernel kernel)
+{
+  switch (kernel)
+  {
+  case CollisionKernel::SCALAR:
+    return true;
+#ifdef HAVE_X86_KERNELS
+  case CollisionKernel::SSE2:
+    return __builtin_cpu_supports("sse2");
+  case CollisionKernel::AVX2:
+    return __builtin_cpu_supports("avx2");
+#endif
+  default:
+    return false;
+  }
+}
+
+const char *get_collision_kernel_name(CollisionKernel kernel)
+{
+  switch (kernel)
+  {
+  case CollisionKernel::SCALAR:
+    return "scalar";
+  case CollisionKernel::SSE2:
+    return "SSE2";
+  case CollisionKernel::AVX2:
+    return "AVX2";
+  }
+  return "unknown";
+}
+
+std::size_t collide_circles_with_boxes(std::span<const CollisionCircle> circles,
+                                       const CollisionBoxes &           boxes,
+                                       std::vector<CollisionHit> &      hits)
+{
+  return collide_circles_with_boxes(get_best_collision_kernel(),
+                                    circles,
+                                    boxes,
+                                    hits);
+}
+
+std::size_t collide_circles_with_boxes(CollisionKernel                  kernel,
+                                       std::span<const CollisionCircle> circles,
+                                       const CollisionBoxes &           boxes,
+                                       std::vector<CollisionHit> &      hits)
+{
+  const auto hit_count = hits.size();
+
+  for (std::uint32_t i = 0; i < circles.size(); ++i)
+  {
+    switch (kernel)
+    {
+#ifdef HAVE_X86_KERNELS
+    case CollisionKernel::AVX2:
+      collide_avx2(i, circles[i], boxes, hits);
+      break;
+    case CollisionKernel::SSE2:
+      collide_sse2(i, circles[i], boxes, hits);
+      break;
+#endif
+    default:
+      collide_scalar(i, circles[i], boxes, 0, hits);
+      break;
+    }
+  }
+
+  return hits.size() - hit_count;
+}
@@ -0,0 +1,132 @@
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "cooked-texture.hpp"
+
+static std::uint64_t align_up(std::uint64_t value)
+{
+  return (value + 15) & ~std::uint64_t(15);
+}
+
+CookedTexture::CookedTexture(std::span<const unsigned char> data)
+{
+  if constexpr (std::endian::native != std::endian::little)
+  {
+    throw std::runtime_error("Cooked textures are only supported on little "
+                             "endian platforms");
+  }
+
+  CookedTextureHeader header;
+  if (data.size() < sizeof(header))
+  {
+    throw std::runtime_error("Cooked texture is truncated");
+  }
+  std::memcpy(&header, data.data(), sizeof(header));
+
+  if (std::memcmp(header.magic, COOKED_TEXTURE_MAGIC, sizeof(header.magic)) !=
+          0 ||
+      header.version != COOKED_TEXTURE_VERSION ||
+      header.format > static_cast<std::uint32_t>(Format::BC3))
+  {
+    throw std::runtime_error("Unsupported cooked texture");
+  }
+
+  format      = static_cast<Format>(header.format);
+  source_hash = header.source_hash;
+
+  const auto level_table_size =
+      static_cast<std::uint64_t>(header.level_count) *
+      sizeof(CookedTextureLevel);
+  if (level_table_size > data.size() - sizeof(header))
+  {
+    throw std::runtime_error("Cooked texture is truncated");
+  }
+
+  for (std::uint32_t i = 0; i < header.level_count; ++i)
+  {
+    CookedTextureLevel level;
+    std::memcpy(&level,
+                data.data() + sizeof(header) + i * sizeof(level),
+                sizeof(level));
+
+    if (level.offset > data.size() || level.size > data.size() - level.offset ||
+        level.size != level_size(format, level.width, level.height))
+    {
+      throw std::runtime_error("Cooked texture has a corrupt level");
+    }
+
+    levels.push_back(
+        {level.width, level.height, data.subspan(level.offset, level.size)});
+  }
+}
+
+std::size_t
+CookedTexture::level_size(Format format, unsigned width, unsigned height)
+{
+  switch (format)
+  {
+  case Format::RGB8:
+    return std::size_t(width) * height * 3;
+  case Format::RGBA8:
+    return std::size_t(width) * height * 4;
+  case Format::BC1:
+    return std::size_t((width + 3) / 4) * ((height + 3) / 4) * 8;
+  case Format::BC3:
+    return std::size_t((width + 3) / 4) * ((height + 3) / 4) * 16;
+  }
+  return 0;
+}
+
+void CookedTexture::write(const std::string &       file,
+                          Format                    format,
+                          std::uint64_t             source_hash,
+                          const std::vector<Level> &levels)
+{
+  CookedTextureHeader header{};
+  std::memcpy(header.magic, COOKED_TEXTURE_MAGIC, sizeof(header.magic));
+  header.version     = COOKED_TEXTURE_VERSION;
+  header.format      = static_cast<std::uint32_t>(format);
+  header.width       = levels.empty() ? 0 : levels[0].width;
+  header.height      = levels.empty() ? 0 : levels[0].height;
+  header.level_count = static_cast<std::uint32_t>(levels.size());
+  header.source_hash = source_hash;
+
+  std::vector<CookedTextureLevel> level_table;
+  auto                            offset = align_up(
+      sizeof(header) + levels.size() * sizeof(CookedTextureLevel));
+  for (const auto &level : levels)
+  {
+    level_table.push_back(
+        {level.width, level.height, offset, level.data.size()});
+    offset = align_up(offset + level.data.size());
+  }
+
+  std::ofstream out(file, std::ios::binary | std::ios::trunc);
+  if (!out)
+  {
+    throw std::runtime_error("Could not open \"" + file + "\" for writing");
+  }
+
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char *>(level_table.data()),
+            static_cast<std::streamsize>(level_table.size() *
+                                         sizeof(CookedTextureLevel)));
+
+  for (std::size_t i = 0; i < levels.size(); ++i)
+  {
+    static const char zeros[16] = {};
+    const auto current = static_cast<std::uint64_t>(out.tellp());
+    out.write(zeros, static_cast<std::streamsize>(level_table[i].offset -
+                                                  current));
+    out.write(reinterpret_cast<const char *>(levels[i].data.data()),
+              static_cast<std::streamsize>(levels[i].data.size()));
+  }
+
+  if (!out)
+  {
+    throw std::runtime_error("Could not write cooked texture \"" + file +
+                             "\"");
+  }
+}
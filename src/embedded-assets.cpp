@@ -0,0 +1,43 @@
+#include <algorithm>
+
+#include "embedded-assets.hpp"
+
+#ifdef BREAKTHROUGHGL_EMBED_ASSETS
+// Written by breakthroughgl_asset_embedder at build time
+#include "embedded-asset-data.hpp"
+#else
+namespace embedded_assets
+{
+inline constexpr std::array<EmbeddedFile, 0>  files{};
+inline constexpr std::array<EmbeddedLevel, 0> levels{};
+} // namespace embedded_assets
+#endif
+
+LevelData EmbeddedLevel::to_level_data() const
+{
+  // Same palette as the text level would get when loaded from a file
+  std::vector<std::uint8_t> level_tiles(tiles.begin(), tiles.end());
+  auto palette = LevelData::default_palette_for(level_tiles);
+  return LevelData(static_cast<unsigned>(rows),
+                   static_cast<unsigned>(columns),
+                   std::move(level_tiles),
+                   std::move(palette));
+}
+
+const EmbeddedFile *find_embedded_file(std::string_view path)
+{
+  const auto it = std::find_if(
+      embedded_assets::files.begin(),
+      embedded_assets::files.end(),
+      [path](const EmbeddedFile &file) { return file.path == path; });
+  return it != embedded_assets::files.end() ? &*it : nullptr;
+}
+
+const EmbeddedLevel *find_embedded_level(std::string_view path)
+{
+  const auto it = std::find_if(
+      embedded_assets::levels.begin(),
+      embedded_assets::levels.end(),
+      [path](const EmbeddedLevel &level) { return level.path == path; });
+  return it != embedded_assets::levels.end() ? &*it : nullptr;
+}
@@ -0,0 +1,470 @@
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#define HAVE_IO_URING 1
+#endif
+
+#include "file-reader.hpp"
+#include "log.hpp"
+
+static const std::string LOG_TAG = "FileReader";
+
+struct FileReader::Request
+{
+  std::string                file;
+  Callback                   callback;
+  int                        fd     = -1;
+  std::size_t                offset = 0;
+  std::vector<unsigned char> data;
+  iovec                      iov{};
+
+  ~Request()
+  {
+    if (fd != -1)
+      close(fd);
+  }
+
+  void fail(const std::string &reason)
+  {
+    callback({},
+             std::make_exception_ptr(std::runtime_error(
+                 "Could not read \"" + file + "\": " + reason)));
+  }
+
+  void complete() { callback(std::move(data), nullptr); }
+
+  /**
+   * @brief Opens the file and allocates the buffer for all of it.
+   *
+   * Blocks, only the reads afterwards go through the ring.
+   */
+  void open_file()
+  {
+    fd = open(file.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+      throw std::runtime_error("Could not open \"" + file + "\"");
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) == -1)
+      throw std::runtime_error("Could not stat \"" + file + "\"");
+
+    data.resize(static_cast<std::size_t>(file_stat.st_size));
+  }
+};
+
+#ifdef HAVE_IO_URING
+
+/**
+ * @brief Minimal io_uring instance driven through the raw system calls.
+ */
+struct FileReader::Ring
+{
+  static constexpr unsigned ENTRIES = 64;
+
+  int fd = -1;
+
+  void *      sq_mapping      = nullptr;
+  std::size_t sq_mapping_size = 0;
+  void *      cq_mapping      = nullptr;
+  std::size_t cq_mapping_size = 0;
+
+  io_uring_sqe *sqes      = nullptr;
+  std::size_t   sqes_size = 0;
+
+  unsigned *sq_head  = nullptr;
+  unsigned *sq_tail  = nullptr;
+  unsigned *sq_mask  = nullptr;
+  unsigned *sq_array = nullptr;
+
+  unsigned *     cq_head = nullptr;
+  unsigned *     cq_tail = nullptr;
+  unsigned *     cq_mask = nullptr;
+  io_uring_cqe * cqes    = nullptr;
+
+  unsigned capacity  = 0;
+  unsigned in_flight = 0;
+
+  Ring()
+  {
+    io_uring_params params{};
+    fd = static_cast<int>(syscall(__NR_io_uring_setup, ENTRIES, &params));
+    if (fd < 0)
+    {
+      throw std::runtime_error(std::string("io_uring_setup failed: ") +
+                               std::strerror(errno));
+    }
+    capacity = params.sq_entries;
+
+    sq_mapping_size =
+        params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_mapping_size =
+        params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+    // Newer kernels map both rings with a single mapping
+    const bool single_mapping = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mapping)
+    {
+      sq_mapping_size = std::max(sq_mapping_size, cq_mapping_size);
+      cq_mapping_size = 0;
+    }
+
+    sq_mapping = map(sq_mapping_size, IORING_OFF_SQ_RING);
+    cq_mapping =
+        single_mapping ? sq_mapping : map(cq_mapping_size, IORING_OFF_CQ_RING);
+
+    sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    sqes = static_cast<io_uring_sqe *>(map(sqes_size, IORING_OFF_SQES));
+
+    const auto sq = static_cast<char *>(sq_mapping);
+    sq_head       = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    sq_tail       = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sq_mask  = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sq_array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+
+    const auto cq = static_cast<char *>(cq_mapping);
+    cq_head       = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cq_tail       = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cq_mask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqes    = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+  }
+
+  ~Ring() { release(); }
+
+  void release()
+  {
+    if (sqes)
+      munmap(sqes, sqes_size);
+    if (cq_mapping && cq_mapping != sq_mapping)
+      munmap(cq_mapping, cq_mapping_size);
+    if (sq_mapping)
+      munmap(sq_mapping, sq_mapping_size);
+    if (fd >= 0)
+      close(fd);
+
+    sqes       = nullptr;
+    cq_mapping = nullptr;
+    sq_mapping = nullptr;
+    fd         = -1;
+  }
+
+  void *map(std::size_t size, off_t offset)
+  {
+    auto address = mmap(nullptr,
+                        size,
+                        PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE,
+                        fd,
+                        offset);
+    if (address == MAP_FAILED)
+    {
+      release();
+      throw std::runtime_error("Could not map io_uring");
+    }
+    return address;
+  }
+
+  /**
+   * @brief Queues a read of the rest of the request's file.
+   */
+  void prepare_read(Request &request)
+  {
+    request.iov.iov_base = request.data.data() + request.offset;
+    request.iov.iov_len  = request.data.size() - request.offset;
+
+    const auto tail  = *sq_tail;
+    const auto index = tail & *sq_mask;
+
+    auto &sqe     = sqes[index];
+    sqe           = {};
+    sqe.opcode    = IORING_OP_READV;
+    sqe.fd        = request.fd;
+    sqe.off       = request.offset;
+    sqe.addr      = reinterpret_cast<std::uint64_t>(&request.iov);
+    sqe.len       = 1;
+    sqe.user_data = reinterpret_cast<std::uint64_t>(&request);
+
+    sq_array[index] = index;
+    std::atomic_ref<unsigned>(*sq_tail).store(tail + 1,
+                                              std::memory_order_release);
+    ++in_flight;
+  }
+
+  /**
+   * @brief Submits all prepared reads and optionally waits for one
+   * completion.
+   */
+  void enter(bool wait)
+  {
+    const auto to_submit =
+        *sq_tail -
+        std::atomic_ref<unsigned>(*sq_head).load(std::memory_order_acquire);
+    const auto result = syscall(__NR_io_uring_enter,
+                                fd,
+                                to_submit,
+                                wait ? 1u : 0u,
+                                wait ? IORING_ENTER_GETEVENTS : 0u,
+                                nullptr,
+                                0);
+    if (result < 0 && errno != EINTR)
+    {
+      throw std::runtime_error(std::string("io_uring_enter failed: ") +
+                               std::strerror(errno));
+    }
+  }
+
+  /**
+   * @brief Calls handler for every available completion.
+   */
+  template <typename Handler> void reap(Handler handler)
+  {
+    auto       head = *cq_head;
+    const auto tail =
+        std::atomic_ref<unsigned>(*cq_tail).load(std::memory_order_acquire);
+
+    for (; head != tail; ++head)
+    {
+      const auto &cqe = cqes[head & *cq_mask];
+      --in_flight;
+      handler(*reinterpret_cast<Request *>(cqe.user_data), cqe.res);
+    }
+
+    std::atomic_ref<unsigned>(*cq_head).store(head, std::memory_order_release);
+  }
+};
+
+#else
+
+struct FileReader::Ring
+{
+};
+
+#endif
+
+FileReader::FileReader(ThreadPool &fallback_workers)
+    : fallback_workers(fallback_workers)
+{
+#ifdef HAVE_IO_URING
+  try
+  {
+    ring              = std::make_unique<Ring>();
+    completion_thread = std::thread(&FileReader::process_requests, this);
+    Log().i(LOG_TAG) << "Reading files through io_uring";
+    return;
+  }
+  catch (const std::runtime_error &e)
+  {
+    ring.reset();
+    Log().w(LOG_TAG) << e.what() << ", falling back to thread pool";
+  }
+#else
+  Log().i(LOG_TAG) << "Reading files on thread pool";
+#endif
+}
+
+FileReader::~FileReader()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  condition.notify_all();
+
+  if (completion_thread.joinable())
+    completion_thread.join();
+}
+
+void FileReader::read(std::string file, Callback callback)
+{
+  auto request      = std::make_unique<Request>();
+  request->file     = std::move(file);
+  request->callback = std::move(callback);
+
+  if (!ring)
+  {
+    fallback_workers.post(
+        [request = std::shared_ptr<Request>(std::move(request))]() {
+          read_blocking(*request);
+        });
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    pending_requests.push_back(std::move(request));
+  }
+  condition.notify_one();
+}
+
+std::future<std::vector<unsigned char>> FileReader::read(std::string file)
+{
+  auto promise = std::make_shared<std::promise<std::vector<unsigned char>>>();
+  auto future  = promise->get_future();
+
+  read(std::move(file),
+       [promise](std::vector<unsigned char> data, std::exception_ptr error) {
+         if (error)
+           promise->set_exception(error);
+         else
+           promise->set_value(std::move(data));
+       });
+
+  return future;
+}
+
+void FileReader::read_blocking(Request &request)
+{
+  try
+  {
+    request.open_file();
+  }
+  catch (const std::runtime_error &)
+  {
+    request.callback({}, std::current_exception());
+    return;
+  }
+
+  while (request.offset < request.data.size())
+  {
+    const auto result = pread(request.fd,
+                              request.data.data() + request.offset,
+                              request.data.size() - request.offset,
+                              static_cast<off_t>(request.offset));
+    if (result < 0 && errno == EINTR)
+      continue;
+    if (result < 0)
+    {
+      request.fail(std::strerror(errno));
+      return;
+    }
+    if (result == 0)
+    {
+      // The file shrank since it was opened
+      request.data.resize(request.offset);
+      break;
+    }
+    request.offset += static_cast<std::size_t>(result);
+  }
+
+  request.complete();
+}
+
+#ifdef HAVE_IO_URING
+
+void FileReader::process_requests()
+{
+  // Requests owned by the ring until their read completes
+  std::vector<std::unique_ptr<Request>> in_flight_requests;
+
+  const auto finish = [&in_flight_requests](Request &request) {
+    const auto it = std::find_if(in_flight_requests.begin(),
+                                 in_flight_requests.end(),
+                                 [&request](const auto &in_flight_request) {
+                                   return in_flight_request.get() == &request;
+                                 });
+    auto owned_request = std::move(*it);
+    in_flight_requests.erase(it);
+    return owned_request;
+  };
+
+  while (true)
+  {
+    std::deque<std::unique_ptr<Request>> new_requests;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      if (ring->in_flight == 0)
+      {
+        condition.wait(lock, [this]() {
+          return stopping || !pending_requests.empty();
+        });
+      }
+
+      if (stopping && pending_requests.empty() && ring->in_flight == 0)
+        return;
+
+      // Take as many requests as fit into the ring, all of them are
+      // submitted with a single system call
+      while (!pending_requests.empty() &&
+             ring->in_flight + new_requests.size() < ring->capacity)
+      {
+        new_requests.push_back(std::move(pending_requests.front()));
+        pending_requests.pop_front();
+      }
+    }
+
+    for (auto &request : new_requests)
+    {
+      try
+      {
+        request->open_file();
+      }
+      catch (const std::runtime_error &)
+      {
+        request->callback({}, std::current_exception());
+        continue;
+      }
+
+      if (request->data.empty())
+      {
+        request->complete();
+        continue;
+      }
+
+      ring->prepare_read(*request);
+      in_flight_requests.push_back(std::move(request));
+    }
+
+    if (ring->in_flight == 0)
+      continue;
+
+    ring->enter(true);
+
+    auto resubmit = false;
+    ring->reap([&](Request &request, int result) {
+      if (result == -EINTR || result == -EAGAIN)
+      {
+        ring->prepare_read(request);
+        resubmit = true;
+        return;
+      }
+
+      if (result < 0)
+      {
+        finish(request)->fail(std::strerror(-result));
+        return;
+      }
+
+      request.offset += static_cast<std::size_t>(result);
+      if (result > 0 && request.offset < request.data.size())
+      {
+        // Short read, continue where it stopped
+        ring->prepare_read(request);
+        resubmit = true;
+        return;
+      }
+
+      // A read of zero bytes means the file shrank since it was opened
+      request.data.resize(request.offset);
+      finish(request)->complete();
+    });
+
+    if (resubmit)
+      ring->enter(false);
+  }
+}
+
+#else
+
+void FileReader::process_requests() {}
+
+#endif
@@ -0,0 +1,52 @@
+#include <algorithm>
+#include <cmath>
+
+#include "frame-time-stats.hpp"
+
+void FrameTimeStats::add(double frame_time)
+{
+  const auto bucket =
+      std::min(static_cast<std::size_t>(std::max(frame_time, 0.0) /
+                                        BUCKET_WIDTH),
+               BUCKET_COUNT - 1);
+  ++buckets[bucket];
+
+  ++count;
+  sum += frame_time;
+  max = std::max(max, frame_time);
+}
+
+void FrameTimeStats::reset()
+{
+  buckets.fill(0);
+  count = 0;
+  sum   = 0.0;
+  max   = 0.0;
+}
+
+double FrameTimeStats::get_percentile(double fraction) const
+{
+  if (count == 0)
+    return 0.0;
+
+  const auto rank = static_cast<std::uint64_t>(std::ceil(fraction * count));
+
+  std::uint64_t frames = 0;
+  for (std::size_t bucket = 0; bucket < BUCKET_COUNT - 1; ++bucket)
+  {
+    frames += buckets[bucket];
+    if (frames >= rank)
+      return (bucket + 1) * BUCKET_WIDTH;
+  }
+  return max;
+}
+
+std::ostream &operator<<(std::ostream &out, const FrameTimeStats &stats)
+{
+  return out << stats.get_count() << " frames, mean "
+             << stats.get_mean() * 1000.0 << " ms, p50 "
+             << stats.get_percentile(0.5) * 1000.0 << " ms, p99 "
+             << stats.get_percentile(0.99) * 1000.0 << " ms, p99.9 "
+             << stats.get_percentile(0.999) * 1000.0 << " ms, max "
+             << stats.get_max() * 1000.0 << " ms";
+}
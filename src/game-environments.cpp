@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <latch>
+
+#include "asseration.hpp"
+#include "game-environments.hpp"
+
+GameEnvironments::GameEnvironments(std::size_t      count,
+                                   const LevelData &level_data,
+                                   std::uint64_t    seed,
+                                   ThreadPool &     workers,
+                                   float            tick_time,
+                                   unsigned         width,
+                                   unsigned         height)
+    : workers(workers),
+      tick_time(tick_time)
+{
+  simulations.reserve(count);
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    simulations.emplace_back(width, height, seed + i);
+    simulations.back().set_level(level_data);
+  }
+}
+
+void GameEnvironments::observe(std::span<float> observations) const
+{
+  ASSERT(observations.size() == simulations.size() * OBSERVATION_SIZE);
+
+  for (std::size_t i = 0; i < simulations.size(); ++i)
+    write_observation(simulations[i], &observations[i * OBSERVATION_SIZE]);
+}
+
+void GameEnvironments::step(std::span<const GameInput> actions,
+                            std::span<float>           observations,
+                            std::span<float>           rewards,
+                            std::span<std::uint8_t>    done)
+{
+  ASSERT(actions.size() == simulations.size());
+  ASSERT(observations.size() == simulations.size() * OBSERVATION_SIZE);
+  ASSERT(rewards.size() == simulations.size());
+  ASSERT(done.size() == simulations.size());
+
+  if (simulations.empty())
+    return;
+
+  // The calling thread takes a range as well instead of only waiting
+  const auto range_count =
+      std::min(workers.get_thread_count() + 1, simulations.size());
+  const auto range_begin = [this, range_count](std::size_t range) {
+    return simulations.size() * range / range_count;
+  };
+
+  std::latch finished(static_cast<std::ptrdiff_t>(range_count - 1));
+  for (std::size_t range = 1; range < range_count; ++range)
+  {
+    workers.post([&, range]() {
+      step_range(range_begin(range),
+                 range_begin(range + 1),
+                 actions,
+                 observations,
+                 rewards,
+                 done);
+      finished.count_down();
+    });
+  }
+
+  step_range(0, range_begin(1), actions, observations, rewards, done);
+  finished.wait();
+}
+
+void GameEnvironments::step_range(std::size_t                begin,
+                                  std::size_t                end,
+                                  std::span<const GameInput> actions,
+                                  std::span<float>           observations,
+                                  std::span<float>           rewards,
+                                  std::span<std::uint8_t>    done)
+{
+  for (auto i = begin; i < end; ++i)
+  {
+    auto &simulation = simulations[i];
+
+    const auto was_active = simulation.get_state() == GameState::GAME_ACTIVE;
+
+    auto input    = actions[i];
+    input.confirm = !was_active;
+    simulation.tick(tick_time, input);
+
+    const auto &events = simulation.get_events();
+    const auto  state  = simulation.get_state();
+
+    auto reward =
+        events.count(GameEvent::Type::BRICK_DESTROYED) * BRICK_REWARD +
+        events.count(GameEvent::Type::LIFE_LOST) * LIFE_LOST_REWARD;
+    if (was_active && state == GameState::GAME_WIN)
+      reward += WIN_REWARD;
+
+    rewards[i] = reward;
+    done[i]    = was_active && state != GameState::GAME_ACTIVE;
+    write_observation(simulation, &observations[i * OBSERVATION_SIZE]);
+  }
+}
+
+void GameEnvironments::write_observation(const GameSimulation &simulation,
+                                         float *               observation)
+{
+  const auto  width  = static_cast<float>(simulation.get_width());
+  const auto  height = static_cast<float>(simulation.get_height());
+  const auto &player = simulation.get_player();
+  const auto &balls  = simulation.get_balls();
+
+  const auto paddle_x    = player.position.x + player.size.x / 2.0f;
+  const auto bricks_left = simulation.get_level().get_breakable_count();
+
+  // Only the first ball is observed, multi-ball makes more of them
+  const auto ball_center   = balls.get_center(0);
+  const auto ball_velocity = balls.get_velocity(0);
+  const auto ball_stuck    = balls.has_flag(0, BallPool::STUCK);
+
+  observation[PADDLE_X]        = paddle_x / width;
+  observation[PADDLE_WIDTH]    = player.size.x / width;
+  observation[BALL_X]          = ball_center.x / width;
+  observation[BALL_Y]          = ball_center.y / height;
+  observation[BALL_VELOCITY_X] = ball_velocity.x / width;
+  observation[BALL_VELOCITY_Y] = ball_velocity.y / height;
+  observation[BALL_STUCK]      = ball_stuck ? 1.0f : 0.0f;
+  observation[LIVES]           = static_cast<float>(simulation.get_lives());
+  observation[BRICKS_LEFT]     = static_cast<float>(bricks_left);
+}
@@ -1,148 +1,123 @@
-#include <fstream>
+#include <algorithm>
 
+#include "asset-store.hpp"
+#include "embedded-assets.hpp"
 #include "game-level.hpp"
 #include "log.hpp"
-#include "resource-manager.hpp"
 
 static const std::string LOG_TAG = "GameLevel";
 
 GameLevel::GameLevel(const std::string &file,
                      unsigned           level_width,
                      unsigned           level_height)
+    : GameLevel(load_from_file(file), level_width, level_height)
 {
-  load_from_file(file, level_width, level_height);
 }
 
-GameLevel::GameLevel(GameLevel &&game_level)
+GameLevel::GameLevel(LevelData level_data,
+                     unsigned  level_width,
+                     unsigned  level_height)
+    : level_data(std::move(level_data))
 {
-  bricks = std::move(game_level.bricks);
+  if (!this->level_data.is_empty())
+    init(level_width, level_height);
 }
 
-void GameLevel::operator=(GameLevel &&game_level)
+LevelData GameLevel::load_from_file(const std::string &file)
 {
-  bricks = std::move(game_level.bricks);
+  // Embedded levels were parsed during compilation
+  if (const auto level = find_embedded_level(file))
+    return level->to_level_data();
+
+  const auto level_file = get_level_file(file);
+  Log().i(LOG_TAG) << "Load level from file: " << level_file;
+
+  const auto asset = AssetStore::read(level_file);
+  return LevelData::load(asset.data());
 }
 
-void GameLevel::load_from_file(const std::string &file,
-                               unsigned           level_width,
-                               unsigned           level_height)
+std::string GameLevel::get_level_file(const std::string &file)
 {
-  const auto real_file_path = "resources/" + file;
+  const auto binary_file = file + LEVEL_BINARY_EXTENSION;
+  return AssetStore::exists(binary_file) ? binary_file : file;
+}
 
-  Log().i(LOG_TAG) << "Load level from file: " << real_file_path;
+GameLevel::Brick GameLevel::get_brick(std::size_t cell) const
+{
+  const auto tile = level_data.get_tiles()[cell];
+  return {get_position(cell),
+          brick_size,
+          level_data.get_brick_type(tile).is_solid};
+}
 
-  unsigned                           tile_code;
-  std::string                        line;
-  std::ifstream                      fstream(real_file_path);
-  std::vector<std::vector<unsigned>> tile_data;
+void GameLevel::destroy_brick(std::size_t cell)
+{
+  if (destroyed[cell])
+    return;
 
-  if (fstream)
-  {
-    while (std::getline(fstream, line))
-    {
-      std::istringstream    sstream(line);
-      std::vector<unsigned> row;
-
-      // Read each word seperated by spaces
-      while (sstream >> tile_code)
-        row.push_back(tile_code);
-
-      tile_data.push_back(row);
-    }
-
-    if (tile_data.size() > 0)
-    {
-      this->tile_data    = tile_data;
-      this->level_width  = level_width;
-      this->level_height = level_height;
-
-      init(tile_data, level_width, level_height);
-    }
-  }
+  destroyed[cell] = true;
+  if (!level_data.get_brick_type(level_data.get_tiles()[cell]).is_solid)
+    --live_breakable_count;
 }
 
-void GameLevel::draw(std::shared_ptr<SpriteRenderer> renderer) const
+GameLevel::CellRange GameLevel::get_cells(glm::vec2 min, glm::vec2 max) const
 {
-  for (const auto &tile : bricks)
-    if (!tile.is_destroyed())
-      tile.draw(renderer);
+  CellRange range;
+  if (destroyed.empty())
+    return range;
+
+  // Cells touching the box on an edge are included, since the narrow
+  // phase counts touching as overlapping
+  const auto first = glm::floor(min / brick_size);
+  const auto last  = glm::floor(max / brick_size);
+
+  const auto clamp_index = [](float value, unsigned count) {
+    return static_cast<unsigned>(
+        std::clamp(value, 0.0f, static_cast<float>(count)));
+  };
+
+  const auto rows    = level_data.get_rows();
+  const auto columns = level_data.get_columns();
+
+  range.first_row    = clamp_index(first.y, rows);
+  range.end_row      = clamp_index(last.y + 1.0f, rows);
+  range.first_column = clamp_index(first.x, columns);
+  range.end_column   = clamp_index(last.x + 1.0f, columns);
+  return range;
 }
 
-bool GameLevel::is_completed()
+glm::vec2 GameLevel::get_position(std::size_t cell) const
 {
-  for (const auto &tile : bricks)
-    if (!tile.is_solid() && !tile.is_destroyed())
-      return false;
-  return true;
+  const auto columns = level_data.get_columns();
+  return glm::vec2(brick_size.x * (cell % columns),
+                   brick_size.y * (cell / columns));
 }
 
-void GameLevel::init(std::vector<std::vector<unsigned int>> tile_data,
-                     unsigned                               level_width,
-                     unsigned                               level_height)
+void GameLevel::init(unsigned level_width, unsigned level_height)
 {
   // Calculate dimensions
-  // Note we can index vector at [0] since this function is only called if
-  // height > 0
-  const auto height = tile_data.size();
-  const auto width  = tile_data[0].size();
+  const auto height = level_data.get_rows();
+  const auto width  = level_data.get_columns();
 
-  const auto unit_width  = level_width / static_cast<float>(width);
-  const auto unit_height = level_height / static_cast<float>(height);
+  brick_size = glm::vec2(level_width / static_cast<float>(width),
+                         level_height / static_cast<float>(height));
 
-  // Initialize level tiles based on tile_data
-  for (unsigned y = 0; y < height; ++y)
+  // Empty cells never hold a brick, so they start out destroyed
+  const auto &tiles = level_data.get_tiles();
+  initial_destroyed.resize(tiles.size());
+  for (std::size_t cell = 0; cell < tiles.size(); ++cell)
   {
-    for (unsigned x = 0; x < width; ++x)
-    {
-      // Check block type from level data (2D level array)
-      if (tile_data[y][x] == 1) // Solid
-      {
-        glm::vec2 pos(unit_width * x, unit_height * y);
-        glm::vec2 size(unit_width, unit_height);
-
-        GameObject obj(pos,
-                       size,
-                       ResourceManager::get_texture("block_solid"),
-                       true,
-                       glm::vec3(0.8f, 0.8f, 0.7f));
-
-        bricks.push_back(std::move(obj));
-      }
-      else if (tile_data[y][x] > 1) // Non-solid
-      {
-        // Now determine its color based on level data
-        glm::vec3 color = glm::vec3(1.0f); // Original: white
-        if (tile_data[y][x] == 2)
-          color = glm::vec3(0.2f, 0.6f, 1.0f);
-        else if (tile_data[y][x] == 3)
-          color = glm::vec3(0.0f, 0.7f, 0.0f);
-        else if (tile_data[y][x] == 4)
-          color = glm::vec3(0.8f, 0.8f, 0.4f);
-        else if (tile_data[y][x] == 5)
-          color = glm::vec3(1.0f, 0.5f, 0.0f);
-
-        glm::vec2 pos(unit_width * x, unit_height * y);
-        glm::vec2 size(unit_width, unit_height);
-
-        GameObject obj(pos,
-                       size,
-                       ResourceManager::get_texture("block"),
-                       false,
-                       color);
-
-        bricks.push_back(std::move(obj));
-      }
-    }
+    if (tiles[cell] == LevelData::EMPTY_TILE)
+      initial_destroyed[cell] = true;
+    else if (!level_data.get_brick_type(tiles[cell]).is_solid)
+      ++initial_breakable_count;
   }
+
+  reset();
 }
 
 void GameLevel::reset()
 {
-  for (auto &brick : bricks)
-  {
-    brick.set_destroyed(false);
-  }
-
-  if (tile_data.size() > 0)
-    init(tile_data, level_width, level_height);
+  destroyed            = initial_destroyed;
+  live_breakable_count = initial_breakable_count;
 }
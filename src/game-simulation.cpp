@@ -0,0 +1,650 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "asseration.hpp"
+#include "game-simulation.hpp"
+#include "hash.hpp"
+
+// Balls of the stress test leave the paddle at most this angle in
+// radians away from straight up
+static const float LAUNCH_ANGLE = 1.0f;
+
+static glm::vec2 rotate(const glm::vec2 vector, float angle)
+{
+  const auto cos = std::cos(angle);
+  const auto sin = std::sin(angle);
+  return glm::vec2(vector.x * cos - vector.y * sin,
+                   vector.x * sin + vector.y * cos);
+}
+
+// Hashes values field by field, stable across runs and platforms
+// unlike std::hash
+class StateHash
+{
+public:
+  // Only for types without padding
+  template <typename T> void add(const T &value)
+  {
+    unsigned char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    hash = hash_fnv1a(bytes, hash);
+  }
+
+  std::uint64_t get() const { return hash; }
+
+private:
+  std::uint64_t hash = FNV1A_OFFSET_BASIS;
+};
+
+GameSimulation::GameSimulation(unsigned      width,
+                               unsigned      height,
+                               std::uint64_t seed)
+    : width(width),
+      height(height),
+      seed(seed),
+      power_up_random(seed, RandomStream::POWER_UPS),
+      player{glm::vec2(0.0f), PLAYER_SIZE}
+{
+  balls.radius = BALL_RADIUS;
+  reset_player();
+}
+
+void GameSimulation::set_level(const LevelData &level_data)
+{
+  game_level = std::make_unique<GameLevel>(level_data, width, height / 2);
+}
+
+void GameSimulation::tick(float delta_time, const GameInput &input)
+{
+  events.clear();
+
+  player.store_previous_position();
+  balls.store_previous_positions();
+  for (std::size_t i = 0; i < power_ups.size(); ++i)
+    power_ups[i].previous_position = power_ups[i].position;
+
+  process_input(delta_time, input);
+  update(delta_time);
+}
+
+void GameSimulation::process_input(float delta_time, const GameInput &input)
+{
+  switch (state)
+  {
+  case GameState::GAME_MENU:
+  {
+    if (input.confirm && game_level)
+    {
+      state = GameState::GAME_ACTIVE;
+    }
+    break;
+  }
+
+  case GameState::GAME_WIN:
+  {
+    if (input.confirm)
+    {
+      state = GameState::GAME_MENU;
+    }
+    break;
+  }
+
+  case GameState::GAME_ACTIVE:
+  {
+    float velocity = PLAYER_VELOCITY * delta_time;
+
+    // Move playerboard and ball
+    if (input.move_left)
+    {
+      if (player.position.x >= 0.0f)
+      {
+        player.position.x -= velocity;
+        for (std::size_t i = 0; i < balls.size(); ++i)
+        {
+          if (balls.has_flag(i, BallPool::STUCK))
+            balls.position_x[i] -= velocity;
+        }
+      }
+    }
+
+    if (input.move_right)
+    {
+      if (player.position.x <= width - player.size.x)
+      {
+        player.position.x += velocity;
+        for (std::size_t i = 0; i < balls.size(); ++i)
+        {
+          if (balls.has_flag(i, BallPool::STUCK))
+            balls.position_x[i] += velocity;
+        }
+      }
+    }
+
+    // Release ball
+    if (input.release_ball)
+    {
+      balls.set_flag(BallPool::STUCK, false);
+    }
+  }
+  }
+}
+
+void GameSimulation::update(float delta_time)
+{
+  time += delta_time;
+
+  launch_balls();
+  update_balls(delta_time);
+  process_brick_events();
+  update_power_ups(delta_time);
+
+  // Reduce shake time
+  if (shake_time > 0.0f)
+    shake_time -= delta_time;
+
+  update_lost_balls();
+
+  // Check win condition
+  if (state == GameState::GAME_ACTIVE && game_level->is_completed())
+  {
+    reset_level();
+    reset_player();
+    state = GameState::GAME_WIN;
+  }
+}
+
+void GameSimulation::update_balls(float delta_time)
+{
+  // Between the level and the paddle a ball cannot hit anything, balls
+  // that stay there for the whole tick just move
+  const auto diameter = balls.radius * 2.0f;
+  const auto max_x    = width - diameter;
+  const auto min_y    = height / 2.0f;
+  const auto max_y    = player.position.y - diameter;
+  const auto is_free  = [&](float x, float y) {
+    return x > 0.0f && x < max_x && y > min_y && y < max_y;
+  };
+
+  colliding_balls.clear();
+  for (std::size_t i = 0; i < balls.size(); ++i)
+  {
+    if (balls.has_flag(i, BallPool::STUCK))
+      continue;
+
+    const auto x = balls.position_x[i] + balls.velocity_x[i] * delta_time;
+    const auto y = balls.position_y[i] + balls.velocity_y[i] * delta_time;
+    if (is_free(x, y) && is_free(balls.position_x[i], balls.position_y[i]))
+    {
+      balls.position_x[i] = x;
+      balls.position_y[i] = y;
+    }
+    else
+    {
+      colliding_balls.push_back(i);
+    }
+  }
+
+  for (const auto i : colliding_balls)
+    update_ball(i, delta_time);
+}
+
+void GameSimulation::update_ball(std::size_t index, float delta_time)
+{
+  // Move the ball from contact to contact, so no speed or frame time
+  // lets it pass through a brick
+  auto remaining_time = delta_time;
+  for (unsigned bounce = 0; bounce < MAX_BALL_BOUNCES; ++bounce)
+  {
+    const auto center = balls.get_center(index);
+    const auto motion = balls.get_velocity(index) * remaining_time;
+
+    const auto hit = find_ball_hit(center, motion);
+    if (!hit)
+    {
+      balls.set_position(index, balls.get_position(index) + motion);
+      return;
+    }
+
+    balls.set_position(index,
+                       balls.get_position(index) + motion * hit->sweep.time);
+    remaining_time *= 1.0f - hit->sweep.time;
+    resolve_ball_hit(index, *hit);
+  }
+}
+
+std::optional<BallHit> GameSimulation::find_ball_hit(const glm::vec2 center,
+                                                     const glm::vec2 motion)
+{
+  const auto             radius = balls.radius;
+  std::optional<BallHit> hit;
+
+  const auto test = [&hit](std::optional<SweepHit> sweep,
+                           BallHitTarget           target,
+                           std::size_t             cell) {
+    if (sweep && (!hit || sweep->time < hit->sweep.time))
+      hit = BallHit{*sweep, target, cell};
+  };
+
+  // Left, right and top window edges
+  test(sweep_circle_plane(center,
+                          radius,
+                          motion,
+                          glm::vec2(0.0f),
+                          glm::vec2(1.0f, 0.0f)),
+       BallHitTarget::WALL,
+       0);
+  test(sweep_circle_plane(center,
+                          radius,
+                          motion,
+                          glm::vec2(width, 0.0f),
+                          glm::vec2(-1.0f, 0.0f)),
+       BallHitTarget::WALL,
+       0);
+  test(sweep_circle_plane(center,
+                          radius,
+                          motion,
+                          glm::vec2(0.0f),
+                          glm::vec2(0.0f, 1.0f)),
+       BallHitTarget::WALL,
+       0);
+
+  test(sweep_circle_box(center,
+                        radius,
+                        motion,
+                        player.position,
+                        player.position + player.size),
+       BallHitTarget::PADDLE,
+       0);
+
+  if (!game_level)
+    return hit;
+
+  // Only test the cells the ball can touch during the motion
+  const auto cells =
+      game_level->get_cells(glm::min(center, center + motion) - radius,
+                            glm::max(center, center + motion) + radius);
+
+  brick_boxes.clear();
+  for (auto row = cells.first_row; row < cells.end_row; ++row)
+  {
+    for (auto column = cells.first_column; column < cells.end_column;
+         ++column)
+    {
+      const auto cell = game_level->get_cell(row, column);
+      if (!game_level->is_alive(cell))
+        continue;
+
+      const auto brick = game_level->get_brick(cell);
+      brick_boxes.add(brick.position.x,
+                      brick.position.y,
+                      brick.size.x,
+                      brick.size.y,
+                      static_cast<std::uint32_t>(cell));
+    }
+  }
+
+  // A circle around the whole motion touches every brick the ball can
+  // hit, so only those bricks are swept
+  const auto            middle = center + motion / 2.0f;
+  const CollisionCircle bounds{middle.x,
+                               middle.y,
+                               radius + glm::length(motion) / 2.0f};
+
+  brick_hits.clear();
+  collide_circles_with_boxes({&bounds, 1}, brick_boxes, brick_hits);
+
+  for (const auto &brick_hit : brick_hits)
+  {
+    const auto brick = game_level->get_brick(brick_hit.box_id);
+    test(sweep_circle_box(center,
+                          radius,
+                          motion,
+                          brick.position,
+                          brick.position + brick.size),
+         BallHitTarget::BRICK,
+         brick_hit.box_id);
+  }
+
+  return hit;
+}
+
+void GameSimulation::resolve_ball_hit(std::size_t index, const BallHit &hit)
+{
+  switch (hit.target)
+  {
+  case BallHitTarget::WALL:
+    balls.set_velocity(
+        index,
+        reflect_velocity(balls.get_velocity(index), hit.sweep.normal));
+    break;
+  case BallHitTarget::PADDLE:
+    bounce_off_paddle(index);
+    break;
+  case BallHitTarget::BRICK:
+  {
+    const auto brick = game_level->get_brick(hit.cell);
+
+    // destroy block if not solid
+    if (!brick.is_solid)
+    {
+      game_level->destroy_brick(hit.cell);
+      events.push({GameEvent::Type::BRICK_DESTROYED,
+                   std::nullopt,
+                   brick.position});
+    }
+    else
+    {
+      events.push({GameEvent::Type::SOLID_BRICK_HIT,
+                   std::nullopt,
+                   brick.position});
+    }
+
+    // Pass-through balls keep going through non-solid bricks
+    if (!(balls.has_flag(index, BallPool::PASS_THROUGH) && !brick.is_solid))
+    {
+      balls.set_velocity(
+          index,
+          reflect_velocity(balls.get_velocity(index), hit.sweep.normal));
+    }
+    break;
+  }
+  }
+}
+
+void GameSimulation::process_brick_events()
+{
+  for (const auto &event : events)
+  {
+    if (event.type == GameEvent::Type::BRICK_DESTROYED)
+      spawn_power_up(event.position);
+  }
+
+  if (events.count(GameEvent::Type::SOLID_BRICK_HIT) > 0)
+    shake_time = 0.05f;
+}
+
+void GameSimulation::bounce_off_paddle(std::size_t index)
+{
+  // check where it hit the board, and change velocity based on where it hit
+  // the board
+  const auto center_board =
+      player.position.x + player.size.x / 2.0f;
+  const auto distance   = balls.get_center(index).x - center_board;
+  const auto percentage = distance / (player.size.x / 2.0f);
+
+  // then move accordingly
+  const auto strength     = 2.0f;
+  const auto old_velocity = balls.get_velocity(index);
+  glm::vec2  velocity(INITIAL_BALL_VELOCITY.x * percentage * strength,
+                      old_velocity.y);
+
+  // Keep speed consistent over both axes (multiply by length of
+  // old velocity, so total strength is not changed)
+  velocity = glm::normalize(velocity) * glm::length(old_velocity);
+
+  // fix sticky paddle
+  velocity.y = -1.0f * glm::abs(velocity.y);
+  balls.set_velocity(index, velocity);
+
+  events.push({GameEvent::Type::PADDLE_HIT,
+               std::nullopt,
+               balls.get_center(index)});
+}
+
+void GameSimulation::update_lost_balls()
+{
+  // Balls that reached the bottom edge are gone, only the last one
+  // costs a life
+  for (std::size_t i = balls.size(); i-- > 0 && balls.size() > 1;)
+  {
+    if (balls.position_y[i] >= height)
+      balls.remove(i);
+  }
+
+  if (balls.position_y[0] >= height)
+  {
+    --lives_count;
+    events.push({GameEvent::Type::LIFE_LOST});
+
+    if (lives_count == 0)
+    {
+      reset_level();
+      reset_player();
+      state = GameState::GAME_MENU;
+    }
+    reset_player();
+  }
+}
+
+void GameSimulation::launch_balls()
+{
+  if (state != GameState::GAME_ACTIVE || balls.size() >= min_ball_count)
+    return;
+
+  const auto position =
+      player.position +
+      glm::vec2(player.size.x / 2.0f - balls.radius,
+                -(balls.radius * 2.0f));
+  const auto flags =
+      static_cast<std::uint8_t>(balls.flags[0] & ~BallPool::STUCK);
+  const auto speed = glm::length(INITIAL_BALL_VELOCITY);
+
+  while (balls.size() < min_ball_count)
+  {
+    // Steps of the golden ratio spread the balls evenly over the fan
+    const auto spread = std::fmod(launched_balls * 0.6180339887, 1.0);
+    const auto angle  = static_cast<float>(spread * 2.0 - 1.0) * LAUNCH_ANGLE;
+    balls.add(position, rotate(glm::vec2(0.0f, -speed), angle), flags);
+    ++launched_balls;
+  }
+}
+
+void GameSimulation::split_ball()
+{
+  // Splits the first ball in flight, or the one on the paddle
+  std::size_t source = 0;
+  for (std::size_t i = 0; i < balls.size(); ++i)
+  {
+    if (!balls.has_flag(i, BallPool::STUCK))
+    {
+      source = i;
+      break;
+    }
+  }
+
+  const auto position = balls.get_position(source);
+  const auto velocity = balls.get_velocity(source);
+  const auto flags =
+      static_cast<std::uint8_t>(balls.flags[source] & ~BallPool::STUCK);
+  for (unsigned i = 0; i < MULTI_BALL_COUNT; ++i)
+  {
+    const auto side = i % 2 == 0 ? 1.0f : -1.0f;
+    const auto step = static_cast<float>(i / 2 + 1);
+    balls.add(position,
+              rotate(velocity, side * step * MULTI_BALL_ANGLE),
+              flags);
+  }
+}
+
+bool GameSimulation::check_collision(const Transform &transform,
+                                     const glm::vec2  position,
+                                     const glm::vec2  size)
+{
+  // Collision x-axis?
+  bool collisionX = transform.position.x + transform.size.x >= position.x &&
+                    position.x + size.x >= transform.position.x;
+  // Collision y-axis?
+  bool collisionY = transform.position.y + transform.size.y >= position.y &&
+                    position.y + size.y >= transform.position.y;
+  // Collision only if on both axes
+  return collisionX && collisionY;
+}
+
+void GameSimulation::reset_level()
+{
+  ASSERT(game_level);
+  game_level->reset();
+  lives_count = lives_max;
+}
+
+void GameSimulation::reset_player()
+{
+  player.size     = PLAYER_SIZE;
+  player.position = glm::vec2(width / 2.0f - PLAYER_SIZE.x / 2.0f,
+                              height - PLAYER_SIZE.y);
+
+  balls.clear();
+  balls.add(player.position +
+                glm::vec2(PLAYER_SIZE.x / 2.0f - BALL_RADIUS,
+                          -(BALL_RADIUS * 2.0f)),
+            INITIAL_BALL_VELOCITY,
+            BallPool::STUCK);
+
+  // Moved, not simulated, so nothing to draw in between
+  player.store_previous_position();
+
+  // Effects end with the life, falling power-ups keep falling
+  power_up_effects.clear();
+  chaotic    = false;
+  confused   = false;
+  shake_time = 0.0f;
+}
+
+void GameSimulation::spawn_power_up(const glm::vec2 position)
+{
+  // A single draw picks at most one power-up per brick
+  auto draw = power_up_random.next_below(POWER_UP_SPAWN_RANGE);
+  for (std::size_t i = 0; i < POWER_UP_TYPE_COUNT; ++i)
+  {
+    const auto type   = static_cast<PowerUp::Type>(i);
+    const auto chance = get_power_up_kind(type).spawn_chance;
+    if (draw < chance)
+    {
+      power_ups.add(type, position);
+      return;
+    }
+    draw -= chance;
+  }
+}
+
+void GameSimulation::update_power_ups(float delta_time)
+{
+  for (std::size_t i = 0; i < power_ups.size();)
+  {
+    auto &power_up = power_ups[i];
+    if (check_collision(player, power_up.position, POWER_UP_SIZE))
+    {
+      activate_power_up(power_up.type);
+      events.push({GameEvent::Type::POWER_UP_COLLECTED,
+                   power_up.type,
+                   power_up.position});
+      power_ups.remove(i);
+      continue;
+    }
+
+    power_up.position += POWER_UP_VELOCITY * delta_time;
+    if (power_up.position.y >= height)
+    {
+      power_ups.remove(i);
+      continue;
+    }
+    ++i;
+  }
+
+  power_up_effects.expire(time, [this](PowerUp::Type type) {
+    end_power_up(type);
+  });
+}
+
+void GameSimulation::activate_power_up(PowerUp::Type type)
+{
+  const auto duration = get_power_up_kind(type).duration;
+  if (duration > 0.0f)
+    power_up_effects.add(type, time + duration);
+
+  switch (type)
+  {
+  case PowerUp::Type::CHAOS:
+    chaotic = true;
+    break;
+  case PowerUp::Type::CONFUSE:
+    confused = true;
+    break;
+  case PowerUp::Type::PAD_SIZE_INCREASE:
+    player.size.x += 50.0f;
+    break;
+  case PowerUp::Type::PASS_THROUGH:
+    balls.set_flag(BallPool::PASS_THROUGH, true);
+    break;
+  case PowerUp::Type::SPEED:
+    for (std::size_t i = 0; i < balls.size(); ++i)
+      balls.set_velocity(i, balls.get_velocity(i) * 1.2f);
+    break;
+  case PowerUp::Type::STICKY:
+    balls.set_flag(BallPool::STICKY, true);
+    break;
+  case PowerUp::Type::MULTI_BALL:
+    split_ball();
+    break;
+  default:
+    FAIL;
+  }
+}
+
+void GameSimulation::end_power_up(PowerUp::Type type)
+{
+  switch (type)
+  {
+  case PowerUp::Type::STICKY:
+    balls.set_flag(BallPool::STICKY, false);
+    break;
+  case PowerUp::Type::PASS_THROUGH:
+    balls.set_flag(BallPool::PASS_THROUGH, false);
+    break;
+  case PowerUp::Type::CONFUSE:
+    confused = false;
+    break;
+  case PowerUp::Type::CHAOS:
+    chaotic = false;
+    break;
+  default:
+    break;
+  }
+}
+
+std::uint64_t GameSimulation::get_checksum() const
+{
+  StateHash hash;
+  hash.add(state);
+  hash.add(lives_count);
+  hash.add(shake_time);
+  hash.add(confused);
+  hash.add(chaotic);
+
+  hash.add(player.position);
+  hash.add(player.size);
+  for (std::size_t i = 0; i < balls.size(); ++i)
+  {
+    hash.add(balls.get_position(i));
+    hash.add(balls.get_velocity(i));
+    hash.add(balls.flags[i]);
+  }
+
+  hash.add(time);
+  for (const auto &power_up : power_ups)
+  {
+    hash.add(power_up.type);
+    hash.add(power_up.position);
+  }
+  for (std::size_t i = 0; i < POWER_UP_TYPE_COUNT; ++i)
+    hash.add(power_up_effects.get_count(static_cast<PowerUp::Type>(i)));
+
+  if (game_level)
+  {
+    for (std::size_t cell = 0; cell < game_level->get_cell_count(); ++cell)
+      hash.add(game_level->is_alive(cell));
+  }
+
+  return hash.get();
+}
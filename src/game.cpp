@@ -6,214 +6,395 @@
 
 static const std::string LOG_TAG = "Game";
 
-Game::Game(unsigned width, unsigned height)
+// Time per frame spent on GL and AL uploads while loading
+static const auto UPLOAD_BUDGET = std::chrono::milliseconds(4);
+
+static const std::vector<std::string> LEVEL_FILES = {"levels/one.lvl",
+                                                     "levels/two.lvl",
+                                                     "levels/three.lvl",
+                                                     "levels/four.lvl"};
+
+// Not part of the repository, the game plays without it
+static const std::string MUSIC_FILE = "music/breakout.wav";
+
+// Where the music was loaded from before it was streamed
+static const std::string OLD_MUSIC_FILE = "audio/breakout.wav";
+
+// Sounds of a higher priority steal voices from the others
+static const unsigned BRICK_SOUND_PRIORITY    = 0;
+static const unsigned PADDLE_SOUND_PRIORITY   = 1;
+static const unsigned POWER_UP_SOUND_PRIORITY = 2;
+
+static std::optional<Replay> load_replay(const std::string &file)
+{
+  if (file.empty())
+    return std::nullopt;
+
+  auto replay = Replay::load(file);
+  Log().i(LOG_TAG) << "Loaded replay \"" << file << "\" with "
+                   << replay.get_tick_count() << " ticks";
+  return replay;
+}
+
+Game::Game(unsigned width, unsigned height, const GameOptions &options)
     : Window("Breaktrough", width, height),
-      game_state(GameState::GAME_MENU)
+      options(options),
+      replay(load_replay(options.replay_file)),
+      tick_time(replay ? replay->get_tick_time() : 1.0f / options.tick_rate),
+      simulation(replay ? replay->get_width() : width,
+                 replay ? replay->get_height() : height,
+                 replay ? replay->get_seed()
+                        : options.seed.value_or(Random::make_seed()))
 {
+  if (replay && replay->get_tick_count() > 0)
+  {
+    replay_player = std::make_unique<ReplayPlayer>(*replay);
+  }
+  else if (!options.record_file.empty())
+  {
+    recording = std::make_unique<Replay>(width,
+                                         height,
+                                         tick_time,
+                                         simulation.get_seed());
+  }
+
+  if (options.auto_pilot)
+  {
+    auto_pilot =
+        std::make_unique<AutoPilot>(*options.auto_pilot, simulation.get_seed());
+  }
+
+  simulation.set_min_ball_count(options.ball_count);
+
+  Log().i(LOG_TAG) << "Seed " << simulation.get_seed();
+
   init();
 }
 
 Game::~Game()
 {
+  // Loads in flight still write into the game
+  while (loading.is_valid() && !loading.is_done())
+    upload_queue.drain(UPLOAD_BUDGET);
+
+  write_recording();
+
+  if (frame_stats.get_count() > 0)
+    Log().i(LOG_TAG) << "Frame times: " << frame_stats;
+
   // Delete audio sources before audio buffers
-  audio_source_solid.reset();
-  audio_source_breakout.reset();
-  audio_source_bleep.reset();
-  audio_source_powerup.reset();
-  audio_source_nonsolid.reset();
+  music.reset();
+  sound_thread.reset();
 
   ResourceManager::clear();
 }
 
 void Game::init()
 {
-  load_shaders();
+  load_start_time = get_time();
+
+  // Runs until the first read is handed to the workers, so the first
+  // frame with the loading screen is not delayed
+  loading = load();
+  loading.start();
+}
+
+Task<void> Game::load()
+{
+  const LoadContext context{loader_workers, upload_queue, file_reader};
+
+  std::vector<Glyph> glyphs;
+
+  // Only lists the levels and starts reading the first ones
+  init_levels();
+
+  std::vector<Task<void>> loads;
+  load_shaders(context, loads);
+  load_textures(context, loads);
+  load_audio(context, loads);
+  loads.push_back(rasterize_font(context, glyphs));
+
+  load_count = loads.size();
+  co_await when_all(std::move(loads));
+
+  // All resources are uploaded, wire up the game on the main thread
   configure_shaders();
   init_sprite_renderer();
-  load_textures();
   init_particle_generator();
-  load_levels();
-  configure_game_objects();
   init_post_processor();
-  load_audio();
   configure_audio();
-  init_text_renderer();
+  init_text_renderer(glyphs);
 
-  audio_source_breakout->play();
+  Log().i(LOG_TAG) << "Loaded " << load_count << " resources in "
+                   << (get_time() - load_start_time) * 1000.0 << " ms using "
+                   << loader_workers.get_thread_count() << " workers";
 }
 
-void Game::draw()
+template <typename T> Task<void> Game::track_load(Task<T> task, T *result)
+{
+  auto value = co_await task;
+  if (result)
+    *result = value;
+  ++loaded_count;
+}
+
+Task<void> Game::rasterize_font(LoadContext context, std::vector<Glyph> &glyphs)
 {
-  process_input(delta_time);
-  update(delta_time);
-  render();
+  const auto font_asset =
+      co_await AssetStore::read_async(context.files, "fonts/ocraext.ttf");
+
+  co_await context.workers.schedule();
+  auto rasterized_glyphs = TextRenderer::rasterize(font_asset, 24);
+
+  co_await context.uploads.schedule();
+  glyphs = std::move(rasterized_glyphs);
+  ++loaded_count;
 }
 
-void Game::process_input(float delta_time)
+void Game::update_loading()
 {
-  switch (game_state)
+  upload_queue.drain(UPLOAD_BUDGET);
+
+  render_loading_screen();
+
+  if (loading.is_done())
   {
-  case GameState::GAME_MENU:
+    // Rethrows errors of the load
+    loading.get();
+    loaded = true;
+  }
+}
+
+void Game::render_loading_screen()
+{
+  // Only clears, so it works before any resource is loaded
+  renderer->clear_color(0.0f, 0.0f, 0.0f, 1.0f);
+  renderer->clear(GL_COLOR_BUFFER_BIT);
+
+  const auto progress =
+      load_count > 0 ? static_cast<float>(loaded_count) / load_count : 0.0f;
+
+  const auto bar_width  = window_width / 2;
+  const auto bar_height = 8;
+  const auto bar_x      = (window_width - bar_width) / 2;
+  const auto bar_y      = (window_height - bar_height) / 2;
+
+  renderer->set_scissor(bar_x, bar_y, bar_width, bar_height);
+  renderer->clear_color(0.2f, 0.2f, 0.2f, 1.0f);
+  renderer->clear(GL_COLOR_BUFFER_BIT);
+
+  renderer->set_scissor(bar_x,
+                        bar_y,
+                        static_cast<std::size_t>(bar_width * progress),
+                        bar_height);
+  renderer->clear_color(1.0f, 1.0f, 1.0f, 1.0f);
+  renderer->clear(GL_COLOR_BUFFER_BIT);
+
+  renderer->disable_scissor();
+}
+
+void Game::draw()
+{
+  if (!loaded)
   {
-    if (get_key(GLFW_KEY_ENTER))
-    {
-      game_state = GameState::GAME_ACTIVE;
-    }
+    update_loading();
+    return;
+  }
 
-    if (get_key(GLFW_KEY_W))
-    {
-      level = (level + 1) % game_levels.size();
-    }
+  update_frame_stats();
 
-    if (get_key(GLFW_KEY_S))
-    {
-      if (level > 0)
-        --level;
-      else
-        level = game_levels.size() - 1;
-    }
-    break;
+  const auto elapsed_time = get_time() - load_start_time;
+  if (options.run_time > 0.0 && elapsed_time >= options.run_time)
+  {
+    Log().i(LOG_TAG) << "Run time of " << options.run_time << " s is over";
+    set_should_close(true);
   }
 
-  case GameState::GAME_WIN:
+  if (replay_player && options.fast_forward)
   {
-    if (get_key(GLFW_KEY_ENTER))
+    // Ticks for most of the frame and only draws the last tick
+    const auto end_time = get_time() + FAST_FORWARD_TIME;
+    while (replay_player && get_time() < end_time)
+      tick();
+    accumulated_time = tick_time;
+  }
+  else
+  {
+    // The simulation runs in fixed ticks independent of the frame rate,
+    // the objects are drawn between their positions of the last two
+    // ticks
+    accumulated_time +=
+        std::min(static_cast<float>(delta_time), MAX_FRAME_TIME);
+    while (accumulated_time >= tick_time)
     {
-      game_state = GameState::GAME_MENU;
+      tick();
+      accumulated_time -= tick_time;
     }
-    break;
   }
 
-  case GameState::GAME_ACTIVE:
+  render(accumulated_time / tick_time);
+}
+
+void Game::tick()
+{
+  if (replay_player)
   {
-    float velocity = PLAYER_VELOCITY * delta_time;
+    if (replay_player->tick_simulation(simulation))
+      update_brick_styles(simulation.get_level().get_level_data());
 
-    // Move playerboard and ball
-    if (get_key(GLFW_KEY_A))
-    {
-      const auto player_position_x = player->get_position().x;
-      if (player_position_x >= 0.0f)
-      {
-        const auto player_position_y = player->get_position().y;
-        player->set_position(
-            glm::vec2(player_position_x - velocity, player_position_y));
-        if (ball->is_stuck())
-        {
-          const auto ball_pos = ball->get_position();
-          ball->set_position(glm::vec2(ball_pos.x - velocity, ball_pos.y));
-        }
-      }
-    }
+    if (replay_player->is_done())
+      finish_replay();
+  }
+  else
+  {
+    update_game_level(false);
 
-    if (get_key(GLFW_KEY_D))
-    {
-      const auto player_position_x = player->get_position().x;
-      if (player_position_x <= window_width - player->get_size().x)
-      {
-        const auto player_position_y = player->get_position().y;
-        player->set_position(
-            glm::vec2(player_position_x + velocity, player_position_y));
-        if (ball->is_stuck())
-        {
-          const auto ball_pos = ball->get_position();
-          ball->set_position(glm::vec2(ball_pos.x + velocity, ball_pos.y));
-        }
-      }
-    }
+    const auto input = process_input();
+    if (recording)
+      recording->add_tick(input);
 
-    // Release ball
-    if (get_key(GLFW_KEY_SPACE))
-    {
-      ball->set_stuck(false);
-    }
+    simulation.tick(tick_time, input);
   }
-  default:;
+
+  play_sounds(simulation.get_events());
+
+  const auto &balls = simulation.get_balls();
+  for (std::size_t i = 0; i < std::min(balls.size(), TRAILED_BALL_COUNT); ++i)
+  {
+    particle_generator->spawn(balls.get_position(i),
+                              balls.get_velocity(i),
+                              2,
+                              glm::vec2(balls.radius / 2.0f));
   }
+  particle_generator->update(tick_time);
 }
 
-void Game::update(float delta_time)
+GameInput Game::process_input()
 {
-  update_audio();
-  ball->move(delta_time, window_width);
-  update_collisions();
-  particle_generator->update(delta_time,
-                             *ball,
-                             2,
-                             glm::vec2(ball->get_radius() / 2.0f));
-
-  update_power_ups(delta_time);
-
-  // Reduce shake time
-  if (shake_time > 0.0f)
+  if (auto_pilot)
   {
-    shake_time -= delta_time;
-    if (shake_time <= 0.0f)
+    // Starts the selected level like ENTER would and moves on from
+    // levels that failed to load
+    if (simulation.get_state() == GameState::GAME_MENU &&
+        !update_game_level(true))
     {
-      post_processor->set_shake(false);
+      select_level((level + 1) % level_catalog.size());
+      return GameInput();
     }
+    return auto_pilot->get_input(simulation);
   }
 
-  // Did ball reach bottom edge?
-  if (ball->get_position().y >= window_height)
+  GameInput input;
+
+  switch (simulation.get_state())
+  {
+  case GameState::GAME_MENU:
   {
-    --lives_count;
+    if (get_key(GLFW_KEY_ENTER))
+    {
+      // Only waits if the level was selected in this very frame, a
+      // level that failed to load is not started
+      input.confirm = update_game_level(true);
+    }
 
-    if (lives_count == 0)
+    if (get_key(GLFW_KEY_W))
     {
-      reset_level();
-      reset_player();
-      game_state = GameState::GAME_MENU;
+      select_level((level + 1) % level_catalog.size());
     }
-    reset_player();
+
+    if (get_key(GLFW_KEY_S))
+    {
+      if (level > 0)
+        select_level(level - 1);
+      else
+        select_level(level_catalog.size() - 1);
+    }
+    break;
   }
 
-  // Check win condition
-  if (game_state == GameState::GAME_ACTIVE && game_levels[level].is_completed())
+  case GameState::GAME_WIN:
   {
-    reset_level();
-    reset_player();
-    game_state = GameState::GAME_WIN;
+    input.confirm = get_key(GLFW_KEY_ENTER);
+    break;
   }
-}
 
-void Game::render()
-{
-  if (game_state == GameState::GAME_ACTIVE ||
-      game_state == GameState::GAME_MENU || game_state == GameState::GAME_WIN)
+  case GameState::GAME_ACTIVE:
   {
-    post_processor->begin_render();
-    {
-      // Draw background
-      sprite_renderer->draw_sprite(ResourceManager::get_texture("background"),
-                                   glm::vec2(0.0f, 0.0f),
-                                   glm::vec2(window_width, window_height),
-                                   0.0f);
-
-      // Draw level
-      game_levels[level].draw(sprite_renderer);
+    input.move_left    = get_key(GLFW_KEY_A);
+    input.move_right   = get_key(GLFW_KEY_D);
+    input.release_ball = get_key(GLFW_KEY_SPACE);
+    break;
+  }
+  }
 
-      // Draw player
-      player->draw(sprite_renderer);
+  return input;
+}
 
-      // Draw power ups
-      for (auto &power_up : power_ups)
-        if (!power_up.is_destroyed())
-          power_up.draw(sprite_renderer);
+void Game::play_sounds(const GameEvents &events)
+{
+  // A sound plays once per tick, however often its event happened
+  if (events.count(GameEvent::Type::POWER_UP_COLLECTED) > 0)
+    play_sound(sound_powerup, POWER_UP_SOUND_PRIORITY);
+  if (events.count(GameEvent::Type::PADDLE_HIT) > 0)
+    play_sound(sound_bleep, PADDLE_SOUND_PRIORITY);
+  if (events.count(GameEvent::Type::SOLID_BRICK_HIT) > 0)
+    play_sound(sound_solid, BRICK_SOUND_PRIORITY);
+  if (events.count(GameEvent::Type::BRICK_DESTROYED) > 0)
+    play_sound(sound_nonsolid, BRICK_SOUND_PRIORITY);
+}
 
-      particle_generator->draw();
+void Game::play_sound(AudioHandle sound, unsigned priority)
+{
+  sound_thread->play(ResourceManager::get_audio(sound), priority, get_time());
+}
 
-      // Draw ball
-      ball->draw(sprite_renderer);
+void Game::render(float alpha)
+{
+  post_processor->set_shake(simulation.is_shaking());
+  post_processor->set_confuse(simulation.is_confused());
+  post_processor->set_chaos(simulation.is_chaotic());
+
+  post_processor->begin_render();
+  {
+    // Draw background
+    sprite_renderer->draw_sprite(texture_background,
+                                 glm::vec2(0.0f, 0.0f),
+                                 glm::vec2(window_width, window_height),
+                                 0.0f);
+
+    // Draw level, the previous one stays until the selection loaded
+    if (simulation.has_level())
+      draw_level(simulation.get_level());
+
+    // Draw player
+    const auto &player = simulation.get_player();
+    sprite_renderer->draw_sprite(texture_paddle,
+                                 player.get_interpolated_position(alpha),
+                                 player.size);
+
+    // Draw power ups
+    for (const auto &power_up : simulation.get_power_ups())
+    {
+      sprite_renderer->draw_sprite(get_power_up_texture(power_up.type),
+                                   power_up.get_interpolated_position(alpha),
+                                   POWER_UP_SIZE,
+                                   0.0f,
+                                   get_power_up_kind(power_up.type).color);
     }
-    post_processor->end_render();
-    post_processor->render(static_cast<float>(get_time()));
 
-    text_renderer->render_text("Lives: " + std::to_string(lives_count),
-                               5.0f,
-                               5.0f,
-                               1.0f);
+    particle_generator->draw();
+
+    draw_balls(simulation.get_balls(), alpha);
   }
+  post_processor->end_render();
+  post_processor->render(static_cast<float>(get_time()));
 
+  text_renderer->render_text("Lives: " + std::to_string(simulation.get_lives()),
+                             5.0f,
+                             5.0f,
+                             1.0f);
+
+  const auto game_state = simulation.get_state();
   if (game_state == GameState::GAME_MENU)
   {
     text_renderer->render_text("Press ENTER to start",
@@ -224,6 +405,14 @@ void Game::render()
                                340.0f,
                                window_height / 2 + 45.0f,
                                1.5f);
+
+    if (level_catalog.has_failed(level))
+    {
+      text_renderer->render_text("Level could not be loaded",
+                                 355.0f,
+                                 window_height / 2 + 75.0f,
+                                 1.5f);
+    }
   }
 
   if (game_state == GameState::GAME_WIN)
@@ -241,369 +430,289 @@ void Game::render()
   }
 }
 
-  bool Game::run()
+void Game::draw_level(const GameLevel &game_level)
+{
+  for (std::size_t cell = 0; cell < game_level.get_cell_count(); ++cell)
   {
-    show();
-    return true;
+    if (!game_level.is_alive(cell))
+      continue;
+
+    const auto  brick = game_level.get_brick(cell);
+    const auto &style = brick_styles[game_level.get_tile(cell)];
+    sprite_renderer->draw_sprite(style.texture,
+                                 brick.position,
+                                 brick.size,
+                                 0.0f,
+                                 style.color);
   }
+}
 
-  void Game::load_textures()
+void Game::draw_balls(const BallPool &balls, float alpha)
+{
+  const glm::vec2 size(balls.radius * 2.0f);
+  for (std::size_t i = 0; i < balls.size(); ++i)
   {
-    ResourceManager::load_texture("textures/background.jpg",
-                                  false,
-                                  "background");
-    ResourceManager::load_texture("textures/awesomeface.png", true, "face");
-    ResourceManager::load_texture("textures/block.png", false, "block");
-    ResourceManager::load_texture("textures/block_solid.png",
-                                  false,
-                                  "block_solid");
-    ResourceManager::load_texture("textures/paddle.png", true, "paddle");
-    ResourceManager::load_texture("textures/particle.png", true, "particle");
-    texture_speed = ResourceManager::load_texture("textures/powerup_speed.png",
-                                                  true,
-                                                  "powerup_speed");
-    texture_confuse =
-        ResourceManager::load_texture("textures/powerup_confuse.png",
-                                      true,
-                                      "powerup_confuse");
-    texture_increase =
-        ResourceManager::load_texture("textures/powerup_increase.png",
-                                      true,
-                                      "powerup_increase");
-
-    texture_passthrough =
-        ResourceManager::load_texture("textures/powerup_passthrough.png",
-                                      true,
-                                      "powerup_passthrough");
+    auto color = glm::vec3(1.0f);
+    if (balls.has_flag(i, BallPool::PASS_THROUGH))
+      color = glm::vec3(1.0f, 0.5f, 0.5f);
+    else if (balls.has_flag(i, BallPool::STICKY))
+      color = glm::vec3(1.0f, 0.5f, 1.0f);
 
-    texture_chaos = ResourceManager::load_texture("textures/powerup_chaos.png",
-                                                  true,
-                                                  "powerup_chaos");
+    sprite_renderer->draw_sprite(texture_face,
+                                 balls.get_interpolated_position(i, alpha),
+                                 size,
+                                 0.0f,
+                                 color);
+  }
+}
 
-    texture_sticky = ResourceManager::load_texture("textures/powerup_chaos.png",
-                                                   true,
-                                                   "powerup_sticky");
+void Game::finish_replay()
+{
+  if (simulation.get_checksum() == replay->get_checksum())
+  {
+    Log().i(LOG_TAG) << "Replay reproduced after "
+                     << replay_player->get_tick() << " ticks";
+  }
+  else
+  {
+    Log().e(LOG_TAG) << "Replay diverged, the state after "
+                     << replay_player->get_tick()
+                     << " ticks differs from the recording";
   }
 
-  void Game::load_shaders()
+  if (options.fast_forward)
   {
-    ResourceManager::load_shader("shaders/sprite/sprite.vert",
-                                 "shaders/sprite/sprite.frag",
-                                 "sprite");
+    sound_thread->stop();
+    sound_thread->set_gain(1.0f);
+  }
 
-    ResourceManager::load_shader("shaders/particle/particle.vert",
-                                 "shaders/particle/particle.frag",
-                                 "particle");
+  replay_player.reset();
+}
 
-    ResourceManager::load_shader("shaders/post-processing/post-processing.vert",
-                                 "shaders/post-processing/post-processing.frag",
-                                 "post-processing");
+void Game::write_recording()
+{
+  if (!recording)
+    return;
 
-    ResourceManager::load_shader("shaders/text/text.vert",
-                                 "shaders/text/text.frag",
-                                 "text");
+  recording->set_checksum(simulation.get_checksum());
+  try
+  {
+    recording->write(options.record_file);
+    Log().i(LOG_TAG) << "Recorded " << recording->get_tick_count()
+                     << " ticks into \"" << options.record_file << "\"";
   }
-
-  void Game::configure_shaders()
+  catch (const std::runtime_error &error)
   {
-    const auto projection_matrix = glm::ortho(0.0f,
-                                              static_cast<float>(window_width),
-                                              static_cast<float>(window_height),
-                                              0.0f,
-                                              -1.0f,
-                                              1.0f);
-
-    auto shader = ResourceManager::get_shader("sprite");
-    shader->bind();
-    shader->set_uniform("image", 0);
-    shader->set_uniform("projection_matrix", projection_matrix);
-    shader->unbind();
-
-    shader = ResourceManager::get_shader("particle");
-    shader->bind();
-    shader->set_uniform("sprite", 0);
-    shader->set_uniform("projection_matrix", projection_matrix);
-    shader->unbind();
+    Log().e(LOG_TAG) << error.what();
   }
+}
 
-  void Game::init_sprite_renderer()
+void Game::update_frame_stats()
+{
+  // The first frame after loading also measured the loading
+  const auto now = get_time();
+  if (next_frame_stats_time == 0.0)
   {
-    sprite_renderer =
-        std::make_shared<SpriteRenderer>(renderer,
-                                         ResourceManager::get_shader("sprite"));
+    next_frame_stats_time = now + FRAME_STATS_INTERVAL;
+    return;
   }
 
-  void Game::load_levels()
+  frame_stats.add(delta_time);
+  interval_frame_stats.add(delta_time);
+
+  if (now >= next_frame_stats_time)
   {
-    GameLevel level1("levels/one.lvl", window_width, window_height / 2);
-    GameLevel level2("levels/two.lvl", window_width, window_height / 2);
-    GameLevel level3("levels/three.lvl", window_width, window_height / 2);
-    GameLevel level4("levels/four.lvl", window_width, window_height / 2);
+    Log().i(LOG_TAG) << "Frame times: " << interval_frame_stats << ", "
+                     << sound_thread->get_peak_count() << " of "
+                     << sound_thread->get_voice_count()
+                     << " sound voices at most";
+    interval_frame_stats.reset();
+    sound_thread->reset_peak_count();
+    next_frame_stats_time = now + FRAME_STATS_INTERVAL;
+  }
+}
 
-    game_levels.push_back(std::move(level1));
-    game_levels.push_back(std::move(level2));
-    game_levels.push_back(std::move(level3));
-    game_levels.push_back(std::move(level4));
+TextureHandle Game::get_power_up_texture(PowerUp::Type type) const
+{
+  switch (type)
+  {
+  case PowerUp::Type::SPEED:
+    return texture_speed;
+  case PowerUp::Type::STICKY:
+    return texture_sticky;
+  case PowerUp::Type::PASS_THROUGH:
+    return texture_passthrough;
+  case PowerUp::Type::PAD_SIZE_INCREASE:
+    return texture_increase;
+  case PowerUp::Type::CONFUSE:
+    return texture_confuse;
+  case PowerUp::Type::CHAOS:
+    return texture_chaos;
+  case PowerUp::Type::MULTI_BALL:
+    // Tinted differently than the pad size increase
+    return texture_increase;
+  }
+  FAIL;
+  return {};
+}
 
-    level = 0;
+  bool Game::run()
+  {
+    show();
+    return true;
   }
 
-  void Game::configure_game_objects()
+  void Game::load_textures(LoadContext context, std::vector<Task<void>> & loads)
   {
-    const auto player_pos =
-        glm::vec2(window_width / 2.0f - PLAYER_SIZE.x / 2.0f,
-                  window_height - PLAYER_SIZE.y);
+    const auto texture = [&](const std::string &file,
+                             bool               alpha,
+                             const std::string &name,
+                             TextureHandle *    handle = nullptr) {
+      loads.push_back(track_load(
+          ResourceManager::load_texture_async(context, file, alpha, name),
+          handle));
+    };
 
-    player =
-        std::make_unique<GameObject>(player_pos,
-                                     PLAYER_SIZE,
-                                     ResourceManager::get_texture("paddle"));
+    texture("textures/background.jpg",
+            false,
+            "background",
+            &texture_background);
+    texture("textures/awesomeface.png", true, "face", &texture_face);
+    texture("textures/block.png", false, "block", &texture_block);
+    texture("textures/block_solid.png",
+            false,
+            "block_solid",
+            &texture_block_solid);
+    texture("textures/paddle.png", true, "paddle", &texture_paddle);
+    texture("textures/particle.png", true, "particle");
+    texture("textures/powerup_speed.png",
+            true,
+            "powerup_speed",
+            &texture_speed);
+    texture("textures/powerup_confuse.png",
+            true,
+            "powerup_confuse",
+            &texture_confuse);
+    texture("textures/powerup_increase.png",
+            true,
+            "powerup_increase",
+            &texture_increase);
+    texture("textures/powerup_passthrough.png",
+            true,
+            "powerup_passthrough",
+            &texture_passthrough);
+    texture("textures/powerup_chaos.png",
+            true,
+            "powerup_chaos",
+            &texture_chaos);
+    texture("textures/powerup_chaos.png",
+            true,
+            "powerup_sticky",
+            &texture_sticky);
+  }
+
+  void Game::load_shaders(LoadContext context, std::vector<Task<void>> & loads)
+  {
+    const auto shader = [&](const std::string &vertex_shader_file,
+                            const std::string &fragment_shader_file,
+                            const std::string &name) {
+      loads.push_back(
+          track_load(ResourceManager::load_shader_async(context,
+                                                        vertex_shader_file,
+                                                        fragment_shader_file,
+                                                        name)));
+    };
+
+    shader("shaders/sprite/sprite.vert",
+           "shaders/sprite/sprite.frag",
+           "sprite");
 
-    const auto ball_pos =
-        player_pos +
-        glm::vec2(PLAYER_SIZE.x / 2.0f - BALL_RADIUS, -BALL_RADIUS * 2.0f);
+    shader("shaders/particle/particle.vert",
+           "shaders/particle/particle.frag",
+           "particle");
 
-    ball = std::make_unique<BallObject>(ball_pos,
-                                        BALL_RADIUS,
-                                        INITIAL_BALL_VELOCITY,
-                                        ResourceManager::get_texture("face"));
+    shader("shaders/post-processing/post-processing.vert",
+           "shaders/post-processing/post-processing.frag",
+           "post-processing");
+
+    shader("shaders/text/text.vert", "shaders/text/text.frag", "text");
   }
 
-  void Game::update_collisions()
+  void Game::configure_shaders()
   {
-    for (auto &box : this->game_levels[level].get_bricks())
-    {
-      if (!box.is_destroyed())
-      {
-        const auto collision = check_collision(*ball, box);
-        if (collision.is_collision)
-        {
-          // destroy block if not solid
-          if (!box.is_solid())
-          {
-            box.set_destroyed(true);
-            spawn_power_ups(box);
-            audio_source_nonsolid->play();
-          }
-          else
-          {
-            shake_time = 0.05f;
-            post_processor->set_shake(true);
-            audio_source_solid->play();
-          }
-
-          // collision resolution
-          const auto dir         = collision.direction;
-          const auto diff_vector = collision.difference_center_closest_point;
-          // horizontal collision, don't do collision resolution on
-          // non-solid bricks if pass-through is activated
-          if (!(ball->is_pass_through() && !box.is_solid()))
-          {
-            if (dir == Direction::LEFT || dir == Direction::RIGHT)
-            {
-              const auto ball_velocity = ball->get_velocity();
-              // reverse horizontal velocity
-              ball->set_velocity(glm::vec2(-ball_velocity.x, ball_velocity.y));
-              // relocate
-              const auto penetration =
-                  ball->get_radius() - std::abs(diff_vector.x);
-              const auto ball_position = ball->get_position();
-              if (dir == Direction::LEFT)
-              {
-                // move ball to right
-                ball->set_position(
-                    glm::vec2(ball_position.x + penetration, ball_position.y));
-              }
-              else
-              {
-                // move ball to left;
-                ball->set_position(
-                    glm::vec2(ball_position.x - penetration, ball_position.y));
-              }
-            }
-            else // vertical collision
-            {
-              const auto ball_velocity = ball->get_velocity();
-              ball->set_velocity(glm::vec2(ball_velocity.x, -ball_velocity.y));
-              // relocate
-              const auto penetration =
-                  ball->get_radius() - std::abs(diff_vector.y);
-              const auto ball_position = ball->get_position();
-              if (dir == Direction::UP)
-              {
-                // move ball back up
-                ball->set_position(
-                    glm::vec2(ball_position.x, ball_position.y - penetration));
-              }
-
-              else
-              {
-                // move ball back down
-                ball->set_position(
-                    glm::vec2(ball_position.x, ball_position.y + penetration));
-              }
-            }
-          }
-        }
-      }
-    }
-
-    // also check collisions on PowerUps and if so, activate them
-    for (auto &power_up : power_ups)
-    {
-      if (!power_up.is_destroyed())
-      {
-        // first check if powerup passed bottom edge, if so: keep as
-        // inactive and destroy
-        if (power_up.get_position().y >= window_height)
-          power_up.set_destroyed(true);
-
-        if (check_collision(*player, power_up))
-        {
-          // collided with player, now activate powerup
-          activate_power_up(power_up);
-          power_up.set_destroyed(true);
-          power_up.set_activated(true);
-          audio_source_powerup->play();
-        }
-      }
-    }
+    const auto projection_matrix = glm::ortho(0.0f,
+                                              static_cast<float>(window_width),
+                                              static_cast<float>(window_height),
+                                              0.0f,
+                                              -1.0f,
+                                              1.0f);
 
-    // check collisions for player pad (unless stuck)
-    const auto result = check_collision(*ball, *player);
-    if (!ball->is_stuck() && result.is_collision)
-    {
-      // check where it hit the board, and change velocity based on where it hit
-      // the board
-      const auto center_board =
-          player->get_position().x + player->get_size().x / 2.0f;
-      const auto distance =
-          (ball->get_position().x + ball->get_radius()) - center_board;
-      const auto percentage = distance / (player->get_size().x / 2.0f);
-
-      // then move accordingly
-      const auto strength     = 2.0f;
-      const auto old_velocity = ball->get_velocity();
-      ball->set_velocity(
-          glm::vec2(INITIAL_BALL_VELOCITY.x * percentage * strength,
-                    old_velocity.y));
-
-      // Keep speed consistent over both axes (multiply by length of
-      // old velocity, so total strength is not changed)
-      ball->set_velocity(glm::normalize(ball->get_velocity()) *
-                         glm::length(old_velocity));
-
-      // fix sticky paddle
-      ball->set_velocity(glm::vec2(ball->get_velocity().x,
-                                   -1.0f * glm::abs(ball->get_velocity().y)));
-
-      audio_source_bleep->play();
-    }
+    auto &sprite_shader =
+        ResourceManager::get_shader(ResourceManager::find_shader("sprite"));
+    sprite_shader.bind();
+    sprite_shader.set_uniform("image", 0);
+    sprite_shader.set_uniform("projection_matrix", projection_matrix);
+    sprite_shader.unbind();
 
-    for (auto &power_up : power_ups)
-    {
-      if (!power_up.is_destroyed())
-      {
-        if (power_up.get_position().y >= window_height)
-          power_up.set_destroyed(true);
-        if (check_collision(*player, power_up))
-        {
-          // collided with player, now activate powerup
-          activate_power_up(power_up);
-          power_up.set_destroyed(true);
-          power_up.set_activated(true);
-        }
-      }
-    }
+    auto &particle_shader =
+        ResourceManager::get_shader(ResourceManager::find_shader("particle"));
+    particle_shader.bind();
+    particle_shader.set_uniform("sprite", 0);
+    particle_shader.set_uniform("projection_matrix", projection_matrix);
+    particle_shader.unbind();
   }
 
-  bool Game::check_collision(const GameObject &one, const GameObject &two)
+  void Game::init_sprite_renderer()
   {
-    // Collision x-axis?
-    bool collisionX =
-        one.get_position().x + one.get_size().x >= two.get_position().x &&
-        two.get_position().x + two.get_size().x >= one.get_position().x;
-    // Collision y-axis?
-    bool collisionY =
-        one.get_position().y + one.get_size().y >= two.get_position().y &&
-        two.get_position().y + two.get_size().y >= one.get_position().y;
-    // Collision only if on both axes
-    return collisionX && collisionY;
+    sprite_renderer = std::make_shared<SpriteRenderer>(
+        renderer,
+        ResourceManager::find_shader("sprite"));
   }
 
-  Collision Game::check_collision(const BallObject &one, const GameObject &two)
+  void Game::init_levels()
   {
-    // get center point circle first
-    glm::vec2 center(one.get_position() + one.get_radius());
-    // calculate AABB info (center, half-extents)
-    glm::vec2 aabb_half_extents(two.get_size().x / 2.0f,
-                                two.get_size().y / 2.0f);
-    glm::vec2 aabb_center(two.get_position().x + aabb_half_extents.x,
-                          two.get_position().y + aabb_half_extents.y);
-    // get difference vector between both centers
-    glm::vec2 difference = center - aabb_center;
-    glm::vec2 clamped =
-        glm::clamp(difference, -aabb_half_extents, aabb_half_extents);
-    // add clamped value to AABB_center and we get the value of box closest to
-    // circle
-    glm::vec2 closest = aabb_center + clamped;
-    // retrieve vector between center circle and closest point AABB and check if
-    // length <= radius
-    difference = closest - center;
-
-    if (glm::length(difference) < one.get_radius())
-      return Collision(true, calc_vector_direction(difference), difference);
-    else
-      return Collision(false, Direction::UP, glm::vec2(0.0f, 0.0f));
+    level_catalog.discover(LEVEL_FILES, "levels");
+    select_level(0);
   }
 
-  void Game::reset_level()
+  void Game::select_level(unsigned index)
   {
-    ASSERT(level < game_levels.size());
-    this->game_levels[level].reset();
-    lives_count = lives_max;
+    level = index;
+    level_catalog.select(level);
   }
 
-  void Game::reset_player()
+  bool Game::update_game_level(bool wait)
   {
-    player->set_size(PLAYER_SIZE);
-    player->set_position(glm::vec2(window_width / 2.0f - PLAYER_SIZE.x / 2.0f,
-                                   window_height - PLAYER_SIZE.y));
-    player->set_color(glm::vec4(1.0f));
+    if (simulation.has_level() && game_level_index == level)
+      return true;
+
+    const auto level_data =
+        wait ? level_catalog.get(level) : level_catalog.try_get(level);
+    if (!level_data)
+      return false;
+
+    simulation.set_level(*level_data);
+    game_level_index = level;
 
-    ball->reset(player->get_position() +
-                    glm::vec2(PLAYER_SIZE.x / 2.0f - BALL_RADIUS,
-                              -(BALL_RADIUS * 2.0f)),
-                INITIAL_BALL_VELOCITY);
-    ball->set_sticky(false);
-    ball->set_pass_through(false);
+    if (recording)
+      recording->add_level(*level_data);
 
-    post_processor->set_chaos(false);
-    post_processor->set_shake(false);
-    post_processor->set_confuse(false);
+    update_brick_styles(*level_data);
+    return true;
   }
 
-  Direction Game::calc_vector_direction(const glm::vec2 target)
+  void Game::update_brick_styles(const LevelData &level_data)
   {
-    glm::vec2 compass[] = {
-        glm::vec2(0.0f, 1.0f),  // up
-        glm::vec2(1.0f, 0.0f),  // right
-        glm::vec2(0.0f, -1.0f), // down
-        glm::vec2(-1.0f, 0.0f)  // left
-    };
-    float        max        = 0.0f;
-    unsigned int best_match = -1;
-
-    for (unsigned int i = 0; i < 4; ++i)
+    // Resolve the look of every brick type once instead of per brick
+    brick_styles.clear();
+    for (const auto &brick_type : level_data.get_palette())
     {
-      float dot_product = glm::dot(glm::normalize(target), compass[i]);
-      if (dot_product > max)
-      {
-        max        = dot_product;
-        best_match = i;
-      }
+      brick_styles.push_back(
+          {brick_type.is_solid ? texture_block_solid : texture_block,
+           glm::vec3(brick_type.color[0],
+                     brick_type.color[1],
+                     brick_type.color[2])});
     }
-    return static_cast<Direction>(best_match);
   }
 
   void Game::init_particle_generator()
@@ -611,10 +720,11 @@ void Game::render()
     // ASSERT(renderer);
 
     particle_generator = std::make_unique<ParticleGenerator>(
-        ResourceManager::get_shader("particle"),
-        ResourceManager::get_texture("particle"),
+        ResourceManager::find_shader("particle"),
+        ResourceManager::find_texture("particle"),
         500,
-        renderer);
+        renderer,
+        simulation.get_seed());
   }
 
   void Game::init_post_processor()
@@ -623,218 +733,61 @@ void Game::render()
 
     post_processor = std::make_unique<PostProcessor>(
         renderer,
-        ResourceManager::get_shader("post-processing"),
+        ResourceManager::find_shader("post-processing"),
         window_width,
         window_height);
   }
 
-  void Game::spawn_power_ups(GameObject & block)
-  {
-    if (power_up_should_spawn(75)) // 1 in 75 chance
-    {
-      Log().d(LOG_TAG) << "Spawn speed powerup";
-      power_ups.push_back(PowerUp(PowerUp::Type::SPEED,
-                                  glm::vec3(0.5f, 0.5f, 1.0f),
-                                  0.0f,
-                                  block.get_position(),
-                                  texture_speed));
-    }
-    if (power_up_should_spawn(75))
-    {
-      Log().d(LOG_TAG) << "Spawn sticky powerup";
-      power_ups.push_back(PowerUp(PowerUp::Type::STICKY,
-                                  glm::vec3(1.0f, 0.5f, 1.0f),
-                                  20.0f,
-                                  block.get_position(),
-                                  texture_sticky));
-    }
-    if (power_up_should_spawn(75))
-    {
-      Log().d(LOG_TAG) << "Spawn pass through powerup";
-      power_ups.push_back(PowerUp(PowerUp::Type::PASS_THROUGH,
-                                  glm::vec3(0.5f, 1.0f, 0.5f),
-                                  10.0f,
-                                  block.get_position(),
-                                  texture_passthrough));
-    }
-    if (power_up_should_spawn(75))
-    {
-      Log().d(LOG_TAG) << "Spawn increase powerup";
-      power_ups.push_back(PowerUp(PowerUp::Type::PAD_SIZE_INCREASE,
-                                  glm::vec3(1.0f, 0.6f, 0.4),
-                                  0.0f,
-                                  block.get_position(),
-                                  texture_increase));
-    }
-    if (power_up_should_spawn(15)) // negative powerups should spawn more often
-    {
-      Log().d(LOG_TAG) << "Spawn confuse powerup";
-      power_ups.push_back(PowerUp(PowerUp::Type::CONFUSE,
-                                  glm::vec3(1.0f, 0.3f, 0.3f),
-                                  15.0f,
-                                  block.get_position(),
-                                  texture_confuse));
-    }
-    if (power_up_should_spawn(15))
-    {
-      Log().d(LOG_TAG) << "Spawn chaos powerup";
-      power_ups.push_back(PowerUp(PowerUp::Type::CHAOS,
-                                  glm::vec3(0.9f, 0.25f, 0.25f),
-                                  15.0f,
-                                  block.get_position(),
-                                  texture_chaos));
-    }
-  }
-
-  void Game::update_power_ups(float delta_time)
+  void Game::load_audio(LoadContext context, std::vector<Task<void>> & loads)
   {
-    for (auto &power_up : power_ups)
-    {
-      power_up.set_position(glm::vec2(
-          power_up.get_position().x + power_up.get_velocity().x * delta_time,
-          power_up.get_position().y + power_up.get_velocity().y * delta_time));
-
-      if (power_up.is_activated())
-      {
-        power_up.set_duration(power_up.get_duration() - delta_time);
-
-        if (power_up.get_duration() <= 0.0f)
-        {
-          // remove powerup from list (will later be removed)
-          power_up.set_activated(false);
-          // deactivate effects
-          if (power_up.get_type() == PowerUp::Type::STICKY)
-          {
-            if (!is_other_power_up_active(power_ups, PowerUp::Type::STICKY))
-            { // only reset if no other PowerUp of type sticky is active
-              ball->set_sticky(false);
-              player->set_color(glm::vec3(1.0f));
-            }
-          }
-          else if (power_up.get_type() == PowerUp::Type::PASS_THROUGH)
-          {
-            if (!is_other_power_up_active(power_ups,
-                                          PowerUp::Type::PASS_THROUGH))
-            { // only reset if no other PowerUp of type pass-through is active
-              ball->set_pass_through(false);
-              ball->set_color(glm::vec3(1.0f));
-            }
-          }
-          else if (power_up.get_type() == PowerUp::Type::CONFUSE)
-          {
-            if (!is_other_power_up_active(power_ups, PowerUp::Type::CONFUSE))
-            { // only reset if no other PowerUp of type confuse is active
-              post_processor->set_confuse(false);
-            }
-          }
-          else if (power_up.get_type() == PowerUp::Type::CHAOS)
-          {
-            if (!is_other_power_up_active(power_ups, PowerUp::Type::CHAOS))
-            { // only reset if no other PowerUp of type chaos is active
-              post_processor->set_chaos(false);
-            }
-          }
-        }
-      }
-    }
-    power_ups.erase(std::remove_if(power_ups.begin(),
-                                   power_ups.end(),
-                                   [](const PowerUp &power_up) {
-                                     return power_up.is_destroyed() &&
-                                            !power_up.is_activated();
-                                   }),
-                    power_ups.end());
-  }
+    const auto audio = [&](const std::string &file, const std::string &name) {
+      loads.push_back(
+          track_load(ResourceManager::load_audio_async(context, file, name)));
+    };
 
-  bool Game::power_up_should_spawn(unsigned chance)
-  {
-    unsigned int random = rand() % chance;
-    return random == 0;
+    audio("audio/solid.wav", "solid");
+    audio("audio/bleep.wav", "bleep");
+    audio("audio/powerup.wav", "powerup");
+    audio("audio/nonsolid.wav", "nonsolid");
   }
 
-  void Game::activate_power_up(PowerUp & power_up)
+  void Game::configure_audio()
   {
-    switch (power_up.get_type())
+    // The game is playable without music
+    try
     {
-    case PowerUp::Type::CHAOS:
-      post_processor->set_chaos(true);
-      break;
-    case PowerUp::Type::CONFUSE:
-      post_processor->set_confuse(true);
-      break;
-    case PowerUp::Type::PAD_SIZE_INCREASE:
-      player->set_size(
-          glm::vec2(player->get_size().x + 50, player->get_size().y));
-      break;
-    case PowerUp::Type::PASS_THROUGH:
-      ball->set_pass_through(true);
-      ball->set_color(glm::vec3(1.0f, 0.5f, 0.5f));
-      break;
-    case PowerUp::Type::SPEED:
-      ball->set_velocity(glm::vec2(ball->get_velocity().x * 1.2,
-                                   ball->get_velocity().y * 1.2));
-      break;
-    case PowerUp::Type::STICKY:
-      ball->set_sticky(true);
-      ball->set_color(glm::vec3(1.0f, 0.5f, 1.0f));
-      break;
-    default:
-      FAIL;
+      music = std::make_unique<MusicStream>(MUSIC_FILE);
     }
-  }
-
-  bool Game::is_other_power_up_active(const std::vector<PowerUp> &power_ups,
-                                      const PowerUp::Type         type) const
-  {
-    for (const auto &power_up : power_ups)
+    catch (const std::runtime_error &error)
     {
-      if (power_up.is_activated())
-        if (power_up.get_type() == type)
-          return true;
+      Log().w(LOG_TAG) << "Play without music, expected the track at "
+                       << AssetStore::get_loose_path(MUSIC_FILE) << ": "
+                       << error.what();
+      if (AssetStore::exists(OLD_MUSIC_FILE))
+      {
+        Log().w(LOG_TAG) << "Found the track at " << OLD_MUSIC_FILE
+                         << ", move it to " << MUSIC_FILE;
+      }
     }
-    return false;
-  }
 
-  void Game::load_audio()
-  {
-    ResourceManager::load_audio("audio/solid.wav", "solid");
-    ResourceManager::load_audio("audio/breakout.wav", "breakout");
-    ResourceManager::load_audio("audio/bleep.wav", "bleep");
-    ResourceManager::load_audio("audio/powerup.wav", "powerup");
-    ResourceManager::load_audio("audio/nonsolid.wav", "nonsolid");
-  }
+    sound_thread   = std::make_unique<AudioThread>(SOUND_VOICE_COUNT);
+    sound_solid    = ResourceManager::find_audio("solid");
+    sound_bleep    = ResourceManager::find_audio("bleep");
+    sound_powerup  = ResourceManager::find_audio("powerup");
+    sound_nonsolid = ResourceManager::find_audio("nonsolid");
 
-  void Game::configure_audio()
-  {
-    audio_source_solid =
-        std::make_unique<AudioSource>(*ResourceManager::get_audio("solid"));
-    audio_source_breakout =
-        std::make_unique<AudioSource>(*ResourceManager::get_audio("breakout"));
-    audio_source_bleep =
-        std::make_unique<AudioSource>(*ResourceManager::get_audio("bleep"));
-    audio_source_powerup =
-        std::make_unique<AudioSource>(*ResourceManager::get_audio("powerup"));
-    audio_source_nonsolid =
-        std::make_unique<AudioSource>(*ResourceManager::get_audio("nonsolid"));
-  }
-
-  void Game::update_audio()
-  {
-    // Play background music forever
-    auto state = audio_source_breakout->get_state();
-    if (state == AudioSource::State::STOPPED)
-    {
-      audio_source_breakout->play();
-    }
+    // A fast forwarded replay plays far too many sounds to follow
+    if (replay_player && options.fast_forward)
+      sound_thread->set_gain(0.0f);
   }
 
-  void Game::init_text_renderer()
+  void Game::init_text_renderer(const std::vector<Glyph> &glyphs)
   {
 
     text_renderer =
         std::make_unique<TextRenderer>(renderer,
-                                       ResourceManager::get_shader("text"),
+                                       ResourceManager::find_shader("text"),
                                        window_width,
                                        window_height);
-    text_renderer->load("fonts/ocraext.ttf", 24);
+    text_renderer->load(glyphs);
   }
@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <set>
+
+#include "asseration.hpp"
+#include "asset-store.hpp"
+#include "game-level.hpp"
+#include "level-catalog.hpp"
+#include "log.hpp"
+
+static const std::string LOG_TAG = "LevelCatalog";
+
+static const std::string LEVEL_EXTENSION = ".lvl";
+
+LevelCatalog::LevelCatalog(ThreadPool &workers, std::size_t memory_budget)
+    : workers(workers),
+      memory_budget(memory_budget)
+{
+}
+
+void LevelCatalog::discover(const std::vector<std::string> &built_in_files,
+                            const std::string &             directory)
+{
+  for (const auto &file : built_in_files)
+    add(file);
+
+  // Binary levels are listed under the name of their text level
+  const std::string_view binary_extension = LEVEL_BINARY_EXTENSION;
+
+  std::set<std::string> files;
+  for (auto file : AssetStore::list(directory))
+  {
+    if (file.ends_with(binary_extension))
+      file.resize(file.size() - binary_extension.size());
+
+    if (file.ends_with(LEVEL_EXTENSION))
+      files.insert(std::move(file));
+  }
+
+  for (const auto &file : files)
+  {
+    if (std::find(built_in_files.begin(), built_in_files.end(), file) ==
+        built_in_files.end())
+      add(file);
+  }
+
+  Log().i(LOG_TAG) << "Found " << entries.size() << " levels";
+}
+
+void LevelCatalog::add(std::string file)
+{
+  entries.push_back({std::move(file), {}});
+}
+
+void LevelCatalog::select(std::size_t index)
+{
+  ASSERT(index < entries.size());
+
+  prefetch(index);
+  prefetch((index + 1) % entries.size());
+  prefetch((index + entries.size() - 1) % entries.size());
+
+  evict(index);
+}
+
+std::shared_ptr<const LevelData> LevelCatalog::try_get(std::size_t index)
+{
+  ASSERT(index < entries.size());
+
+  const auto &data = entries[index].data;
+  if (!data.valid() || !is_ready(data))
+    return nullptr;
+
+  return data.get();
+}
+
+std::shared_ptr<const LevelData> LevelCatalog::get(std::size_t index)
+{
+  ASSERT(index < entries.size());
+
+  prefetch(index);
+  return entries[index].data.get();
+}
+
+bool LevelCatalog::has_failed(std::size_t index) const
+{
+  ASSERT(index < entries.size());
+
+  return is_failed(entries[index].data);
+}
+
+std::size_t LevelCatalog::get_memory_usage() const
+{
+  std::size_t usage = 0;
+  for (const auto index : resident_entries)
+    usage += get_memory_size(entries[index].data);
+  return usage;
+}
+
+void LevelCatalog::prefetch(std::size_t index)
+{
+  auto &entry = entries[index];
+  if (entry.data.valid())
+    return;
+
+  auto load = std::make_shared<
+      std::packaged_task<std::shared_ptr<const LevelData>()>>(
+      [file = entry.file]() -> std::shared_ptr<const LevelData> {
+        // One broken level must not take down the game, it is only
+        // left out
+        try
+        {
+          return std::make_shared<const LevelData>(
+              GameLevel::load_from_file(file));
+        }
+        catch (const std::runtime_error &error)
+        {
+          Log().e(LOG_TAG) << "Could not load level " << file << ": "
+                           << error.what();
+          return nullptr;
+        }
+      });
+
+  entry.data = load->get_future().share();
+  resident_entries.push_back(index);
+
+  workers.post([load]() { (*load)(); });
+}
+
+void LevelCatalog::evict(std::size_t selected)
+{
+  // Failed levels are dropped once out of reach, so they are tried
+  // again when selected later
+  std::erase_if(resident_entries, [this, selected](std::size_t index) {
+    if (get_distance(index, selected) <= 1 || !is_failed(entries[index].data))
+      return false;
+
+    entries[index].data = {};
+    return true;
+  });
+
+  auto usage = get_memory_usage();
+  if (usage <= memory_budget)
+    return;
+
+  // Evict the levels furthest away from the selection first
+  std::sort(resident_entries.begin(),
+            resident_entries.end(),
+            [this, selected](std::size_t a, std::size_t b) {
+              return get_distance(a, selected) > get_distance(b, selected);
+            });
+
+  auto it = resident_entries.begin();
+  while (it != resident_entries.end() && usage > memory_budget)
+  {
+    auto &data = entries[*it].data;
+
+    // Levels still loading are kept, their size is not known yet
+    if (get_distance(*it, selected) <= 1 || !is_ready(data))
+    {
+      ++it;
+      continue;
+    }
+
+    usage -= get_memory_size(data);
+    data = {};
+    it   = resident_entries.erase(it);
+  }
+}
+
+std::size_t LevelCatalog::get_distance(std::size_t index,
+                                       std::size_t selected) const
+{
+  // Navigation wraps around at both ends
+  const auto distance = index > selected ? index - selected : selected - index;
+  return std::min(distance, entries.size() - distance);
+}
+
+bool LevelCatalog::is_ready(const LevelFuture &data)
+{
+  return data.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+bool LevelCatalog::is_failed(const LevelFuture &data)
+{
+  return data.valid() && is_ready(data) && !data.get();
+}
+
+std::size_t LevelCatalog::get_memory_size(const LevelFuture &data)
+{
+  // Levels still loading and failed loads hold no level data
+  if (!data.valid() || !is_ready(data) || !data.get())
+    return 0;
+
+  const auto &level_data = *data.get();
+  return sizeof(level_data) + level_data.get_tiles().capacity() +
+         level_data.get_palette().capacity() * sizeof(BrickType);
+}
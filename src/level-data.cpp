@@ -0,0 +1,305 @@
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "level-data.hpp"
+
+static std::vector<std::uint8_t> rle_encode(std::span<const std::uint8_t> tiles)
+{
+  std::vector<std::uint8_t> encoded;
+  for (std::size_t i = 0; i < tiles.size();)
+  {
+    std::size_t run = 1;
+    while (run < 255 && i + run < tiles.size() && tiles[i + run] == tiles[i])
+      ++run;
+
+    encoded.push_back(static_cast<std::uint8_t>(run));
+    encoded.push_back(tiles[i]);
+    i += run;
+  }
+  return encoded;
+}
+
+static std::vector<std::uint8_t> rle_decode(std::span<const unsigned char> data,
+                                            std::size_t tile_count)
+{
+  if (data.size() % 2 != 0)
+  {
+    throw std::runtime_error("Binary level has corrupt tile runs");
+  }
+
+  std::vector<std::uint8_t> tiles;
+  tiles.reserve(std::min(tile_count, data.size() / 2 * 255));
+  for (std::size_t i = 0; i < data.size(); i += 2)
+  {
+    if (data[i] == 0 || data[i] > tile_count - tiles.size())
+    {
+      throw std::runtime_error("Binary level has corrupt tile runs");
+    }
+    tiles.insert(tiles.end(), data[i], data[i + 1]);
+  }
+  return tiles;
+}
+
+LevelData::LevelData(unsigned                  rows,
+                     unsigned                  columns,
+                     std::vector<std::uint8_t> tiles,
+                     std::vector<BrickType>    palette)
+    : rows(rows),
+      columns(columns),
+      tiles(std::move(tiles)),
+      palette(std::move(palette))
+{
+  if (this->tiles.size() != std::size_t(rows) * columns)
+  {
+    throw std::runtime_error("Level tiles do not match its dimensions");
+  }
+
+  if (this->palette.empty())
+  {
+    throw std::runtime_error("Level has no palette");
+  }
+
+  const auto max_tile =
+      std::max_element(this->tiles.begin(), this->tiles.end());
+  if (max_tile != this->tiles.end() && *max_tile >= this->palette.size())
+  {
+    throw std::runtime_error("Level uses tile code " +
+                             std::to_string(*max_tile) +
+                             " which is not in its palette");
+  }
+}
+
+const std::vector<BrickType> &LevelData::default_palette()
+{
+  static const std::vector<BrickType> palette = {
+      {false, {1.0f, 1.0f, 1.0f}}, // Empty
+      {true, {0.8f, 0.8f, 0.7f}},
+      {false, {0.2f, 0.6f, 1.0f}},
+      {false, {0.0f, 0.7f, 0.0f}},
+      {false, {0.8f, 0.8f, 0.4f}},
+      {false, {1.0f, 0.5f, 0.0f}}};
+  return palette;
+}
+
+std::vector<BrickType>
+LevelData::default_palette_for(std::span<const std::uint8_t> tiles)
+{
+  const auto max_tile = std::max_element(tiles.begin(), tiles.end());
+
+  auto palette = default_palette();
+  if (max_tile != tiles.end())
+    palette.resize(std::max<std::size_t>(palette.size(), *max_tile + 1u));
+  return palette;
+}
+
+LevelData LevelData::parse_text(std::string_view content)
+{
+  std::vector<std::uint8_t> tiles;
+  unsigned                  rows    = 0;
+  unsigned                  columns = 0;
+
+  std::size_t line_start = 0;
+  while (line_start < content.size())
+  {
+    auto line_end = content.find('\n', line_start);
+    if (line_end == std::string_view::npos)
+      line_end = content.size();
+
+    const char *current = content.data() + line_start;
+    const char *end     = content.data() + line_end;
+    unsigned    column  = 0;
+
+    while (true)
+    {
+      while (current != end &&
+             (*current == ' ' || *current == '\t' || *current == '\r'))
+        ++current;
+      if (current == end)
+        break;
+
+      unsigned tile_code;
+      const auto [next, error] = std::from_chars(current, end, tile_code);
+      if (error != std::errc() || tile_code > 255)
+      {
+        throw std::runtime_error("Level row " + std::to_string(rows + 1) +
+                                 " contains an invalid tile code");
+      }
+
+      tiles.push_back(static_cast<std::uint8_t>(tile_code));
+      current = next;
+      ++column;
+    }
+
+    if (column == 0)
+    {
+      // Hand edited levels often end with blank lines
+      if (content.find_first_not_of(" \t\r\n", line_start) ==
+          std::string_view::npos)
+        break;
+
+      throw std::runtime_error("Level row " + std::to_string(rows + 1) +
+                               " is empty");
+    }
+    if (rows > 0 && column != columns)
+    {
+      throw std::runtime_error("Level row " + std::to_string(rows + 1) +
+                               " has " + std::to_string(column) +
+                               " tiles instead of " +
+                               std::to_string(columns));
+    }
+
+    columns = column;
+    ++rows;
+    line_start = line_end + 1;
+  }
+
+  if (rows == 0)
+  {
+    throw std::runtime_error("Level is empty");
+  }
+
+  auto palette = default_palette_for(tiles);
+  return LevelData(rows, columns, std::move(tiles), std::move(palette));
+}
+
+LevelData LevelData::read_binary(std::span<const unsigned char> data)
+{
+  if constexpr (std::endian::native != std::endian::little)
+  {
+    throw std::runtime_error("Binary levels are only supported on little "
+                             "endian platforms");
+  }
+
+  LevelFileHeader header;
+  if (data.size() < sizeof(header))
+  {
+    throw std::runtime_error("Binary level is truncated");
+  }
+  std::memcpy(&header, data.data(), sizeof(header));
+
+  if (!is_binary(data) || header.version != LEVEL_FILE_VERSION ||
+      (header.flags & ~LEVEL_FILE_RLE) != 0 || header.palette_size > 256)
+  {
+    throw std::runtime_error("Unsupported binary level");
+  }
+
+  if (header.rows == 0 || header.columns == 0)
+  {
+    throw std::runtime_error("Level is empty");
+  }
+
+  const auto palette_bytes =
+      std::size_t(header.palette_size) * sizeof(LevelFileBrickType);
+  if (palette_bytes > data.size() - sizeof(header) ||
+      header.tile_data_size > data.size() - sizeof(header) - palette_bytes)
+  {
+    throw std::runtime_error("Binary level is truncated");
+  }
+
+  std::vector<BrickType> palette(header.palette_size);
+  for (std::size_t i = 0; i < palette.size(); ++i)
+  {
+    LevelFileBrickType brick_type;
+    std::memcpy(&brick_type,
+                data.data() + sizeof(header) + i * sizeof(brick_type),
+                sizeof(brick_type));
+
+    palette[i].is_solid = brick_type.flags & LEVEL_FILE_SOLID;
+    std::copy(std::begin(brick_type.color),
+              std::end(brick_type.color),
+              palette[i].color);
+  }
+
+  const auto tile_count = std::size_t(header.rows) * header.columns;
+  const auto tile_data =
+      data.subspan(sizeof(header) + palette_bytes, header.tile_data_size);
+
+  std::vector<std::uint8_t> tiles;
+  if (header.flags & LEVEL_FILE_RLE)
+    tiles = rle_decode(tile_data, tile_count);
+  else
+    tiles.assign(tile_data.begin(), tile_data.end());
+
+  return LevelData(header.rows,
+                   header.columns,
+                   std::move(tiles),
+                   std::move(palette));
+}
+
+LevelData LevelData::load(std::span<const unsigned char> data)
+{
+  if (is_binary(data))
+    return read_binary(data);
+
+  return parse_text(
+      {reinterpret_cast<const char *>(data.data()), data.size()});
+}
+
+bool LevelData::is_binary(std::span<const unsigned char> data)
+{
+  return data.size() >= sizeof(LEVEL_FILE_MAGIC) &&
+         std::memcmp(data.data(), LEVEL_FILE_MAGIC, sizeof(LEVEL_FILE_MAGIC)) ==
+             0;
+}
+
+std::vector<unsigned char> LevelData::to_binary(bool compress) const
+{
+  LevelFileHeader header{};
+  std::memcpy(header.magic, LEVEL_FILE_MAGIC, sizeof(header.magic));
+  header.version      = LEVEL_FILE_VERSION;
+  header.rows         = rows;
+  header.columns      = columns;
+  header.palette_size = static_cast<std::uint32_t>(palette.size());
+
+  std::vector<std::uint8_t> encoded;
+  if (compress)
+    encoded = rle_encode(tiles);
+
+  // Runs only pay off for levels with long stretches of the same brick
+  const auto use_rle = compress && encoded.size() < tiles.size();
+  const auto &tile_data = use_rle ? encoded : tiles;
+  header.flags          = use_rle ? LEVEL_FILE_RLE : 0;
+  header.tile_data_size = static_cast<std::uint32_t>(tile_data.size());
+
+  std::vector<unsigned char> data(sizeof(header));
+  std::memcpy(data.data(), &header, sizeof(header));
+
+  for (const auto &brick_type : palette)
+  {
+    LevelFileBrickType file_brick_type{};
+    file_brick_type.flags = brick_type.is_solid ? LEVEL_FILE_SOLID : 0;
+    std::copy(std::begin(brick_type.color),
+              std::end(brick_type.color),
+              file_brick_type.color);
+
+    const auto bytes =
+        reinterpret_cast<const unsigned char *>(&file_brick_type);
+    data.insert(data.end(), bytes, bytes + sizeof(file_brick_type));
+  }
+
+  data.insert(data.end(), tile_data.begin(), tile_data.end());
+  return data;
+}
+
+void LevelData::write_binary(const std::string &file, bool compress) const
+{
+  const auto data = to_binary(compress);
+
+  std::ofstream out(file, std::ios::binary | std::ios::trunc);
+  if (!out)
+  {
+    throw std::runtime_error("Could not open \"" + file + "\" for writing");
+  }
+
+  out.write(reinterpret_cast<const char *>(data.data()),
+            static_cast<std::streamsize>(data.size()));
+
+  if (!out)
+  {
+    throw std::runtime_error("Could not write binary level \"" + file + "\"");
+  }
+}
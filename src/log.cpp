@@ -1,9 +1,19 @@
 #include "log.hpp"
 
 #include <list>
+#include <mutex>
 
 std::queue<std::string> log_queue;
 
+// Messages are pushed from the loader threads as well
+static std::mutex log_mutex;
+
+static bool is_log_queue_empty()
+{
+  std::lock_guard<std::mutex> lock(log_mutex);
+  return log_queue.empty();
+}
+
 static std::unique_ptr<std::thread> log_thread;
 
 static bool kill_log_thread = false;
@@ -14,17 +24,20 @@ static void read_log_queue()
 {
   while (!kill_log_thread)
   {
-    if (log_queue.empty())
+    if (is_log_queue_empty())
     {
       std::this_thread::sleep_for(std::chrono::seconds(2));
       continue;
     }
 
     // Take everything from queue and output it in one batch
-    while (!log_queue.empty())
     {
-      log_batch << log_queue.front() << "\n";
-      log_queue.pop();
+      std::lock_guard<std::mutex> lock(log_mutex);
+      while (!log_queue.empty())
+      {
+        log_batch << log_queue.front() << "\n";
+        log_queue.pop();
+      }
     }
 
     std::fprintf(stderr, "%s\n", log_batch.str().c_str());
@@ -42,7 +55,7 @@ void start_log_system()
 void stop_log_system()
 {
   // Log thread should log all messages
-  while (!log_queue.empty())
+  while (!is_log_queue_empty())
     ;
 
   // Kill log thread
@@ -52,7 +65,11 @@ void stop_log_system()
 
 Log::Log() {}
 
-Log::~Log() { log_queue.push(log_buffer.str()); }
+Log::~Log()
+{
+  std::lock_guard<std::mutex> lock(log_mutex);
+  log_queue.push(log_buffer.str());
+}
 
 std::ostringstream &Log::i(const std::string &tag)
 {
@@ -0,0 +1,202 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include "lz.hpp"
+
+static constexpr std::size_t MIN_MATCH    = 4;
+static constexpr std::size_t MAX_OFFSET   = 65535;
+static constexpr unsigned    HASH_BITS    = 14;
+static constexpr std::size_t NO_CANDIDATE = SIZE_MAX;
+
+static std::uint32_t read_u32(const unsigned char *data)
+{
+  std::uint32_t value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+static std::uint32_t hash_sequence(std::uint32_t sequence)
+{
+  return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+static void write_length(std::vector<unsigned char> &out, std::size_t length)
+{
+  while (length >= 255)
+  {
+    out.push_back(255);
+    length -= 255;
+  }
+  out.push_back(static_cast<unsigned char>(length));
+}
+
+static void write_sequence(std::vector<unsigned char> &   out,
+                           std::span<const unsigned char> literals,
+                           std::size_t                    offset,
+                           std::size_t                    match_length)
+{
+  const auto literal_length = literals.size();
+  const auto match_code     = match_length - MIN_MATCH;
+
+  const auto token =
+      static_cast<unsigned char>((std::min<std::size_t>(literal_length, 15)
+                                  << 4) |
+                                 std::min<std::size_t>(match_code, 15));
+  out.push_back(token);
+
+  if (literal_length >= 15)
+    write_length(out, literal_length - 15);
+
+  out.insert(out.end(), literals.begin(), literals.end());
+
+  out.push_back(static_cast<unsigned char>(offset & 0xff));
+  out.push_back(static_cast<unsigned char>(offset >> 8));
+
+  if (match_code >= 15)
+    write_length(out, match_code - 15);
+}
+
+static void write_last_literals(std::vector<unsigned char> &   out,
+                                std::span<const unsigned char> literals)
+{
+  const auto literal_length = literals.size();
+
+  out.push_back(static_cast<unsigned char>(
+      std::min<std::size_t>(literal_length, 15) << 4));
+
+  if (literal_length >= 15)
+    write_length(out, literal_length - 15);
+
+  out.insert(out.end(), literals.begin(), literals.end());
+}
+
+std::vector<unsigned char> lz_compress(std::span<const unsigned char> source)
+{
+  std::vector<unsigned char> out;
+  out.reserve(source.size() / 2 + 16);
+
+  std::vector<std::size_t> table(std::size_t(1) << HASH_BITS, NO_CANDIDATE);
+
+  const auto  size   = source.size();
+  const auto *data   = source.data();
+  std::size_t anchor = 0;
+  std::size_t i      = 0;
+
+  while (i + MIN_MATCH <= size)
+  {
+    const auto sequence  = read_u32(data + i);
+    auto &     slot      = table[hash_sequence(sequence)];
+    const auto candidate = slot;
+    slot                 = i;
+
+    if (candidate == NO_CANDIDATE || i - candidate > MAX_OFFSET ||
+        read_u32(data + candidate) != sequence)
+    {
+      ++i;
+      continue;
+    }
+
+    auto match_length = MIN_MATCH;
+    while (i + match_length < size &&
+           data[candidate + match_length] == data[i + match_length])
+      ++match_length;
+
+    write_sequence(out,
+                   source.subspan(anchor, i - anchor),
+                   i - candidate,
+                   match_length);
+
+    i += match_length;
+    anchor = i;
+  }
+
+  write_last_literals(out, source.subspan(anchor));
+
+  return out;
+}
+
+static std::size_t read_length(std::span<const unsigned char> source,
+                               std::size_t &                  position)
+{
+  std::size_t   length = 0;
+  unsigned char byte;
+  do
+  {
+    if (position >= source.size())
+    {
+      throw std::runtime_error("Corrupt compressed block: truncated length");
+    }
+    byte = source[position++];
+    length += byte;
+  } while (byte == 255);
+  return length;
+}
+
+void lz_decompress(std::span<const unsigned char> source,
+                   std::span<unsigned char>       destination)
+{
+  std::size_t in  = 0;
+  std::size_t out = 0;
+
+  while (true)
+  {
+    if (in >= source.size())
+    {
+      throw std::runtime_error("Corrupt compressed block: missing token");
+    }
+
+    const auto token = source[in++];
+
+    auto literal_length = static_cast<std::size_t>(token >> 4);
+    if (literal_length == 15)
+      literal_length += read_length(source, in);
+
+    if (literal_length > source.size() - in ||
+        literal_length > destination.size() - out)
+    {
+      throw std::runtime_error("Corrupt compressed block: literal overrun");
+    }
+
+    std::memcpy(destination.data() + out, source.data() + in, literal_length);
+    in += literal_length;
+    out += literal_length;
+
+    // The last sequence consists of literals only
+    if (in == source.size())
+      break;
+
+    if (source.size() - in < 2)
+    {
+      throw std::runtime_error("Corrupt compressed block: truncated offset");
+    }
+
+    const auto offset = static_cast<std::size_t>(source[in]) |
+                        (static_cast<std::size_t>(source[in + 1]) << 8);
+    in += 2;
+
+    auto match_length = static_cast<std::size_t>(token & 15);
+    if (match_length == 15)
+      match_length += read_length(source, in);
+    match_length += MIN_MATCH;
+
+    if (offset == 0 || offset > out ||
+        match_length > destination.size() - out)
+    {
+      throw std::runtime_error("Corrupt compressed block: match overrun");
+    }
+
+    // Matches may overlap their own output, so copy byte by byte
+    auto *match = destination.data() + out - offset;
+    auto *dest  = destination.data() + out;
+    for (std::size_t i = 0; i < match_length; ++i)
+      dest[i] = match[i];
+    out += match_length;
+  }
+
+  if (out != destination.size())
+  {
+    throw std::runtime_error("Corrupt compressed block: size mismatch");
+  }
+}
@@ -0,0 +1,46 @@
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mapped-file.hpp"
+
+MappedFile::MappedFile(const std::string &file)
+{
+  const auto fd = open(file.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1)
+  {
+    throw std::runtime_error("Could not open \"" + file + "\"");
+  }
+
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) == -1)
+  {
+    close(fd);
+    throw std::runtime_error("Could not stat \"" + file + "\"");
+  }
+
+  size = static_cast<std::size_t>(file_stat.st_size);
+
+  // Zero sized mappings are not allowed, an empty file is an empty span
+  if (size > 0)
+  {
+    address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (address == MAP_FAILED)
+    {
+      address = nullptr;
+      close(fd);
+      throw std::runtime_error("Could not map \"" + file + "\"");
+    }
+  }
+
+  // The mapping keeps its own reference to the file
+  close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+  if (address)
+    munmap(address, size);
+}
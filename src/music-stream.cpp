@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "music-stream.hpp"
+
+static const std::string LOG_TAG = "MusicStream";
+
+static ALenum get_al_format(const WavView &wav)
+{
+  if (wav.channels == 1 && wav.bits_per_sample == 8)
+    return AL_FORMAT_MONO8;
+  if (wav.channels == 1 && wav.bits_per_sample == 16)
+    return AL_FORMAT_MONO16;
+  if (wav.channels == 2 && wav.bits_per_sample == 8)
+    return AL_FORMAT_STEREO8;
+  if (wav.channels == 2 && wav.bits_per_sample == 16)
+    return AL_FORMAT_STEREO16;
+
+  throw std::runtime_error(
+      "Unrecognised wave format: " + std::to_string(wav.channels) +
+      " channels, " + std::to_string(wav.bits_per_sample) + " bps");
+}
+
+MusicStream::MusicStream(const std::string &file)
+    : asset(AssetStore::read(file)),
+      wav(view_wav(file, asset.data())),
+      format(get_al_format(wav))
+{
+  // Chunks hold whole sample frames
+  const std::size_t frame_size = wav.channels * wav.bits_per_sample / 8;
+  if (wav.samples.size() < frame_size || wav.sample_rate <= 0)
+    throw std::runtime_error("Music \"" + file + "\" has no samples");
+
+  const auto frames = static_cast<std::size_t>(wav.sample_rate * BUFFER_TIME);
+  chunk_size        = std::max(frames, std::size_t(1)) * frame_size;
+  chunk.resize(chunk_size);
+
+  AL_CALL(alGenSources, 1, &source);
+  AL_CALL(alSourcef, source, AL_GAIN, 1.0f);
+  AL_CALL(alSourcei, source, AL_LOOPING, AL_FALSE);
+  AL_CALL(alGenBuffers, static_cast<ALsizei>(BUFFER_COUNT), buffers.data());
+
+  for (const auto buffer : buffers)
+    fill(buffer);
+  AL_CALL(alSourceQueueBuffers,
+          source,
+          static_cast<ALsizei>(BUFFER_COUNT),
+          buffers.data());
+  AL_CALL(alSourcePlay, source);
+
+  Log().i(LOG_TAG) << "Stream music from \"" << file << "\"";
+
+  thread = std::thread(&MusicStream::run, this);
+}
+
+MusicStream::~MusicStream()
+{
+  {
+    std::lock_guard lock(mutex);
+    stopping = true;
+  }
+  stop_condition.notify_one();
+  thread.join();
+
+  // Detaching the buffer unqueues all buffers of a stopped source
+  AL_CALL(alSourceStop, source);
+  AL_CALL(alSourcei, source, AL_BUFFER, 0);
+  AL_CALL(alDeleteSources, 1, &source);
+  AL_CALL(alDeleteBuffers, static_cast<ALsizei>(BUFFER_COUNT), buffers.data());
+}
+
+void MusicStream::run()
+{
+  std::unique_lock lock(mutex);
+  while (!stop_condition.wait_for(lock, POLL_INTERVAL, [this]() {
+    return stopping;
+  }))
+  {
+    ALint processed = 0;
+    AL_CALL(alGetSourcei, source, AL_BUFFERS_PROCESSED, &processed);
+    for (ALint i = 0; i < processed; ++i)
+    {
+      ALuint buffer;
+      AL_CALL(alSourceUnqueueBuffers, source, 1, &buffer);
+      fill(buffer);
+      AL_CALL(alSourceQueueBuffers, source, 1, &buffer);
+    }
+
+    // The source stops if all buffers ran out before they were refilled
+    ALint state;
+    AL_CALL(alGetSourcei, source, AL_SOURCE_STATE, &state);
+    if (state != AL_PLAYING)
+    {
+      Log().w(LOG_TAG) << "Music ran out of buffers, restart";
+      AL_CALL(alSourcePlay, source);
+    }
+  }
+}
+
+void MusicStream::fill(ALuint buffer)
+{
+  // Wraps around to the start of the track to loop without a gap
+  const auto  samples = wav.samples;
+  std::size_t filled  = 0;
+  while (filled < chunk_size)
+  {
+    const auto count =
+        std::min(chunk_size - filled, samples.size() - read_position);
+    std::copy_n(samples.begin() + read_position, count, chunk.begin() + filled);
+    filled += count;
+    read_position = (read_position + count) % samples.size();
+  }
+
+  AL_CALL(alBufferData,
+          buffer,
+          format,
+          chunk.data(),
+          static_cast<ALsizei>(chunk_size),
+          wav.sample_rate);
+}
@@ -38,3 +38,17 @@ void gl_check_error(const char *             function,
     }
   }
 }
+
+bool gl_has_extension(std::string_view name)
+{
+  GLint count = 0;
+  glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+  for (GLint i = 0; i < count; ++i)
+  {
+    const auto extension = reinterpret_cast<const char *>(
+        glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+    if (extension && name == extension)
+      return true;
+  }
+  return false;
+}
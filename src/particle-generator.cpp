@@ -1,12 +1,15 @@
 #include <glm/gtx/string_cast.hpp>
 
 #include "particle-generator.hpp"
+#include "resource-manager.hpp"
 
-ParticleGenerator::ParticleGenerator(const std::shared_ptr<Shader>    shader,
-                                     const std::shared_ptr<Texture2D> texture,
-                                     unsigned                         amount,
-                                     const std::shared_ptr<Renderer>  renderer)
+ParticleGenerator::ParticleGenerator(const ShaderHandle              shader,
+                                     const TextureHandle             texture,
+                                     unsigned                        amount,
+                                     const std::shared_ptr<Renderer> renderer,
+                                     std::uint64_t                   seed)
     : amount(amount),
+      random(seed, RandomStream::PARTICLES),
       renderer(renderer),
       shader(shader),
       texture(texture)
@@ -14,17 +17,20 @@ ParticleGenerator::ParticleGenerator(const std::shared_ptr<Shader>    shader,
   init();
 }
 
-void ParticleGenerator::update(const float       delta_time,
-                               const GameObject &object,
-                               const unsigned    new_particles,
-                               const glm::vec2 & offset)
+void ParticleGenerator::spawn(const glm::vec2 &position,
+                              const glm::vec2 &velocity,
+                              const unsigned   new_particles,
+                              const glm::vec2 &offset)
 {
-  // Add new particles
   for (unsigned i = 0; i < new_particles; ++i)
   {
-    const auto unused_particle = first_unused_particle();
-    respawn_particle(particles[unused_particle], object, offset);
+    respawn_particle(particles[next_particle], position, velocity, offset);
+    next_particle = (next_particle + 1) % amount;
   }
+}
+
+void ParticleGenerator::update(const float delta_time)
+{
   // update all particles
   for (unsigned int i = 0; i < amount; ++i)
   {
@@ -44,15 +50,18 @@ void ParticleGenerator::draw()
   // Use additive blending to give it a 'glow' effect
   renderer->blend_func(GL_SRC_ALPHA, GL_ONE);
 
-  shader->bind();
+  auto &particle_shader  = ResourceManager::get_shader(shader);
+  auto &particle_texture = ResourceManager::get_texture(texture);
+
+  particle_shader.bind();
 
   for (auto &particle : particles)
   {
     if (particle.life > 0.0f)
     {
-      shader->set_uniform("offset", particle.position);
-      shader->set_uniform("color", particle.color);
-      texture->bind();
+      particle_shader.set_uniform("offset", particle.position);
+      particle_shader.set_uniform("color", particle.color);
+      particle_texture.bind();
 
       vertex_array.bind();
 
@@ -89,42 +98,16 @@ void ParticleGenerator::init()
   particles.resize(amount);
 }
 
-unsigned ParticleGenerator::first_unused_particle()
-{
-  // First search from last used particle, this will usually return
-  // almost instantly
-  for (unsigned i = last_used_particle; i < amount; ++i)
-  {
-    if (particles[i].life <= 0.0f)
-    {
-      last_used_particle = i;
-      return i;
-    }
-  }
-  // Otherwise, do a linear search
-  for (unsigned i = 0; i < last_used_particle; ++i)
-  {
-    if (particles[i].life <= 0.0f)
-    {
-      last_used_particle = i;
-      return i;
-    }
-  }
-  // All particles are taken, override the first one (note that if it
-  // repeatedly hits this case, more particles should be reserved)
-  last_used_particle = 0;
-  return 0;
-}
-
-void ParticleGenerator::respawn_particle(Particle &        particle,
-                                         const GameObject &object,
-                                         const glm::vec2 & offset)
+void ParticleGenerator::respawn_particle(Particle &       particle,
+                                         const glm::vec2 &position,
+                                         const glm::vec2 &velocity,
+                                         const glm::vec2 &offset)
 {
-  const auto random  = ((rand() % 100) - 50) / 10.0f;
-  const auto r_color = 0.5f + ((rand() % 100) / 100.0f);
+  const auto scatter = (random.next_float() - 0.5f) * 10.0f;
+  const auto r_color = 0.5f + random.next_float();
 
-  particle.position = object.get_position() + random + offset;
+  particle.position = position + scatter + offset;
   particle.color    = glm::vec4(r_color, r_color, r_color, 1.0f);
   particle.life     = 1.0f;
-  particle.velocity = object.get_velocity() * 0.1f;
+  particle.velocity = velocity * 0.1f;
 }
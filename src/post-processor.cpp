@@ -1,7 +1,8 @@
 #include "post-processor.hpp"
+#include "resource-manager.hpp"
 
 PostProcessor::PostProcessor(const std::shared_ptr<Renderer> renderer,
-                             const std::shared_ptr<Shader>   shader,
+                             const ShaderHandle              shader,
                              unsigned                        width,
                              unsigned                        height)
     : renderer(renderer),
@@ -17,8 +18,11 @@ PostProcessor::PostProcessor(const std::shared_ptr<Renderer> renderer,
 
   init_render_data();
 
-  post_processing_shader->bind();
-  post_processing_shader->set_uniform("scene", 0);
+  auto &processing_shader =
+      ResourceManager::get_shader(post_processing_shader);
+
+  processing_shader.bind();
+  processing_shader.set_uniform("scene", 0);
 
   const auto offset = 1.0f / 300.0f;
 
@@ -33,10 +37,10 @@ PostProcessor::PostProcessor(const std::shared_ptr<Renderer> renderer,
       glm::vec2(0.0f, -offset),    // bottom-center
       glm::vec2(offset, -offset)   // bottom-right
   };
-  post_processing_shader->set_uniform("offsets", offsets);
+  processing_shader.set_uniform("offsets", offsets);
 
   std::array<int, 9> edge_kernel = {-1, -1, -1, -1, 8, -1, -1, -1, -1};
-  post_processing_shader->set_uniform("edge_kernel", edge_kernel);
+  processing_shader.set_uniform("edge_kernel", edge_kernel);
 
   std::array<float, 9> blur_kernel = {1.0f / 16.0f,
                                       2.0f / 16.0f,
@@ -47,7 +51,7 @@ PostProcessor::PostProcessor(const std::shared_ptr<Renderer> renderer,
                                       1.0f / 16.0f,
                                       2.0f / 16.0f,
                                       1.0f / 16.0f};
-  post_processing_shader->set_uniform("blur_kernel", blur_kernel);
+  processing_shader.set_uniform("blur_kernel", blur_kernel);
 }
 
 void PostProcessor::begin_render()
@@ -79,11 +83,13 @@ void PostProcessor::end_render()
 
 void PostProcessor::render(float time)
 {
-  post_processing_shader->bind();
-  post_processing_shader->set_uniform("time", time);
-  post_processing_shader->set_uniform("confuse", confuse);
-  post_processing_shader->set_uniform("chaos", chaos);
-  post_processing_shader->set_uniform("shake", shake);
+  auto &shader = ResourceManager::get_shader(post_processing_shader);
+
+  shader.bind();
+  shader.set_uniform("time", time);
+  shader.set_uniform("confuse", confuse);
+  shader.set_uniform("chaos", chaos);
+  shader.set_uniform("shake", shake);
 
   texture->bind(0);
 
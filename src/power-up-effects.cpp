@@ -0,0 +1,27 @@
+#include "power-up-effects.hpp"
+
+void PowerUpEffects::add(PowerUp::Type type, double deadline)
+{
+  ++counts[static_cast<std::size_t>(type)];
+  deadlines.push({deadline, type});
+}
+
+void PowerUpEffects::expire(
+    double                                     time,
+    const std::function<void(PowerUp::Type)> &on_end)
+{
+  while (!deadlines.empty() && deadlines.top().time <= time)
+  {
+    const auto type = deadlines.top().type;
+    deadlines.pop();
+
+    if (--counts[static_cast<std::size_t>(type)] == 0)
+      on_end(type);
+  }
+}
+
+void PowerUpEffects::clear()
+{
+  counts.fill(0);
+  deadlines = {};
+}
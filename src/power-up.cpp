@@ -0,0 +1,33 @@
+#include "asseration.hpp"
+#include "power-up.hpp"
+
+// Indexed by type, negative power-ups spawn more often
+static const std::array<PowerUpKind, POWER_UP_TYPE_COUNT> POWER_UP_KINDS = {{
+    {glm::vec3(0.5f, 0.5f, 1.0f), 0.0f, 1},    // SPEED
+    {glm::vec3(1.0f, 0.5f, 1.0f), 20.0f, 1},   // STICKY
+    {glm::vec3(0.5f, 1.0f, 0.5f), 10.0f, 1},   // PASS_THROUGH
+    {glm::vec3(1.0f, 0.6f, 0.4f), 0.0f, 1},    // PAD_SIZE_INCREASE
+    {glm::vec3(1.0f, 0.3f, 0.3f), 15.0f, 5},   // CONFUSE
+    {glm::vec3(0.9f, 0.25f, 0.25f), 15.0f, 5}, // CHAOS
+    {glm::vec3(1.0f, 1.0f, 0.5f), 0.0f, 1},    // MULTI_BALL
+}};
+
+const PowerUpKind &get_power_up_kind(PowerUp::Type type)
+{
+  return POWER_UP_KINDS[static_cast<std::size_t>(type)];
+}
+
+bool PowerUpPool::add(PowerUp::Type type, glm::vec2 position)
+{
+  if (count == CAPACITY)
+    return false;
+
+  power_ups[count++] = PowerUp{type, position, position};
+  return true;
+}
+
+void PowerUpPool::remove(std::size_t index)
+{
+  ASSERT(index < count);
+  power_ups[index] = power_ups[--count];
+}
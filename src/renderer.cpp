@@ -28,6 +28,20 @@ void Renderer::set_viewport(const int         x,
   GL_CALL(glViewport(x, y, width, height));
 }
 
+void Renderer::set_scissor(const int         x,
+                           const int         y,
+                           const std::size_t width,
+                           const std::size_t height) const
+{
+  GL_CALL(glEnable(GL_SCISSOR_TEST));
+  GL_CALL(glScissor(x, y, width, height));
+}
+
+void Renderer::disable_scissor() const
+{
+  GL_CALL(glDisable(GL_SCISSOR_TEST));
+}
+
 void Renderer::blit_framebuffer(int        srcx0,
                                 int        srcy0,
                                 int        srcx1,
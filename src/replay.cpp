@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+#include "asseration.hpp"
+#include "mapped-file.hpp"
+#include "replay.hpp"
+
+static const std::uint8_t INPUT_MOVE_LEFT    = 1;
+static const std::uint8_t INPUT_MOVE_RIGHT   = 2;
+static const std::uint8_t INPUT_RELEASE_BALL = 4;
+static const std::uint8_t INPUT_CONFIRM      = 8;
+
+static std::uint8_t pack_input(const GameInput &input)
+{
+  return (input.move_left ? INPUT_MOVE_LEFT : 0) |
+         (input.move_right ? INPUT_MOVE_RIGHT : 0) |
+         (input.release_ball ? INPUT_RELEASE_BALL : 0) |
+         (input.confirm ? INPUT_CONFIRM : 0);
+}
+
+static GameInput unpack_input(std::uint8_t input)
+{
+  GameInput unpacked;
+  unpacked.move_left    = input & INPUT_MOVE_LEFT;
+  unpacked.move_right   = input & INPUT_MOVE_RIGHT;
+  unpacked.release_ball = input & INPUT_RELEASE_BALL;
+  unpacked.confirm      = input & INPUT_CONFIRM;
+  return unpacked;
+}
+
+template <typename T>
+static void append(std::vector<unsigned char> &data, const T &value)
+{
+  const auto bytes = reinterpret_cast<const unsigned char *>(&value);
+  data.insert(data.end(), bytes, bytes + sizeof(value));
+}
+
+template <typename T>
+static T consume(std::span<const unsigned char> &data)
+{
+  if (data.size() < sizeof(T))
+  {
+    throw std::runtime_error("Replay is truncated");
+  }
+
+  T value;
+  std::memcpy(&value, data.data(), sizeof(value));
+  data = data.subspan(sizeof(value));
+  return value;
+}
+
+Replay::Replay(unsigned      width,
+               unsigned      height,
+               float         tick_time,
+               std::uint64_t seed)
+    : width(width),
+      height(height),
+      tick_time(tick_time),
+      seed(seed)
+{
+}
+
+void Replay::add_level(const LevelData &level_data)
+{
+  levels.push_back({tick_count, level_data});
+}
+
+void Replay::add_tick(const GameInput &input)
+{
+  const auto packed_input = pack_input(input);
+  if (!input_runs.empty() && input_runs.back().input == packed_input)
+    ++input_runs.back().length;
+  else
+    input_runs.push_back({packed_input, 1});
+
+  ++tick_count;
+}
+
+Replay Replay::read(std::span<const unsigned char> data)
+{
+  if constexpr (std::endian::native != std::endian::little)
+  {
+    throw std::runtime_error("Replays are only supported on little endian "
+                             "platforms");
+  }
+
+  const auto header = consume<ReplayFileHeader>(data);
+  const auto is_replay =
+      std::memcmp(header.magic, REPLAY_FILE_MAGIC, sizeof(header.magic)) == 0;
+  if (!is_replay || header.version != REPLAY_FILE_VERSION ||
+      header.flags != 0 || !(header.tick_time > 0.0f))
+  {
+    throw std::runtime_error("Unsupported replay");
+  }
+
+  Replay replay(header.width, header.height, header.tick_time, header.seed);
+  replay.checksum = header.checksum;
+
+  for (std::uint32_t i = 0; i < header.level_count; ++i)
+  {
+    const auto level = consume<ReplayFileLevel>(data);
+    if (level.size > data.size() || level.tick > header.tick_count ||
+        (!replay.levels.empty() && level.tick < replay.levels.back().tick))
+    {
+      throw std::runtime_error("Replay has corrupt levels");
+    }
+
+    replay.levels.push_back(
+        {level.tick, LevelData::read_binary(data.first(level.size))});
+    data = data.subspan(level.size);
+  }
+
+  for (std::uint32_t i = 0; i < header.input_run_count; ++i)
+  {
+    const auto run = consume<ReplayFileInputRun>(data);
+    if (run.length == 0)
+    {
+      throw std::runtime_error("Replay has corrupt input");
+    }
+
+    // Runs were split to fit the file, join them again
+    if (!replay.input_runs.empty() &&
+        replay.input_runs.back().input == run.input)
+      replay.input_runs.back().length += run.length;
+    else
+      replay.input_runs.push_back({run.input, run.length});
+
+    replay.tick_count += run.length;
+  }
+
+  if (replay.tick_count != header.tick_count)
+  {
+    throw std::runtime_error("Replay has corrupt input");
+  }
+
+  return replay;
+}
+
+Replay Replay::load(const std::string &file)
+{
+  MappedFile mapped_file(file);
+  return read(mapped_file.data());
+}
+
+std::vector<unsigned char> Replay::to_binary() const
+{
+  ReplayFileHeader header{};
+  std::memcpy(header.magic, REPLAY_FILE_MAGIC, sizeof(header.magic));
+  header.version     = REPLAY_FILE_VERSION;
+  header.seed        = seed;
+  header.checksum    = checksum;
+  header.width       = width;
+  header.height      = height;
+  header.tick_time   = tick_time;
+  header.tick_count  = tick_count;
+  header.level_count = static_cast<std::uint32_t>(levels.size());
+
+  std::vector<unsigned char> data(sizeof(header));
+
+  for (const auto &level : levels)
+  {
+    const auto level_data = level.level_data.to_binary(true);
+    append(data,
+           ReplayFileLevel{level.tick,
+                           static_cast<std::uint32_t>(level_data.size())});
+    data.insert(data.end(), level_data.begin(), level_data.end());
+  }
+
+  constexpr std::uint32_t max_length =
+      std::numeric_limits<decltype(ReplayFileInputRun::length)>::max();
+  for (const auto &run : input_runs)
+  {
+    for (auto length = run.length; length > 0;)
+    {
+      const auto file_length = std::min(length, max_length);
+      append(data,
+             ReplayFileInputRun{run.input,
+                                0,
+                                static_cast<std::uint16_t>(file_length)});
+      length -= file_length;
+      ++header.input_run_count;
+    }
+  }
+
+  std::memcpy(data.data(), &header, sizeof(header));
+  return data;
+}
+
+void Replay::write(const std::string &file) const
+{
+  const auto data = to_binary();
+
+  std::ofstream out(file, std::ios::binary | std::ios::trunc);
+  if (!out)
+  {
+    throw std::runtime_error("Could not open \"" + file + "\" for writing");
+  }
+
+  out.write(reinterpret_cast<const char *>(data.data()),
+            static_cast<std::streamsize>(data.size()));
+
+  if (!out)
+  {
+    throw std::runtime_error("Could not write replay \"" + file + "\"");
+  }
+}
+
+ReplayPlayer::ReplayPlayer(const Replay &replay) : replay(replay) {}
+
+bool ReplayPlayer::tick_simulation(GameSimulation &simulation)
+{
+  ASSERT(!is_done());
+
+  auto level_set = false;
+  for (; level_index < replay.levels.size() &&
+         replay.levels[level_index].tick == tick;
+       ++level_index)
+  {
+    simulation.set_level(replay.levels[level_index].level_data);
+    level_set = true;
+  }
+
+  const auto &run = replay.input_runs[run_index];
+  simulation.tick(replay.get_tick_time(), unpack_input(run.input));
+
+  ++tick;
+  if (++run_tick == run.length)
+  {
+    ++run_index;
+    run_tick = 0;
+  }
+
+  return level_set;
+}
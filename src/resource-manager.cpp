@@ -1,72 +1,81 @@
-#include <fstream>
-
 #include <stb/stb_image.h>
 
+#include "asset-store.hpp"
+#include "cooked-texture.hpp"
+#include "hash.hpp"
+#include "opengl-util.hpp"
 #include "resource-manager.hpp"
 #include "wav-loader.hpp"
 
 static const std::string LOG_TAG = "ResourceManager";
 
-std::unordered_map<std::string, std::shared_ptr<Texture2D>>
-    ResourceManager::textures;
+ResourceRegistry<Shader>      ResourceManager::shaders;
+ResourceRegistry<Texture2D>   ResourceManager::textures;
+ResourceRegistry<AudioBuffer> ResourceManager::audio_buffers;
 
-std::unordered_map<std::string, std::shared_ptr<Shader>>
-    ResourceManager::shaders;
+std::unordered_map<std::string, ShaderHandle> ResourceManager::shader_names;
 
-std::unordered_map<std::string, std::shared_ptr<AudioBuffer>>
-    ResourceManager::audio_buffers;
+std::unordered_map<std::string, TextureHandle>
+    ResourceManager::texture_names;
 
-const std::string ResourceManager::resources_directory = "resources";
+std::unordered_map<std::string, AudioHandle> ResourceManager::audio_names;
 
-std::shared_ptr<Shader>
+ShaderHandle
 ResourceManager::load_shader(const std::string &vertex_shader_file,
                              const std::string &fragment_shader_file,
                              const std::string &geometry_shader_file,
                              const std::string &name)
 {
-  shaders[name] = load_shader_from_file(vertex_shader_file,
-                                        fragment_shader_file,
-                                        geometry_shader_file);
-  return shaders[name];
+  return insert(shaders,
+                shader_names,
+                name,
+                load_shader_from_file(vertex_shader_file,
+                                      fragment_shader_file,
+                                      geometry_shader_file));
 }
 
-std::shared_ptr<Shader>
+ShaderHandle
 ResourceManager::load_shader(const std::string &vertex_shader_file,
                              const std::string &fragment_shader_file,
                              const std::string &name)
 {
-  shaders[name] =
-      load_shader_from_file(vertex_shader_file, fragment_shader_file);
-  return shaders[name];
+  return insert(shaders,
+                shader_names,
+                name,
+                load_shader_from_file(vertex_shader_file,
+                                      fragment_shader_file));
 }
 
-std::shared_ptr<Shader> ResourceManager::get_shader(const std::string &name)
+ShaderHandle ResourceManager::find_shader(const std::string &name)
 {
-  if (shaders.find(name) == shaders.end())
+  const auto it = shader_names.find(name);
+  if (it == shader_names.end())
   {
     throw std::runtime_error("Shader " + name + " not found");
   }
 
-  return shaders[name];
+  return it->second;
 }
 
-std::shared_ptr<Texture2D>
-ResourceManager::load_texture(const std::string &file,
-                              const bool         alpha,
-                              const std::string &name)
+TextureHandle ResourceManager::load_texture(const std::string &file,
+                                            const bool         alpha,
+                                            const std::string &name)
 {
-  textures[name] = load_texture_from_file(file, alpha);
-  return textures[name];
+  return insert(textures,
+                texture_names,
+                name,
+                load_texture_from_file(file, alpha));
 }
 
-std::shared_ptr<Texture2D> ResourceManager::get_texture(const std::string &name)
+TextureHandle ResourceManager::find_texture(const std::string &name)
 {
-  if (textures.find(name) == textures.end())
+  const auto it = texture_names.find(name);
+  if (it == texture_names.end())
   {
     throw std::runtime_error("Texture " + name + " not found");
   }
 
-  return textures[name];
+  return it->second;
 }
 
 void ResourceManager::clear()
@@ -74,139 +83,308 @@ void ResourceManager::clear()
   textures.clear();
   shaders.clear();
   audio_buffers.clear();
+
+  texture_names.clear();
+  shader_names.clear();
+  audio_names.clear();
 }
 
-std::shared_ptr<Shader>
+std::unique_ptr<Shader>
 ResourceManager::load_shader_from_file(const std::string &vertex_shader_file,
                                        const std::string &fragment_shader_file,
                                        const std::string &geometry_shader_file)
 {
-  std::string vertex_code;
-  std::string fragment_code;
-  std::string geometry_code;
-
-  std::ifstream vertex_shader_file_stream(
-      (resources_directory + "/" + vertex_shader_file));
+  return create_shader(read_shader_sources(vertex_shader_file,
+                                           fragment_shader_file,
+                                           geometry_shader_file));
+}
 
-  Log().i(LOG_TAG) << "Load vertex shader from file: "
-                   << (resources_directory + "/" + vertex_shader_file);
+ResourceManager::ShaderSources
+ResourceManager::read_shader_sources(const std::string &vertex_shader_file,
+                                     const std::string &fragment_shader_file,
+                                     const std::string &geometry_shader_file)
+{
+  Log().i(LOG_TAG) << "Load vertex shader from file: " << vertex_shader_file;
 
-  std::ifstream fragment_shader_file_stream(
-      (resources_directory + "/" + fragment_shader_file));
+  auto vertex_shader = AssetStore::read(vertex_shader_file);
 
   Log().i(LOG_TAG) << "Load fragment shader from file: "
-                   << (resources_directory + "/" + fragment_shader_file);
-
-  std::stringstream vertex_shader_stream, fragment_shader_stream;
-  // read file's buffer contents into streams
-  vertex_shader_stream << vertex_shader_file_stream.rdbuf();
-  fragment_shader_stream << fragment_shader_file_stream.rdbuf();
-  // close file handlers
-  vertex_shader_file_stream.close();
-  fragment_shader_file_stream.close();
-  // convert stream into string
-  vertex_code   = vertex_shader_stream.str();
-  fragment_code = fragment_shader_stream.str();
+                   << fragment_shader_file;
+
+  auto fragment_shader = AssetStore::read(fragment_shader_file);
+
+  ShaderSources sources{std::move(vertex_shader),
+                        std::move(fragment_shader),
+                        std::nullopt};
+
   // if geometry shader path is present, also load a geometry shader
   if (geometry_shader_file != "")
   {
-    std::ifstream geometry_shader_file_stream(
-        (resources_directory + "/" + geometry_shader_file));
-
     Log().i(LOG_TAG) << "Load geometry shader from file: "
-                     << (resources_directory + "/" + geometry_shader_file);
+                     << geometry_shader_file;
 
-    std::stringstream geometry_shader_stream;
-    geometry_shader_stream << geometry_shader_file_stream.rdbuf();
-    geometry_shader_file_stream.close();
-    geometry_code = geometry_shader_stream.str();
+    sources.geometry_shader.emplace(AssetStore::read(geometry_shader_file));
   }
 
-  return std::make_shared<Shader>(vertex_code, fragment_code, geometry_code);
+  return sources;
 }
 
-std::shared_ptr<Texture2D>
+std::unique_ptr<Shader>
+ResourceManager::create_shader(const ShaderSources &sources)
+{
+  if (sources.geometry_shader)
+  {
+    return std::make_unique<Shader>(sources.vertex_shader.as_string(),
+                                    sources.fragment_shader.as_string(),
+                                    sources.geometry_shader->as_string());
+  }
+
+  return std::make_unique<Shader>(sources.vertex_shader.as_string(),
+                                  sources.fragment_shader.as_string());
+}
+
+std::unique_ptr<Texture2D>
 ResourceManager::load_texture_from_file(const std::string &file,
                                         const bool         alpha)
 {
-  unsigned internal_format = GL_RGB;
-  unsigned image_format    = GL_RGB;
+  auto data = decode_texture(file, supports_compressed_textures());
+  return create_texture(data, alpha);
+}
 
-  if (alpha)
+ResourceManager::TextureData
+ResourceManager::decode_texture(const std::string &file,
+                                const bool         use_compressed)
+{
+  const auto cooked_file = file + COOKED_TEXTURE_EXTENSION;
+  if (AssetStore::exists(cooked_file))
   {
-    internal_format = GL_RGBA;
-    image_format    = GL_RGBA;
+    auto data = decode_cooked_texture(file,
+                                      AssetStore::read(cooked_file),
+                                      use_compressed);
+    if (data)
+      return std::move(*data);
   }
 
-  Log().i(LOG_TAG) << "Load texture from file: "
-                   << (resources_directory + "/" + file);
+  return decode_source_texture(file, AssetStore::read(file));
+}
 
-  int            width, height, nrChannels;
-  unsigned char *data = stbi_load((resources_directory + "/" + file).c_str(),
-                                  &width,
-                                  &height,
-                                  &nrChannels,
-                                  0);
+std::optional<ResourceManager::TextureData>
+ResourceManager::decode_cooked_texture(const std::string &file,
+                                       Asset              cooked_asset,
+                                       const bool         use_compressed)
+{
+  const auto    cooked_file = file + COOKED_TEXTURE_EXTENSION;
+  CookedTexture cooked(cooked_asset.data());
 
-  const auto texture = std::make_shared<Texture2D>(width,
-                                                   height,
-                                                   data,
-                                                   internal_format,
-                                                   image_format);
+  // Catch cooked textures that were not rebuilt after editing the
+  // source, in release builds too, so a stale one is never shipped
+  if (AssetStore::exists(file) &&
+      hash_fnv1a(AssetStore::read(file).data()) != cooked.get_source_hash())
+  {
+    Log().w(LOG_TAG) << "Cooked texture " << cooked_file
+                     << " is stale, decoding " << file;
+    return std::nullopt;
+  }
 
-  stbi_image_free(data);
+  if (cooked.is_compressed() && !use_compressed)
+  {
+    Log().w(LOG_TAG) << "S3TC is not supported, decoding " << file;
+    return std::nullopt;
+  }
+
+  Log().i(LOG_TAG) << "Load cooked texture: " << cooked_file << " ("
+                   << cooked.get_levels().size() << " levels)";
+
+  // The levels point into the asset, which keeps its data on a move
+  TextureData data;
+  data.cooked_asset.emplace(std::move(cooked_asset));
+  data.cooked.emplace(std::move(cooked));
+  return data;
+}
+
+ResourceManager::TextureData
+ResourceManager::decode_source_texture(const std::string &file,
+                                       const Asset &      asset)
+{
+  Log().i(LOG_TAG) << "Load texture from file: " << file;
+
+  TextureData data;
+
+  int nrChannels;
+  data.pixels = {stbi_load_from_memory(asset.data().data(),
+                                       static_cast<int>(asset.data().size()),
+                                       &data.width,
+                                       &data.height,
+                                       &nrChannels,
+                                       0),
+                 stbi_image_free};
+  if (!data.pixels)
+  {
+    throw std::runtime_error("Could not load texture \"" + file +
+                             "\": " + stbi_failure_reason());
+  }
 
-  return texture;
+  return data;
 }
 
-std::shared_ptr<AudioBuffer>
-ResourceManager::load_audio(const std::string &audio_file,
-                            const std::string &name)
+std::unique_ptr<Texture2D>
+ResourceManager::create_texture(const TextureData &data, const bool alpha)
 {
-  const auto real_audio_file = (resources_directory + "/" + audio_file);
+  if (data.cooked)
+    return std::make_unique<Texture2D>(*data.cooked);
 
-  Log().i(LOG_TAG) << "Load audio from file: " << real_audio_file;
+  unsigned internal_format = GL_RGB;
+  unsigned image_format    = GL_RGB;
 
-  if (audio_buffers.find(name) != audio_buffers.end())
+  if (alpha)
   {
-    return audio_buffers[name];
+    internal_format = GL_RGBA;
+    image_format    = GL_RGBA;
   }
 
-  auto wav_file = load_wav(real_audio_file);
+  return std::make_unique<Texture2D>(data.width,
+                                     data.height,
+                                     data.pixels.get(),
+                                     internal_format,
+                                     image_format);
+}
+
+bool ResourceManager::supports_compressed_textures()
+{
+  static const bool has_s3tc =
+      gl_has_extension("GL_EXT_texture_compression_s3tc");
+  return has_s3tc;
+}
+
+AudioHandle ResourceManager::load_audio(const std::string &audio_file,
+                                        const std::string &name)
+{
+  Log().i(LOG_TAG) << "Load audio from file: " << audio_file;
+
+  const auto asset = AssetStore::read(audio_file);
+  const auto wav   = view_wav(audio_file, asset.data());
+
+  return insert(audio_buffers, audio_names, name, create_audio_buffer(wav));
+}
 
+std::unique_ptr<AudioBuffer>
+ResourceManager::create_audio_buffer(const WavView &wav)
+{
   // Determine format
   AudioBuffer::Format format;
-  if (wav_file.channels == 1 && wav_file.bits_per_sample == 8)
+  if (wav.channels == 1 && wav.bits_per_sample == 8)
     format = AudioBuffer::Format::MONO8;
-  else if (wav_file.channels == 1 && wav_file.bits_per_sample == 16)
+  else if (wav.channels == 1 && wav.bits_per_sample == 16)
     format = AudioBuffer::Format::MONO16;
-  else if (wav_file.channels == 2 && wav_file.bits_per_sample == 8)
+  else if (wav.channels == 2 && wav.bits_per_sample == 8)
     format = AudioBuffer::Format::STEREO8;
-  else if (wav_file.channels == 2 && wav_file.bits_per_sample == 16)
+  else if (wav.channels == 2 && wav.bits_per_sample == 16)
     format = AudioBuffer::Format::STEREO16;
   else
   {
     throw std::runtime_error(
-        "Unrecognised wave format: " + std::to_string(wav_file.channels) +
-        " channels, " + std::to_string(wav_file.bits_per_sample) + " bps");
+        "Unrecognised wave format: " + std::to_string(wav.channels) +
+        " channels, " + std::to_string(wav.bits_per_sample) + " bps");
   }
 
-  auto audio_buffer = std::make_shared<AudioBuffer>(format,
-                                                    wav_file.data,
-                                                    wav_file.sample_rate,
-                                                    wav_file.size);
+  // The samples go to AL straight from the asset
+  return std::make_unique<AudioBuffer>(format, wav.samples, wav.sample_rate);
+}
 
-  audio_buffers[name] = audio_buffer;
+AudioHandle ResourceManager::find_audio(const std::string &name)
+{
+  const auto it = audio_names.find(name);
+  if (it == audio_names.end())
+  {
+    throw std::runtime_error("Audio buffer " + name + " not found");
+  }
 
-  return audio_buffer;
+  return it->second;
+}
+
+Task<ShaderHandle>
+ResourceManager::load_shader_async(LoadContext context,
+                                   std::string vertex_shader_file,
+                                   std::string fragment_shader_file,
+                                   std::string name)
+{
+  Log().i(LOG_TAG) << "Load shaders from files: " << vertex_shader_file << ", "
+                   << fragment_shader_file;
+
+  // Submit both reads before waiting for either of them
+  std::optional<Asset>    vertex_asset;
+  std::optional<Asset>    fragment_asset;
+  std::vector<Task<void>> reads;
+  reads.push_back(read_into(
+      AssetStore::read_async(context.files, std::move(vertex_shader_file)),
+      vertex_asset));
+  reads.push_back(read_into(
+      AssetStore::read_async(context.files, std::move(fragment_shader_file)),
+      fragment_asset));
+  co_await when_all(std::move(reads));
+
+  const ShaderSources sources{std::move(*vertex_asset),
+                              std::move(*fragment_asset),
+                              std::nullopt};
+
+  co_await context.uploads.schedule();
+  co_return insert(shaders, shader_names, name, create_shader(sources));
 }
 
-std::shared_ptr<AudioBuffer> ResourceManager::get_audio(const std::string &name)
+Task<TextureHandle> ResourceManager::load_texture_async(LoadContext context,
+                                                        std::string file,
+                                                        bool        alpha,
+                                                        std::string name)
 {
-  if (audio_buffers.find(name) == audio_buffers.end())
+  // Query the context before leaving the thread that owns it
+  const auto use_compressed = supports_compressed_textures();
+
+  const auto cooked_file = file + COOKED_TEXTURE_EXTENSION;
+  if (AssetStore::exists(cooked_file))
   {
-    throw std::runtime_error("Audio buffer " + name + " not found");
+    auto cooked_asset =
+        co_await AssetStore::read_async(context.files, cooked_file);
+
+    co_await context.workers.schedule();
+    const auto cooked =
+        decode_cooked_texture(file, std::move(cooked_asset), use_compressed);
+
+    if (cooked)
+    {
+      co_await context.uploads.schedule();
+      co_return insert(textures,
+                       texture_names,
+                       name,
+                       create_texture(*cooked, alpha));
+    }
   }
 
-  return audio_buffers[name];
+  const auto asset = co_await AssetStore::read_async(context.files, file);
+
+  co_await context.workers.schedule();
+  const auto data = decode_source_texture(file, asset);
+
+  co_await context.uploads.schedule();
+  co_return insert(textures, texture_names, name, create_texture(data, alpha));
+}
+
+Task<AudioHandle> ResourceManager::load_audio_async(LoadContext context,
+                                                    std::string audio_file,
+                                                    std::string name)
+{
+  Log().i(LOG_TAG) << "Load audio from file: " << audio_file;
+  const auto asset = co_await AssetStore::read_async(context.files, audio_file);
+
+  // Parsing only walks the chunk headers, which is not worth a hop to
+  // the workers
+  const auto wav = view_wav(audio_file, asset.data());
+
+  co_await context.uploads.schedule();
+  co_return insert(audio_buffers, audio_names, name, create_audio_buffer(wav));
+}
+
+Task<void> ResourceManager::read_into(Task<Asset>           read,
+                                      std::optional<Asset> &asset)
+{
+  asset.emplace(co_await read);
 }
@@ -3,20 +3,25 @@
 
 const std::string Shader::LOG_TAG = "Shader";
 
-Shader::Shader(const std::string &vertexShaderProgram,
-               const std::string &fragmentShaderProgram,
-               const std::string &geometryShaderProgram)
+Shader::Shader(std::string_view vertexShaderProgram,
+               std::string_view fragmentShaderProgram,
+               std::string_view geometryShaderProgram)
 {
   unsigned int vertexShaderId = 0, fragmentShaderId = 0, geometryShaderId = 0;
   vertexShaderId            = glCreateShader(GL_VERTEX_SHADER);
-  auto vertexShaderCodeCStr = vertexShaderProgram.c_str();
-  glShaderSource(vertexShaderId, 1, &vertexShaderCodeCStr, NULL);
+  auto vertexShaderCodeCStr = vertexShaderProgram.data();
+  auto vertexShaderLength   = static_cast<GLint>(vertexShaderProgram.size());
+  glShaderSource(vertexShaderId, 1, &vertexShaderCodeCStr, &vertexShaderLength);
   glCompileShader(vertexShaderId);
   check_for_compile_errors(vertexShaderId, ShaderType::VERTEX);
 
   fragmentShaderId            = glCreateShader(GL_FRAGMENT_SHADER);
-  auto fragmentShaderCodeCStr = fragmentShaderProgram.c_str();
-  glShaderSource(fragmentShaderId, 1, &fragmentShaderCodeCStr, NULL);
+  auto fragmentShaderCodeCStr = fragmentShaderProgram.data();
+  auto fragmentShaderLength = static_cast<GLint>(fragmentShaderProgram.size());
+  glShaderSource(fragmentShaderId,
+                 1,
+                 &fragmentShaderCodeCStr,
+                 &fragmentShaderLength);
   glCompileShader(fragmentShaderId);
   check_for_compile_errors(fragmentShaderId, ShaderType::FRAGMENT);
 
@@ -27,8 +32,13 @@ Shader::Shader(const std::string &vertexShaderProgram,
   if (!geometryShaderProgram.empty())
   {
     geometryShaderId            = glCreateShader(GL_GEOMETRY_SHADER);
-    auto geometryShaderCodeCStr = geometryShaderProgram.c_str();
-    glShaderSource(geometryShaderId, 1, &geometryShaderCodeCStr, NULL);
+    auto geometryShaderCodeCStr = geometryShaderProgram.data();
+    auto geometryShaderLength =
+        static_cast<GLint>(geometryShaderProgram.size());
+    glShaderSource(geometryShaderId,
+                   1,
+                   &geometryShaderCodeCStr,
+                   &geometryShaderLength);
     glCompileShader(geometryShaderId);
     check_for_compile_errors(geometryShaderId, ShaderType::GEOMETRY);
     glAttachShader(id, geometryShaderId);
@@ -1,21 +1,37 @@
 #include "sprite-renderer.hpp"
+#include "resource-manager.hpp"
 
 static const std::string LOG_TAG = "SpriteRenderer";
 
 SpriteRenderer::SpriteRenderer(const std::shared_ptr<Renderer> renderer,
-                               const std::shared_ptr<Shader>   shader)
+                               const ShaderHandle              shader)
     : renderer(renderer), shader(shader)
 {
   init_render_data();
 }
 
-void SpriteRenderer::draw_sprite(const std::shared_ptr<Texture2D> texture,
-                                 const glm::vec2 &                position,
-                                 const glm::vec2 &                size,
-                                 const float                      rotate,
-                                 const glm::vec3 &                color)
+void SpriteRenderer::draw_sprite(const TextureHandle texture,
+                                 const glm::vec2 &   position,
+                                 const glm::vec2 &   size,
+                                 const float         rotate,
+                                 const glm::vec3 &   color)
 {
-  shader->bind();
+  draw_sprite(ResourceManager::get_texture(texture),
+              position,
+              size,
+              rotate,
+              color);
+}
+
+void SpriteRenderer::draw_sprite(const Texture2D &texture,
+                                 const glm::vec2 &position,
+                                 const glm::vec2 &size,
+                                 const float      rotate,
+                                 const glm::vec3 &color)
+{
+  auto &sprite_shader = ResourceManager::get_shader(shader);
+
+  sprite_shader.bind();
 
   glm::mat4 model = glm::mat4(1.0f);
   model           = glm::translate(model, glm::vec3(position, 0.0f));
@@ -30,10 +46,10 @@ void SpriteRenderer::draw_sprite(const std::shared_ptr<Texture2D> texture,
 
   model = glm::scale(model, glm::vec3(size, 1.0f));
 
-  shader->set_uniform("model_matrix", model);
-  shader->set_uniform("sprite_color", color);
+  sprite_shader.set_uniform("model_matrix", model);
+  sprite_shader.set_uniform("sprite_color", color);
 
-  texture->bind();
+  texture.bind();
 
   renderer->draw(vertex_array);
 }
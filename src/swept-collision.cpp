@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+
+#include "swept-collision.hpp"
+
+// Normal of the box face closest to a point inside the box
+static glm::vec2 get_closest_face_normal(glm::vec2 point,
+                                         glm::vec2 box_min,
+                                         glm::vec2 box_max)
+{
+  const float distances[] = {point.x - box_min.x,
+                             box_max.x - point.x,
+                             point.y - box_min.y,
+                             box_max.y - point.y};
+  const glm::vec2 normals[] = {glm::vec2(-1.0f, 0.0f),
+                               glm::vec2(1.0f, 0.0f),
+                               glm::vec2(0.0f, -1.0f),
+                               glm::vec2(0.0f, 1.0f)};
+
+  const auto closest =
+      std::min_element(std::begin(distances), std::end(distances));
+  return normals[closest - std::begin(distances)];
+}
+
+static std::optional<SweepHit> sweep_circle_point(glm::vec2 center,
+                                                  float     radius,
+                                                  glm::vec2 motion,
+                                                  glm::vec2 point)
+{
+  const auto offset = center - point;
+  const auto b      = glm::dot(offset, motion);
+  if (b >= 0.0f)
+    return std::nullopt;
+
+  const auto a            = glm::dot(motion, motion);
+  const auto c            = glm::dot(offset, offset) - radius * radius;
+  const auto discriminant = b * b - a * c;
+  if (discriminant < 0.0f)
+    return std::nullopt;
+
+  const auto time = std::max((-b - std::sqrt(discriminant)) / a, 0.0f);
+  if (time > 1.0f)
+    return std::nullopt;
+
+  return SweepHit{time, glm::normalize(offset + motion * time)};
+}
+
+std::optional<SweepHit> sweep_circle_box(glm::vec2 center,
+                                         float     radius,
+                                         glm::vec2 motion,
+                                         glm::vec2 box_min,
+                                         glm::vec2 box_max)
+{
+  // Already overlapping, only a hit if the circle moves further in
+  const auto closest    = glm::clamp(center, box_min, box_max);
+  const auto difference = center - closest;
+  const auto distance_squared = glm::dot(difference, difference);
+  if (distance_squared < radius * radius)
+  {
+    const auto normal =
+        distance_squared > 0.0f
+            ? difference / std::sqrt(distance_squared)
+            : get_closest_face_normal(center, box_min, box_max);
+    if (glm::dot(motion, normal) >= 0.0f)
+      return std::nullopt;
+
+    return SweepHit{0.0f, normal};
+  }
+
+  if (motion == glm::vec2(0.0f))
+    return std::nullopt;
+
+  // Slab test of the motion against the box grown by the radius
+  const glm::vec2 grown_min = box_min - radius;
+  const glm::vec2 grown_max = box_max + radius;
+
+  auto      enter_time = -std::numeric_limits<float>::infinity();
+  auto      exit_time  = 1.0f;
+  glm::vec2 normal(0.0f);
+  for (int axis = 0; axis < 2; ++axis)
+  {
+    if (motion[axis] == 0.0f)
+    {
+      if (center[axis] < grown_min[axis] || center[axis] > grown_max[axis])
+        return std::nullopt;
+      continue;
+    }
+
+    auto near_time = (grown_min[axis] - center[axis]) / motion[axis];
+    auto far_time  = (grown_max[axis] - center[axis]) / motion[axis];
+    auto side      = -1.0f;
+    if (near_time > far_time)
+    {
+      std::swap(near_time, far_time);
+      side = 1.0f;
+    }
+
+    if (near_time > enter_time)
+    {
+      enter_time   = near_time;
+      normal       = glm::vec2(0.0f);
+      normal[axis] = side;
+    }
+    exit_time = std::min(exit_time, far_time);
+    if (enter_time > exit_time || exit_time <= 0.0f)
+      return std::nullopt;
+  }
+
+  // Outside the face regions the grown box has rounded corners
+  const auto time    = std::max(enter_time, 0.0f);
+  const auto contact = center + motion * time;
+  const auto is_beyond_x = contact.x < box_min.x || contact.x > box_max.x;
+  const auto is_beyond_y = contact.y < box_min.y || contact.y > box_max.y;
+  if (is_beyond_x && is_beyond_y)
+  {
+    const glm::vec2 corner(contact.x < box_min.x ? box_min.x : box_max.x,
+                           contact.y < box_min.y ? box_min.y : box_max.y);
+    return sweep_circle_point(center, radius, motion, corner);
+  }
+
+  return SweepHit{time, normal};
+}
+
+std::optional<SweepHit> sweep_circle_plane(glm::vec2 center,
+                                           float     radius,
+                                           glm::vec2 motion,
+                                           glm::vec2 point,
+                                           glm::vec2 normal)
+{
+  const auto approach = glm::dot(motion, normal);
+  if (approach >= 0.0f)
+    return std::nullopt;
+
+  const auto distance = glm::dot(center - point, normal) - radius;
+  const auto time     = std::max(distance / -approach, 0.0f);
+  if (time > 1.0f)
+    return std::nullopt;
+
+  return SweepHit{time, normal};
+}
+
+glm::vec2 reflect_velocity(glm::vec2 velocity, glm::vec2 normal)
+{
+  return velocity - 2.0f * glm::dot(velocity, normal) * normal;
+}
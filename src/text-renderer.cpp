@@ -1,23 +1,26 @@
 #include "text-renderer.hpp"
+#include "asset-store.hpp"
 #include "freetype.hpp"
+#include "resource-manager.hpp"
 
 const static std::string LOG_TAG = "TextRenderer";
 
 TextRenderer::TextRenderer(const std::shared_ptr<Renderer> renderer,
-                           const std::shared_ptr<Shader>   text_shader,
+                           const ShaderHandle              text_shader,
                            unsigned                        width,
                            unsigned                        height)
     : renderer(renderer),
       text_shader(text_shader)
 {
+  auto &shader = ResourceManager::get_shader(this->text_shader);
 
-  this->text_shader->bind();
-  this->text_shader->set_uniform("projection_matrix",
-                                 glm::ortho(0.0f,
-                                            static_cast<float>(width),
-                                            static_cast<float>(height),
-                                            0.0f));
-  this->text_shader->set_uniform("text", 0);
+  shader.bind();
+  shader.set_uniform("projection_matrix",
+                     glm::ortho(0.0f,
+                                static_cast<float>(width),
+                                static_cast<float>(height),
+                                0.0f));
+  shader.set_uniform("text", 0);
 
   // Configure vertex array for texture quads
   vertex_buffer = std::make_unique<VertexBuffer>(sizeof(float) * 6 * 4);
@@ -30,33 +33,44 @@ TextRenderer::TextRenderer(const std::shared_ptr<Renderer> renderer,
 
 void TextRenderer::load(const std::string font, unsigned int fontSize)
 {
-  // First clear the previously loaded Characters
-  characters.clear();
+  load(rasterize(font, fontSize));
+}
 
-  // Then initialize and load the FreeType library
+std::vector<Glyph> TextRenderer::rasterize(const std::string &font,
+                                           unsigned           font_size)
+{
+  return rasterize(AssetStore::read(font), font_size);
+}
+
+std::vector<Glyph> TextRenderer::rasterize(const Asset &font_asset,
+                                           unsigned     font_size)
+{
+  // Initialize and load the FreeType library. Each call has its own
+  // library instance, so fonts can be rasterized on several threads.
   FT_Library ft;
   if (FT_Init_FreeType(&ft))
   {
     throw std::runtime_error("Could not init FreeType Library");
   }
 
-  // Load font as face
+  // Load font as face. The face reads from the asset until it is done
   FT_Face face;
-  if (FT_New_Face(ft, ("resources/" + font).c_str(), 0, &face))
+  if (FT_New_Memory_Face(ft,
+                         font_asset.data().data(),
+                         static_cast<FT_Long>(font_asset.data().size()),
+                         0,
+                         &face))
   {
+    FT_Done_FreeType(ft);
     throw std::runtime_error("Failed to load font");
   }
 
   // Set size to load glyphs as
-  FT_Set_Pixel_Sizes(face, 0, fontSize);
+  FT_Set_Pixel_Sizes(face, 0, font_size);
 
-  // Disable byte-alignment restriction
-  // TODO: Move this to renderer
-  GL_CALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
-
-  // Then for the first 128 ASCII characters, pre-load/compile their
-  // characters and store them
-  for (GLubyte c = 0; c < 128; ++c)
+  // Then for the first 128 ASCII characters, rasterize their glyphs
+  std::vector<Glyph> glyphs;
+  for (unsigned char c = 0; c < 128; ++c)
   {
     // Load character glyph
     if (FT_Load_Char(face, c, FT_LOAD_RENDER))
@@ -65,28 +79,49 @@ void TextRenderer::load(const std::string font, unsigned int fontSize)
       continue;
     }
 
+    const auto &bitmap = face->glyph->bitmap;
+    glyphs.push_back(
+        {static_cast<char>(c),
+         std::vector<unsigned char>(bitmap.buffer,
+                                    bitmap.buffer + bitmap.width * bitmap.rows),
+         glm::ivec2(bitmap.width, bitmap.rows),
+         glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
+         face->glyph->advance.x});
+  }
+
+  // Destroy FreeType once we're finished
+  FT_Done_Face(face);
+  FT_Done_FreeType(ft);
+
+  return glyphs;
+}
+
+void TextRenderer::load(const std::vector<Glyph> &glyphs)
+{
+  // First clear the previously loaded Characters
+  characters.clear();
+
+  // Disable byte-alignment restriction
+  // TODO: Move this to renderer
+  GL_CALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+
+  for (const auto &glyph : glyphs)
+  {
     // Generate texture
-    auto texture = std::make_shared<Texture2D>(face->glyph->bitmap.width,
-                                               face->glyph->bitmap.rows,
-                                               face->glyph->bitmap.buffer,
+    auto texture = std::make_shared<Texture2D>(glyph.size.x,
+                                               glyph.size.y,
+                                               glyph.bitmap.data(),
                                                GL_RED,
                                                GL_RED,
                                                GL_CLAMP_TO_EDGE,
                                                GL_CLAMP_TO_EDGE);
 
     // Now store character for later use
-    auto character = std::make_shared<Character>(
-        texture,
-        glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
-        glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-        face->glyph->advance.x);
-
-    characters[c] = character;
+    characters[glyph.character] = std::make_shared<Character>(texture,
+                                                              glyph.size,
+                                                              glyph.bearing,
+                                                              glyph.advance);
   }
-
-  // Destroy FreeType once we're finished
-  FT_Done_Face(face);
-  FT_Done_FreeType(ft);
 }
 
 void TextRenderer::render_text(const std::string &text,
@@ -96,9 +131,11 @@ void TextRenderer::render_text(const std::string &text,
                                glm::vec3          color)
 {
   // Activate corresponding render state
-  text_shader->bind();
+  auto &shader = ResourceManager::get_shader(this->text_shader);
+
+  shader.bind();
 
-  text_shader->set_uniform("text_color", color);
+  shader.set_uniform("text_color", color);
 
   // glBindVertexArray(this->VAO);
 
@@ -2,6 +2,14 @@
 #include "log.hpp"
 #include "opengl-util.hpp"
 
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
 static const std::string LOG_TAG = "Texture2D";
 
 Texture2D::Texture2D(const unsigned       width,
@@ -24,6 +32,46 @@ Texture2D::Texture2D(const unsigned       width,
   generate(data);
 }
 
+Texture2D::Texture2D(const CookedTexture &cooked,
+                     unsigned             wrap_s,
+                     unsigned             wrap_t)
+    : wrap_s(wrap_s),
+      wrap_t(wrap_t),
+      filter_min(cooked.get_levels().size() > 1 ? GL_LINEAR_MIPMAP_LINEAR
+                                                : GL_LINEAR),
+      filter_max(GL_LINEAR)
+{
+  const auto &levels = cooked.get_levels();
+  if (!levels.empty())
+  {
+    width  = levels[0].width;
+    height = levels[0].height;
+  }
+
+  switch (cooked.get_format())
+  {
+  case CookedTexture::Format::RGB8:
+    internal_format = GL_RGB;
+    image_format    = GL_RGB;
+    break;
+  case CookedTexture::Format::RGBA8:
+    internal_format = GL_RGBA;
+    image_format    = GL_RGBA;
+    break;
+  case CookedTexture::Format::BC1:
+    internal_format = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    image_format    = GL_RGB;
+    break;
+  case CookedTexture::Format::BC3:
+    internal_format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    image_format    = GL_RGBA;
+    break;
+  }
+
+  GL_CALL(glGenTextures(1, &this->id));
+  generate(cooked);
+}
+
 Texture2D::~Texture2D()
 {
   Log().d(LOG_TAG) << "Delete 2d texture with id: " << id;
@@ -55,6 +103,61 @@ void Texture2D::generate(const unsigned char *data)
   unbind();
 }
 
+void Texture2D::generate(const CookedTexture &cooked)
+{
+  bind();
+
+  // Uncompressed RGB rows are tightly packed
+  GLint unpack_alignment = 4;
+  GL_CALL(glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpack_alignment));
+  GL_CALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+
+  const auto &levels = cooked.get_levels();
+  for (std::size_t i = 0; i < levels.size(); ++i)
+  {
+    const auto &level = levels[i];
+    if (cooked.is_compressed())
+    {
+      GL_CALL(
+          glCompressedTexImage2D(GL_TEXTURE_2D,
+                                 static_cast<GLint>(i),
+                                 this->internal_format,
+                                 level.width,
+                                 level.height,
+                                 0,
+                                 static_cast<GLsizei>(level.data.size()),
+                                 level.data.data()));
+    }
+    else
+    {
+      GL_CALL(glTexImage2D(GL_TEXTURE_2D,
+                           static_cast<GLint>(i),
+                           this->internal_format,
+                           level.width,
+                           level.height,
+                           0,
+                           this->image_format,
+                           GL_UNSIGNED_BYTE,
+                           level.data.data()));
+    }
+  }
+
+  GL_CALL(glPixelStorei(GL_UNPACK_ALIGNMENT, unpack_alignment));
+
+  // Only the uploaded levels take part in sampling
+  const auto max_level = levels.empty() ? 0 : levels.size() - 1;
+  GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0));
+  GL_CALL(glTexParameteri(
+      GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(max_level)));
+
+  GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap_s));
+  GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap_t));
+  GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter_min));
+  GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter_max));
+
+  unbind();
+}
+
 void Texture2D::bind(unsigned slot) const
 {
   GL_CALL(glActiveTexture(GL_TEXTURE0 + slot));
@@ -0,0 +1,46 @@
+#include "thread-pool.hpp"
+
+ThreadPool::ThreadPool(unsigned thread_count)
+{
+  for (unsigned i = 0; i < thread_count; ++i)
+    threads.emplace_back(&ThreadPool::work, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  condition.notify_all();
+
+  for (auto &thread : threads)
+    thread.join();
+}
+
+void ThreadPool::post(std::function<void()> job)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    jobs.push(std::move(job));
+  }
+  condition.notify_one();
+}
+
+void ThreadPool::work()
+{
+  while (true)
+  {
+    std::function<void()> job;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      condition.wait(lock, [this]() { return stopping || !jobs.empty(); });
+      if (jobs.empty())
+        return;
+
+      job = std::move(jobs.front());
+      jobs.pop();
+    }
+    job();
+  }
+}
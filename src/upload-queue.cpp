@@ -0,0 +1,42 @@
+#include "upload-queue.hpp"
+
+std::size_t UploadQueue::drain(std::chrono::microseconds budget)
+{
+  const auto  deadline = std::chrono::steady_clock::now() + budget;
+  std::size_t count    = 0;
+
+  std::coroutine_handle<> handle;
+  while (pop(handle))
+  {
+    handle.resume();
+    ++count;
+
+    if (std::chrono::steady_clock::now() >= deadline)
+      break;
+  }
+
+  return count;
+}
+
+bool UploadQueue::is_empty()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return handles.empty();
+}
+
+void UploadQueue::push(std::coroutine_handle<> handle)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  handles.push_back(handle);
+}
+
+bool UploadQueue::pop(std::coroutine_handle<> &handle)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  if (handles.empty())
+    return false;
+
+  handle = handles.front();
+  handles.pop_front();
+  return true;
+}
@@ -1,187 +1,89 @@
-/**
- * Code stolen from:
- * https://indiegamedev.net/2020/02/15/the-complete-guide-to-openal-with-c-part-1-playing-a-sound/
- */
-
-#include <bit>
+#include <algorithm>
 #include <cstring>
-#include <fstream>
+#include <optional>
+#include <stdexcept>
 
-#include "log.hpp"
 #include "wav-loader.hpp"
 
-static const std::string LOG_TAG = "WavLoader";
+static const std::uint16_t WAVE_FORMAT_PCM        = 0x0001;
+static const std::uint16_t WAVE_FORMAT_EXTENSIBLE = 0xfffe;
+
+// Size of the fmt chunk up to and including the bits per sample
+static const std::size_t PCM_FORMAT_SIZE = 16;
 
-static std::int32_t convert_to_int(char *buffer, std::size_t len)
+// Offset of the sub format in an extensible fmt chunk, its first two
+// bytes are the format tag of the samples
+static const std::size_t SUB_FORMAT_OFFSET = 24;
+
+static std::uint32_t read_le(std::span<const unsigned char> data,
+                             std::size_t                    offset,
+                             std::size_t                    length)
 {
-  std::int32_t a = 0;
-  if (std::endian::native == std::endian::little)
-    std::memcpy(&a, buffer, len);
-  else
-    for (std::size_t i = 0; i < len; ++i)
-      reinterpret_cast<char *>(&a)[3 - i] = buffer[i];
-  return a;
+  std::uint32_t value = 0;
+  for (std::size_t i = 0; i < length; ++i)
+    value |= std::uint32_t(data[offset + i]) << (8 * i);
+  return value;
 }
 
-static bool load_wav_file_header(std::ifstream &file,
-                                 std::uint8_t & channels,
-                                 std::int32_t & sampleRate,
-                                 std::uint8_t & bitsPerSample,
-                                 std::size_t &  size)
+static bool has_id(std::span<const unsigned char> data,
+                   std::size_t                    offset,
+                   const char *                   id)
 {
-  char buffer[4];
-  if (!file.is_open())
-    return false;
-
-  // the RIFF
-  if (!file.read(buffer, 4))
-  {
-    Log().e(LOG_TAG) << "could not read RIFF";
-    return false;
-  }
-  if (std::strncmp(buffer, "RIFF", 4) != 0)
-  {
-    Log().e(LOG_TAG) << "file is not a valid WAVE file (header doesn't begin "
-                        "with RIFF)";
-    return false;
-  }
-
-  // the size of the file
-  if (!file.read(buffer, 4))
-  {
-    Log().e(LOG_TAG) << "could not read size of file";
-    return false;
-  }
-
-  // the WAVE
-  if (!file.read(buffer, 4))
-  {
-    Log().e(LOG_TAG) << "could not read WAVE";
-    return false;
-  }
-  if (std::strncmp(buffer, "WAVE", 4) != 0)
-  {
-    Log().e(LOG_TAG)
-        << "file is not a valid WAVE file (header doesn't contain WAVE)";
-    return false;
-  }
-
-  // "fmt/0"
-  if (!file.read(buffer, 4))
-  {
-    Log().e(LOG_TAG) << "could not read fmt/0";
-    return false;
-  }
-
-  // this is always 16, the size of the fmt data chunk
-  if (!file.read(buffer, 4))
-  {
-    Log().e(LOG_TAG) << "could not read the 16";
-    return false;
-  }
-
-  // PCM should be 1?
-  if (!file.read(buffer, 2))
-  {
-    Log().e(LOG_TAG) << "could not read PCM";
-    return false;
-  }
-
-  // the number of channels
-  if (!file.read(buffer, 2))
-  {
-    Log().e(LOG_TAG) << "could not read number of channels";
-    return false;
-  }
-  channels = convert_to_int(buffer, 2);
-
-  // sample rate
-  if (!file.read(buffer, 4))
-  {
-    Log().e(LOG_TAG) << "could not read sample rate";
-    return false;
-  }
-  sampleRate = convert_to_int(buffer, 4);
-
-  // (sampleRate * bitsPerSample * channels) / 8
-  if (!file.read(buffer, 4))
-  {
-    Log().e(LOG_TAG)
-        << "could not read (sampleRate * bitsPerSample * channels) / 8";
-    return false;
-  }
-
-  // ?? dafaq
-  if (!file.read(buffer, 2))
-  {
-    Log().e(LOG_TAG) << "could not read dafaq";
-    return false;
-  }
-
-  // bitsPerSample
-  if (!file.read(buffer, 2))
-  {
-    Log().e(LOG_TAG) << "could not read bits per sample";
-    return false;
-  }
-  bitsPerSample = convert_to_int(buffer, 2);
-
-  // data chunk header "data"
-  if (!file.read(buffer, 4))
-  {
-    Log().e(LOG_TAG) << "could not read data chunk header";
-    return false;
-  }
-  if (std::strncmp(buffer, "data", 4) != 0)
-  {
-    Log().e(LOG_TAG)
-        << "file is not a valid WAVE file (doesn't have 'data' tag)";
-    return false;
-  }
-
-  // size of data
-  if (!file.read(buffer, 4))
-  {
-    Log().e(LOG_TAG) << "could not read data size";
-    return false;
-  }
-  size = convert_to_int(buffer, 4);
-
-  /* cannot be at the end of file */
-  if (file.eof())
-  {
-    Log().e(LOG_TAG) << "reached EOF on the file";
-    return false;
-  }
-  if (file.fail())
-  {
-    Log().e(LOG_TAG) << "fail state set on the file";
-    return false;
-  }
-
-  return true;
+  return std::memcmp(data.data() + offset, id, 4) == 0;
 }
 
-WavFile load_wav(const std::string &filename)
+WavView view_wav(const std::string &name, std::span<const unsigned char> data)
 {
-  std::ifstream in(filename, std::ios::binary);
-
-  if (!in.is_open())
-  {
-    throw std::runtime_error("Could not open \"" + filename + "\"");
-  }
-
-  std::size_t  size;
-  std::uint8_t channels;
-  std::int32_t sample_rate;
-  std::uint8_t bits_per_sample;
-  if (!load_wav_file_header(in, channels, sample_rate, bits_per_sample, size))
-  {
-    std::runtime_error("Could not load wav header of \"" + filename + "\"");
-  }
-
-  auto data =
-      std::vector<unsigned char>(std::istreambuf_iterator<char>(in), {});
-
-  return WavFile(filename, channels, sample_rate, bits_per_sample, size, data);
+  const auto fail = [&name](const std::string &reason) {
+    return std::runtime_error("Could not load wav file \"" + name +
+                              "\": " + reason);
+  };
+
+  if (data.size() < 12 || !has_id(data, 0, "RIFF") || !has_id(data, 8, "WAVE"))
+    throw fail("not a RIFF WAVE file");
+
+  std::optional<WavView> wav;
+
+  // Chunks are an id, a size and the data padded to an even length
+  std::size_t offset = 12;
+  while (offset + 8 <= data.size())
+  {
+    const auto size  = std::size_t(read_le(data, offset + 4, 4));
+    const auto begin = offset + 8;
+    const auto chunk = data.subspan(begin, std::min(size, data.size() - begin));
+
+    if (has_id(data, offset, "fmt "))
+    {
+      if (chunk.size() < PCM_FORMAT_SIZE)
+        throw fail("fmt chunk too short");
+
+      auto format_tag = read_le(chunk, 0, 2);
+      if (format_tag == WAVE_FORMAT_EXTENSIBLE)
+      {
+        if (chunk.size() < SUB_FORMAT_OFFSET + 2)
+          throw fail("extensible fmt chunk too short");
+        format_tag = read_le(chunk, SUB_FORMAT_OFFSET, 2);
+      }
+      if (format_tag != WAVE_FORMAT_PCM)
+        throw fail("format " + std::to_string(format_tag) + " is not PCM");
+
+      wav.emplace();
+      wav->channels        = read_le(chunk, 2, 2);
+      wav->sample_rate     = read_le(chunk, 4, 4);
+      wav->bits_per_sample = read_le(chunk, 14, 2);
+    }
+    else if (has_id(data, offset, "data"))
+    {
+      if (!wav)
+        throw fail("data chunk before fmt chunk");
+
+      // A truncated file keeps the samples that are there
+      wav->samples = chunk;
+      return *wav;
+    }
+
+    offset = begin + size + (size & 1);
+  }
+
+  throw fail("no data chunk");
 }
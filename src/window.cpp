@@ -1,4 +1,5 @@
 #include <sys/time.h>
+#include <thread>
 
 #include "asseration.hpp"
 #include "window.hpp"
@@ -83,7 +84,7 @@ void Window::initWindow()
 
   if (!window)
   {
-    std::runtime_error("Could not create window");
+    throw std::runtime_error("Could not create window");
   }
 
   glfwSetWindowUserPointer(window, this);
@@ -112,6 +113,8 @@ void Window::show()
 
     glfwSwapBuffers(window);
     glfwPollEvents();
+
+    wait_for_next_frame();
   }
 }
 
@@ -119,9 +122,24 @@ void Window::draw() {}
 
 void Window::calcDeltaTime()
 {
-  float currentFrame = glfwGetTime();
-  delta_time         = currentFrame - last_frame;
-  last_frame         = currentFrame;
+  // A float loses sub millisecond precision after a few hours
+  double currentFrame = glfwGetTime();
+  delta_time          = currentFrame - last_frame;
+  last_frame          = currentFrame;
+}
+
+void Window::wait_for_next_frame()
+{
+  if (max_frame_rate <= 0.0)
+    return;
+
+  const auto next_frame = last_frame + 1.0 / max_frame_rate;
+  const auto time       = glfwGetTime();
+  if (time < next_frame)
+  {
+    std::this_thread::sleep_for(
+        std::chrono::duration<double>(next_frame - time));
+  }
 }
 
 double Window::get_current_time_millis()
@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "asset-pack.hpp"
+#include "lz.hpp"
+
+static int failures = 0;
+
+static void check(bool condition, const std::string &description)
+{
+  if (!condition)
+  {
+    std::cerr << "FAILED: " << description << "\n";
+    ++failures;
+  }
+}
+
+static std::vector<unsigned char> make_repetitive_data(std::size_t size)
+{
+  std::vector<unsigned char> data(size);
+  for (std::size_t i = 0; i < size; ++i)
+    data[i] = static_cast<unsigned char>("breakthrough"[i % 12]);
+  return data;
+}
+
+static std::vector<unsigned char> make_noisy_data(std::size_t size)
+{
+  std::vector<unsigned char> data(size);
+  std::uint32_t              state = 12345;
+  for (auto &value : data)
+  {
+    state = state * 1664525u + 1013904223u;
+    value = static_cast<unsigned char>(state >> 24);
+  }
+  return data;
+}
+
+static bool round_trips(std::span<const unsigned char> data)
+{
+  const auto                 compressed = lz_compress(data);
+  std::vector<unsigned char> decompressed(data.size());
+  lz_decompress(compressed, decompressed);
+  return std::equal(data.begin(), data.end(), decompressed.begin());
+}
+
+static void check_lz()
+{
+  check(round_trips({}), "empty block round trips");
+  check(round_trips(make_repetitive_data(1)), "single byte round trips");
+  check(round_trips(make_repetitive_data(100000)),
+        "repetitive data round trips");
+  check(round_trips(make_noisy_data(100000)), "noisy data round trips");
+
+  const auto data = make_repetitive_data(100000);
+  check(lz_compress(data).size() < data.size() / 10,
+        "repetitive data compresses");
+
+  // Long matches and literal runs need length extension bytes
+  auto mixed = make_noisy_data(1000);
+  mixed.resize(70000, 7);
+  const auto tail = make_noisy_data(300);
+  mixed.insert(mixed.end(), tail.begin(), tail.end());
+  check(round_trips(mixed), "long runs round trip");
+
+  auto                       compressed = lz_compress(data);
+  std::vector<unsigned char> wrong_size(data.size() + 1);
+  auto                       threw = false;
+  try
+  {
+    lz_decompress(compressed, wrong_size);
+  }
+  catch (const std::runtime_error &)
+  {
+    threw = true;
+  }
+  check(threw, "wrong destination size is rejected");
+
+  compressed.resize(compressed.size() / 2);
+  std::vector<unsigned char> destination(data.size());
+  threw = false;
+  try
+  {
+    lz_decompress(compressed, destination);
+  }
+  catch (const std::runtime_error &)
+  {
+    threw = true;
+  }
+  check(threw, "truncated block is rejected");
+}
+
+static void check_pack(const std::filesystem::path &directory)
+{
+  const auto file       = (directory / "test.pack").string();
+  const auto repetitive = make_repetitive_data(50000);
+  const auto noisy      = make_noisy_data(5000);
+  const std::vector<unsigned char> empty;
+
+  AssetPackWriter writer;
+  writer.add("textures/repetitive.png", repetitive, true);
+  writer.add("audio/noisy.wav", noisy, true);
+  writer.add("levels/plain.lvl", repetitive, false);
+  writer.add("empty", empty, true);
+  writer.write(file);
+
+  const AssetPack pack(file);
+  check(pack.get_entries().size() == 4, "pack has 4 entries");
+  check(pack.find("missing") == nullptr, "missing name is not found");
+
+  for (const auto &entry : pack.get_entries())
+  {
+    const auto name = std::string(pack.get_name(entry));
+    check(pack.find(name) == &entry, name + " is found by name");
+    check(pack.verify(entry), name + " verifies");
+    check(pack.get_stored_data(entry).size() == entry.stored_size,
+          name + " has its stored size");
+  }
+
+  const auto compressed = pack.find("textures/repetitive.png");
+  if (compressed)
+  {
+    check(compressed->flags & AssetPackEntry::COMPRESSED,
+          "repetitive entry is compressed");
+    check(compressed->size == repetitive.size(),
+          "compressed entry keeps its size");
+
+    std::vector<unsigned char> data(compressed->size);
+    lz_decompress(pack.get_stored_data(*compressed), data);
+    check(data == repetitive, "compressed entry decompresses");
+  }
+
+  // Compression that does not pay off stores the data as is
+  const auto incompressible = pack.find("audio/noisy.wav");
+  check(incompressible &&
+            !(incompressible->flags & AssetPackEntry::COMPRESSED),
+        "noisy entry is stored uncompressed");
+
+  const auto plain = pack.find("levels/plain.lvl");
+  if (plain)
+  {
+    check(!(plain->flags & AssetPackEntry::COMPRESSED),
+          "entry added without compression is stored as is");
+    const auto data = pack.get_stored_data(*plain);
+    check(std::equal(data.begin(), data.end(), repetitive.begin(),
+                     repetitive.end()),
+          "uncompressed entry reads back");
+  }
+
+  for (const auto &entry : pack.get_entries())
+  {
+    check(entry.offset % ASSET_PACK_ALIGNMENT == 0,
+          std::string(pack.get_name(entry)) + " is aligned");
+  }
+}
+
+int main()
+{
+  const auto directory =
+      std::filesystem::temp_directory_path() / "breakthroughgl-pack-test";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+
+  check_lz();
+  check_pack(directory);
+
+  std::filesystem::remove_all(directory);
+
+  if (failures > 0)
+    return 1;
+
+  std::cout << "All asset pack checks passed\n";
+  return 0;
+}
@@ -0,0 +1,77 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "level-catalog.hpp"
+#include "thread-pool.hpp"
+
+static int failures = 0;
+
+static void check(bool condition, const std::string &description)
+{
+  if (!condition)
+  {
+    std::cerr << "FAILED: " << description << "\n";
+    ++failures;
+  }
+}
+
+static void write_file(const std::filesystem::path &file,
+                       const std::string &          content)
+{
+  std::ofstream out(file, std::ios::binary);
+  out << content;
+}
+
+int main()
+{
+  // Loose levels are read relative to the working directory
+  const auto directory =
+      std::filesystem::temp_directory_path() / "breakthroughgl-level-test";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory / "resources" / "levels");
+  std::filesystem::current_path(directory);
+
+  write_file("resources/levels/good.lvl", "1 2 3\n4 5 0\n");
+  write_file("resources/levels/corrupt.lvl", "1 2 3\n4 x\n");
+
+  {
+    ThreadPool   workers(2);
+    LevelCatalog catalog(workers);
+    catalog.add("levels/good.lvl");
+    catalog.add("levels/corrupt.lvl");
+    catalog.add("levels/missing.lvl");
+
+    const auto good = catalog.get(0);
+    check(good != nullptr, "good level loads");
+    check(good && good->get_tiles().size() == 6, "good level has 6 tiles");
+    check(!catalog.has_failed(0), "good level is not failed");
+
+    catalog.select(1);
+    check(catalog.get(1) == nullptr, "corrupt level loads as nullptr");
+    check(catalog.has_failed(1), "corrupt level is failed");
+    check(catalog.try_get(1) == nullptr, "try_get does not throw");
+
+    check(catalog.get(2) == nullptr, "missing level loads as nullptr");
+    check(catalog.has_failed(2), "missing level is failed");
+
+    // Once fixed the level loads after it was out of reach
+    write_file("resources/levels/corrupt.lvl", "1 2\n3 4\n");
+    catalog.add("levels/a.lvl");
+    catalog.add("levels/b.lvl");
+    catalog.select(3);
+    check(!catalog.has_failed(1), "failed level is evicted out of reach");
+    catalog.select(1);
+    check(catalog.get(1) != nullptr, "fixed level loads again");
+  }
+
+  std::filesystem::current_path(std::filesystem::temp_directory_path());
+  std::filesystem::remove_all(directory);
+
+  if (failures > 0)
+    return 1;
+
+  std::cout << "All level catalog checks passed\n";
+  return 0;
+}
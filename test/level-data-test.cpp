@@ -0,0 +1,187 @@
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "level-data.hpp"
+#include "mapped-file.hpp"
+
+static int failures = 0;
+
+static void check(bool condition, const std::string &description)
+{
+  if (!condition)
+  {
+    std::cerr << "FAILED: " << description << "\n";
+    ++failures;
+  }
+}
+
+static bool is_rejected(std::string_view content)
+{
+  try
+  {
+    LevelData::parse_text(content);
+  }
+  catch (const std::runtime_error &)
+  {
+    return true;
+  }
+  return false;
+}
+
+static bool is_rejected(std::span<const unsigned char> data)
+{
+  try
+  {
+    LevelData::read_binary(data);
+  }
+  catch (const std::runtime_error &)
+  {
+    return true;
+  }
+  return false;
+}
+
+static bool is_same_level(const LevelData &a, const LevelData &b)
+{
+  if (a.get_rows() != b.get_rows() || a.get_columns() != b.get_columns() ||
+      a.get_tiles() != b.get_tiles() ||
+      a.get_palette().size() != b.get_palette().size())
+    return false;
+
+  for (std::size_t i = 0; i < a.get_palette().size(); ++i)
+  {
+    const auto &type_a = a.get_palette()[i];
+    const auto &type_b = b.get_palette()[i];
+    if (type_a.is_solid != type_b.is_solid ||
+        std::memcmp(type_a.color, type_b.color, sizeof(type_a.color)) != 0)
+      return false;
+  }
+  return true;
+}
+
+static void check_text()
+{
+  const auto level = LevelData::parse_text("1 1 2\n0 3 4\n");
+  check(level.get_rows() == 2 && level.get_columns() == 3,
+        "text level is 2 by 3");
+  check(level.get_tile(1, 2) == 4, "text level tiles are row-major");
+  check(level.get_brick_type(1).is_solid, "tile code 1 is solid");
+
+  const auto padded = LevelData::parse_text("1 2\r\n3 4\r\n\n  \n\t\n");
+  check(padded.get_rows() == 2, "trailing blank lines are ignored");
+
+  const auto wide = LevelData::parse_text("9 200\n");
+  check(wide.get_palette().size() > 200,
+        "palette covers codes beyond the default");
+  check(!wide.get_brick_type(200).is_solid, "unknown codes are breakable");
+
+  check(is_rejected(""), "empty text is rejected");
+  check(is_rejected("\n \n"), "blank text is rejected");
+  check(is_rejected("1 2 3\n4 5\n"), "ragged rows are rejected");
+  check(is_rejected("1 2\n\n3 4\n"), "empty row inside is rejected");
+  check(is_rejected("1 x\n"), "invalid tile code is rejected");
+  check(is_rejected("256\n"), "tile code above 255 is rejected");
+}
+
+static void check_binary(const std::filesystem::path &directory)
+{
+  // Long runs of equal tiles, as most levels have
+  std::string text;
+  for (int row = 0; row < 16; ++row)
+  {
+    for (int column = 0; column < 40; ++column)
+      text += column < 20 ? "0 " : row % 2 == 0 ? "2 " : "3 ";
+    text += "\n";
+  }
+  const auto level = LevelData::parse_text(text);
+
+  const auto plain      = level.to_binary(false);
+  const auto compressed = level.to_binary(true);
+  check(LevelData::is_binary(plain), "binary level is detected");
+  check(!LevelData::is_binary(std::span(
+            reinterpret_cast<const unsigned char *>(text.data()),
+            text.size())),
+        "text level is not detected as binary");
+  check(compressed.size() < plain.size(), "run length encoding pays off");
+
+  check(is_same_level(LevelData::read_binary(plain), level),
+        "plain binary level round trips");
+  check(is_same_level(LevelData::read_binary(compressed), level),
+        "run length encoded level round trips");
+  check(is_same_level(LevelData::load(compressed), level),
+        "load reads binary levels");
+
+  // Runs are capped at 255 tiles
+  const LevelData long_runs(1, 600, std::vector<std::uint8_t>(600, 2));
+  check(is_same_level(LevelData::read_binary(long_runs.to_binary(true)),
+                      long_runs),
+        "runs longer than 255 tiles round trip");
+
+  // Without runs the tiles are stored as is
+  std::vector<std::uint8_t> alternating(64);
+  for (std::size_t i = 0; i < alternating.size(); ++i)
+    alternating[i] = static_cast<std::uint8_t>(i % 2 + 1);
+  const LevelData noisy(8, 8, alternating);
+  check(noisy.to_binary(true) == noisy.to_binary(false),
+        "tiles without runs are not encoded");
+
+  const auto file = (directory / "level.btlv").string();
+  level.write_binary(file, true);
+  const MappedFile mapped(file);
+  check(is_same_level(LevelData::load(mapped.data()), level),
+        "written binary level reads back");
+
+  std::vector<unsigned char> truncated(compressed.begin(),
+                                       compressed.end() - 1);
+  check(is_rejected(truncated), "truncated level is rejected");
+  check(is_rejected(std::span(compressed.data(), 10)),
+        "truncated header is rejected");
+
+  LevelFileHeader header;
+  std::memcpy(&header, plain.data(), sizeof(header));
+  const auto with_dimensions = [&](std::uint32_t rows, std::uint32_t columns)
+  {
+    auto changed    = header;
+    changed.rows    = rows;
+    changed.columns = columns;
+    auto data       = plain;
+    std::memcpy(data.data(), &changed, sizeof(changed));
+    return data;
+  };
+  check(is_rejected(with_dimensions(0, header.columns)),
+        "zero rows are rejected");
+  check(is_rejected(with_dimensions(header.rows, 0)),
+        "zero columns are rejected");
+  check(is_rejected(with_dimensions(header.rows, header.columns + 1)),
+        "tiles not filling the grid are rejected");
+
+  auto bad_magic = plain;
+  bad_magic[0] = 'X';
+  check(is_rejected(bad_magic), "wrong magic is rejected");
+}
+
+int main()
+{
+  const auto directory =
+      std::filesystem::temp_directory_path() / "breakthroughgl-data-test";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+
+  check_text();
+  check_binary(directory);
+
+  std::filesystem::remove_all(directory);
+
+  if (failures > 0)
+    return 1;
+
+  std::cout << "All level data checks passed\n";
+  return 0;
+}
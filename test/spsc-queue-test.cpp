@@ -0,0 +1,94 @@
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "spsc-queue.hpp"
+
+static int failures = 0;
+
+static void check(bool condition, const std::string &description)
+{
+  if (!condition)
+  {
+    std::cerr << "FAILED: " << description << "\n";
+    ++failures;
+  }
+}
+
+static void check_single_thread()
+{
+  SpscQueue<int, 4> queue;
+  check(!queue.try_pop(), "new queue is empty");
+
+  for (int i = 0; i < 4; ++i)
+    check(queue.try_push(i), "push " + std::to_string(i) + " fits");
+  check(!queue.try_push(4), "push into a full queue fails");
+
+  while (queue.try_pop())
+    ;
+
+  // Every fill level in turn, so head and tail wrap around at every
+  // position of the ring many times over
+  auto in_order  = true;
+  auto next_push = 0;
+  auto next_pop  = 0;
+  for (int round = 0; round < 1000; ++round)
+  {
+    const auto count = round % 5;
+    for (int i = 0; i < count; ++i)
+      in_order = in_order && queue.try_push(next_push++);
+    in_order = in_order && (count < 4 || !queue.try_push(-1));
+
+    while (const auto value = queue.try_pop())
+      in_order = in_order && *value == next_pop++;
+  }
+  check(in_order, "values come out in order across wraparound");
+  check(next_pop == next_push, "every value comes out once");
+  check(!queue.try_pop(), "drained queue is empty");
+}
+
+static void check_two_threads()
+{
+  constexpr std::size_t      COUNT = 200000;
+  SpscQueue<std::size_t, 64> queue;
+
+  std::thread producer(
+      [&]
+      {
+        for (std::size_t i = 0; i < COUNT; ++i)
+        {
+          while (!queue.try_push(i))
+            std::this_thread::yield();
+        }
+      });
+
+  auto in_order = true;
+  for (std::size_t expected = 0; expected < COUNT;)
+  {
+    const auto value = queue.try_pop();
+    if (!value)
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    in_order = in_order && *value == expected;
+    ++expected;
+  }
+  producer.join();
+
+  check(in_order, "values cross threads in order");
+  check(!queue.try_pop(), "queue is empty after the producer finished");
+}
+
+int main()
+{
+  check_single_thread();
+  check_two_threads();
+
+  if (failures > 0)
+    return 1;
+
+  std::cout << "All spsc queue checks passed\n";
+  return 0;
+}
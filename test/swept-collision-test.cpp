@@ -0,0 +1,137 @@
+#include <cmath>
+#include <iostream>
+#include <optional>
+#include <string>
+
+#include "swept-collision.hpp"
+
+static int failures = 0;
+
+static void check(bool condition, const std::string &description)
+{
+  if (!condition)
+  {
+    std::cerr << "FAILED: " << description << "\n";
+    ++failures;
+  }
+}
+
+static bool is_near(float a, float b) { return std::abs(a - b) < 1e-4f; }
+
+static bool is_hit(const std::optional<SweepHit> &hit,
+                   float                          time,
+                   glm::vec2                      normal)
+{
+  return hit && is_near(hit->time, time) && is_near(hit->normal.x, normal.x) &&
+         is_near(hit->normal.y, normal.y);
+}
+
+static void check_box()
+{
+  // Box from (10, 10) to (20, 20), ball of radius 1
+  const glm::vec2 box_min(10.0f, 10.0f);
+  const glm::vec2 box_max(20.0f, 20.0f);
+
+  check(is_hit(sweep_circle_box({5.0f, 15.0f}, 1.0f, {8.0f, 0.0f},
+                                box_min, box_max),
+               0.5f, {-1.0f, 0.0f}),
+        "hits the left face half way");
+  check(is_hit(sweep_circle_box({15.0f, 25.0f}, 1.0f, {0.0f, -8.0f},
+                                box_min, box_max),
+               0.5f, {0.0f, 1.0f}),
+        "hits the bottom face moving up the screen");
+  check(!sweep_circle_box({5.0f, 15.0f}, 1.0f, {3.0f, 0.0f},
+                          box_min, box_max),
+        "stops short of the box");
+  check(!sweep_circle_box({5.0f, 15.0f}, 1.0f, {-8.0f, 0.0f},
+                          box_min, box_max),
+        "moves away from the box");
+  check(!sweep_circle_box({5.0f, 5.0f}, 1.0f, {0.0f, 20.0f},
+                          box_min, box_max),
+        "passes beside the box");
+  check(!sweep_circle_box({15.0f, 5.0f}, 1.0f, {0.0f, 0.0f},
+                          box_min, box_max),
+        "does not move");
+
+  // The grown box has rounded corners, a diagonal motion that only
+  // crosses its square corner misses
+  check(!sweep_circle_box({7.2f, 11.2f}, 1.0f, {4.0f, -4.0f},
+                          box_min, box_max),
+        "misses the rounded corner");
+  const auto diagonal = 1.0f / std::sqrt(2.0f);
+  const auto corner_hit =
+      sweep_circle_box({5.0f, 5.0f}, 1.0f, {5.0f, 5.0f}, box_min, box_max);
+  check(is_hit(corner_hit, 1.0f - 1.0f / (5.0f * std::sqrt(2.0f)),
+               {-diagonal, -diagonal}),
+        "hits the corner with the diagonal normal");
+
+  // Overlapping circles only hit if they move further in
+  check(is_hit(sweep_circle_box({15.0f, 20.5f}, 1.0f, {0.0f, -1.0f},
+                                box_min, box_max),
+               0.0f, {0.0f, 1.0f}),
+        "overlap moving in hits at time 0");
+  check(!sweep_circle_box({15.0f, 20.5f}, 1.0f, {0.0f, 1.0f},
+                          box_min, box_max),
+        "overlap moving out does not hit");
+  check(is_hit(sweep_circle_box({11.0f, 15.0f}, 1.0f, {1.0f, 0.0f},
+                                box_min, box_max),
+               0.0f, {-1.0f, 0.0f}),
+        "center inside uses the closest face");
+
+  // A ball resting on the paddle touches the grown box without
+  // overlapping and must not stick to it when it launches
+  check(!sweep_circle_box({15.0f, 9.0f}, 1.0f, {0.0f, -5.0f},
+                          box_min, box_max),
+        "leaving the grown box at time 0 does not hit");
+  check(!sweep_circle_box({21.0f, 15.0f}, 1.0f, {5.0f, 3.0f},
+                          box_min, box_max),
+        "leaving the grown box sideways at time 0 does not hit");
+  check(is_hit(sweep_circle_box({15.0f, 9.0f}, 1.0f, {0.0f, 5.0f},
+                                box_min, box_max),
+               0.0f, {0.0f, -1.0f}),
+        "touching the grown box and moving in hits at time 0");
+}
+
+static void check_plane()
+{
+  // Left wall of the screen, the ball stays to its right
+  const glm::vec2 point(0.0f, 0.0f);
+  const glm::vec2 normal(1.0f, 0.0f);
+
+  check(is_hit(sweep_circle_plane({5.0f, 3.0f}, 1.0f, {-8.0f, 2.0f},
+                                  point, normal),
+               0.5f, normal),
+        "hits the wall half way");
+  check(!sweep_circle_plane({5.0f, 3.0f}, 1.0f, {-2.0f, 0.0f},
+                            point, normal),
+        "stops short of the wall");
+  check(!sweep_circle_plane({5.0f, 3.0f}, 1.0f, {2.0f, 0.0f},
+                            point, normal),
+        "moves away from the wall");
+  check(!sweep_circle_plane({5.0f, 3.0f}, 1.0f, {0.0f, 9.0f},
+                            point, normal),
+        "moves along the wall");
+  check(is_hit(sweep_circle_plane({0.5f, 3.0f}, 1.0f, {-1.0f, 0.0f},
+                                  point, normal),
+               0.0f, normal),
+        "already past the wall hits at time 0");
+  check(!sweep_circle_plane({0.5f, 3.0f}, 1.0f, {1.0f, 0.0f},
+                            point, normal),
+        "already past the wall moving back does not hit");
+
+  const auto reflected = reflect_velocity({-3.0f, 4.0f}, normal);
+  check(is_near(reflected.x, 3.0f) && is_near(reflected.y, 4.0f),
+        "reflection mirrors the normal component");
+}
+
+int main()
+{
+  check_box();
+  check_plane();
+
+  if (failures > 0)
+    return 1;
+
+  std::cout << "All swept collision checks passed\n";
+  return 0;
+}
@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// Writes a header that compiles levels and other files into the game.
+// Levels are parsed by the constexpr parser in embedded-assets.hpp, so
+// a malformed level fails the build. The tool has no dependencies of
+// its own, since the asset library it would use is built from its
+// output.
+
+static const std::string LEVEL_EXTENSION = ".lvl";
+
+struct Input
+{
+  std::string                name;
+  std::vector<unsigned char> data;
+};
+
+static int usage()
+{
+  std::cerr << "Usage: breakthroughgl_asset_embedder <resources directory> "
+               "<output header> <directory>...\n";
+  return 1;
+}
+
+static std::vector<Input> read_inputs(const std::filesystem::path &root,
+                                      const std::string &          directory)
+{
+  std::vector<std::filesystem::path> files;
+  for (const auto &entry :
+       std::filesystem::recursive_directory_iterator(root / directory))
+  {
+    if (entry.is_regular_file())
+      files.push_back(entry.path());
+  }
+  // Keep the output independent of directory iteration order
+  std::sort(files.begin(), files.end());
+
+  std::vector<Input> inputs;
+  for (const auto &file : files)
+  {
+    std::ifstream stream(file, std::ios::binary);
+    if (!stream)
+      throw std::runtime_error("Could not open " + file.string());
+
+    inputs.push_back(
+        {std::filesystem::relative(file, root).generic_string(),
+         {std::istreambuf_iterator<char>(stream),
+          std::istreambuf_iterator<char>()}});
+  }
+  return inputs;
+}
+
+static void write_array(std::ostream &            out,
+                        const std::string &       name,
+                        const std::vector<Input> &inputs,
+                        std::size_t               index)
+{
+  const auto &data = inputs[index].data;
+
+  out << "// " << inputs[index].name << "\n"
+      << "inline constexpr unsigned char " << name << "[] = {";
+  for (std::size_t i = 0; i < data.size(); ++i)
+  {
+    if (i % 16 == 0)
+      out << "\n  ";
+    out << static_cast<unsigned>(data[i]) << ",";
+  }
+  // Keeps empty files from producing an empty array
+  out << "\n  0};\n\n";
+}
+
+static std::string escape(const std::string &name)
+{
+  std::string escaped;
+  for (const auto c : name)
+  {
+    if (c == '"' || c == '\\')
+      escaped += '\\';
+    escaped += c;
+  }
+  return escaped;
+}
+
+static void write_header(const std::string &       header_file,
+                         const std::vector<Input> &files,
+                         const std::vector<Input> &levels)
+{
+  std::ofstream out(header_file);
+  if (!out)
+    throw std::runtime_error("Could not write " + header_file);
+
+  out << "// Generated by breakthroughgl_asset_embedder, do not edit\n"
+      << "#pragma once\n\n"
+      << "#include \"embedded-assets.hpp\"\n\n"
+      << "namespace embedded_assets\n{\n\n";
+
+  for (std::size_t i = 0; i < files.size(); ++i)
+    write_array(out, "file_" + std::to_string(i), files, i);
+
+  // The level text is only used during compilation, only the tile
+  // tables end up in the binary
+  for (std::size_t i = 0; i < levels.size(); ++i)
+  {
+    const auto name = "level_" + std::to_string(i);
+    write_array(out, name + "_source", levels, i);
+
+    // The source array ends with a padding zero
+    const auto source = "std::span<const unsigned char>(" + name +
+                        "_source, sizeof(" + name + "_source) - 1)";
+    out << "inline constexpr LevelSize " << name
+        << "_size = measure_level(" << source << ");\n"
+        << "inline constexpr auto " << name << "_tiles =\n"
+        << "    parse_level<" << name << "_size.rows, " << name
+        << "_size.columns>(" << source << ");\n\n";
+  }
+
+  out << "inline constexpr std::array<EmbeddedFile, " << files.size()
+      << "> files{{\n";
+  for (std::size_t i = 0; i < files.size(); ++i)
+  {
+    out << "  {\"" << escape(files[i].name) << "\", {file_" << i
+        << ", sizeof(file_" << i << ") - 1}},\n";
+  }
+  out << "}};\n\n";
+
+  out << "inline constexpr std::array<EmbeddedLevel, " << levels.size()
+      << "> levels{{\n";
+  for (std::size_t i = 0; i < levels.size(); ++i)
+  {
+    const auto name = "level_" + std::to_string(i);
+    out << "  {\"" << escape(levels[i].name) << "\", " << name
+        << "_size.rows, " << name << "_size.columns, " << name
+        << "_tiles},\n";
+  }
+  out << "}};\n\n"
+      << "} // namespace embedded_assets\n";
+}
+
+int main(int argc, char **argv)
+{
+  if (argc < 4)
+    return usage();
+
+  const std::filesystem::path root        = argv[1];
+  const std::string           header_file = argv[2];
+
+  try
+  {
+    std::vector<Input> files;
+    std::vector<Input> levels;
+    for (int i = 3; i < argc; ++i)
+    {
+      for (auto &input : read_inputs(root, argv[i]))
+      {
+        std::cout << "Embed " << input.name << " (" << input.data.size()
+                  << " bytes)\n";
+
+        if (std::filesystem::path(input.name).extension() == LEVEL_EXTENSION)
+          levels.push_back(std::move(input));
+        else
+          files.push_back(std::move(input));
+      }
+    }
+
+    write_header(header_file, files, levels);
+
+    std::cout << "Wrote " << files.size() << " files and " << levels.size()
+              << " levels to " << header_file << "\n";
+  }
+  catch (const std::exception &error)
+  {
+    std::cerr << error.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
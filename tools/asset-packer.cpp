@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <vector>
+
+#include "asset-pack.hpp"
+#include "asset-store.hpp"
+#include "mapped-file.hpp"
+
+static int usage()
+{
+  std::cerr << "Usage: breakthroughgl_asset_packer [--compress] <directory>... "
+               "<pack file>\n"
+               "       breakthroughgl_asset_packer --list <pack file>\n"
+               "       breakthroughgl_asset_packer --verify <pack file>\n";
+  return 1;
+}
+
+static int pack(const std::vector<std::string> &directories,
+                const std::string &               pack_file,
+                bool                              compress)
+{
+  AssetPackWriter writer;
+  std::size_t     entry_count = 0;
+
+  for (const auto &directory : directories)
+  {
+    std::vector<std::filesystem::path> files;
+    for (const auto &entry :
+         std::filesystem::recursive_directory_iterator(directory))
+    {
+      if (entry.is_regular_file())
+        files.push_back(entry.path());
+    }
+    // Keep the output independent of directory iteration order
+    std::sort(files.begin(), files.end());
+
+    for (const auto &file : files)
+    {
+      // Entries are named like the game requests them, relative to the
+      // packed directory and with forward slashes
+      const auto name =
+          std::filesystem::relative(file, directory).generic_string();
+
+      // Streamed assets stay uncompressed to be read from the mapping
+      MappedFile mapped_file(file.string());
+      writer.add(name,
+                 mapped_file.data(),
+                 compress && !AssetStore::is_streamed(name));
+
+      std::cout << "Add " << name << " (" << mapped_file.get_size()
+                << " bytes)\n";
+    }
+    entry_count += files.size();
+  }
+
+  writer.write(pack_file);
+
+  std::cout << "Wrote " << entry_count << " entries to " << pack_file << "\n";
+  return 0;
+}
+
+static int list(const std::string &pack_file)
+{
+  AssetPack asset_pack(pack_file);
+  for (const auto &entry : asset_pack.get_entries())
+  {
+    std::cout << asset_pack.get_name(entry) << " " << entry.size << " bytes";
+    if (entry.flags & AssetPackEntry::COMPRESSED)
+      std::cout << " (" << entry.stored_size << " bytes compressed)";
+    std::cout << "\n";
+  }
+  return 0;
+}
+
+static int verify(const std::string &pack_file)
+{
+  AssetPack asset_pack(pack_file);
+  int       result = 0;
+  for (const auto &entry : asset_pack.get_entries())
+  {
+    if (!asset_pack.verify(entry))
+    {
+      std::cerr << asset_pack.get_name(entry)
+                << " does not match its content hash\n";
+      result = 1;
+    }
+  }
+  return result;
+}
+
+int main(int argc, char *argv[])
+{
+  std::vector<std::string> args(argv + 1, argv + argc);
+
+  try
+  {
+    if (args.size() == 2 && args[0] == "--list")
+      return list(args[1]);
+
+    if (args.size() == 2 && args[0] == "--verify")
+      return verify(args[1]);
+
+    const bool compress = !args.empty() && args[0] == "--compress";
+    if (compress)
+      args.erase(args.begin());
+
+    if (args.size() >= 2)
+    {
+      const auto pack_file = args.back();
+      args.pop_back();
+      return pack(args, pack_file, compress);
+    }
+  }
+  catch (const std::exception &e)
+  {
+    std::cerr << e.what() << "\n";
+    return 1;
+  }
+
+  return usage();
+}
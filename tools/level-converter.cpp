@@ -0,0 +1,54 @@
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#include "level-data.hpp"
+#include "mapped-file.hpp"
+
+static int usage()
+{
+  std::cerr << "Usage: breakthroughgl_level_converter [--rle] <level file> "
+               "<binary level file>\n";
+  return 1;
+}
+
+int main(int argc, char **argv)
+{
+  auto compress = false;
+  auto arg      = 1;
+  if (argc > 1 && std::string(argv[1]) == "--rle")
+  {
+    compress = true;
+    ++arg;
+  }
+
+  if (argc - arg != 2)
+    return usage();
+
+  const std::string level_file  = argv[arg];
+  const std::string binary_file = argv[arg + 1];
+
+  try
+  {
+    MappedFile mapped_file(level_file);
+    const auto level_data = LevelData::load(mapped_file.data());
+
+    const auto directory = std::filesystem::path(binary_file).parent_path();
+    if (!directory.empty())
+      std::filesystem::create_directories(directory);
+
+    level_data.write_binary(binary_file, compress);
+
+    std::cout << "Convert " << level_file << " (" << level_data.get_rows()
+              << "x" << level_data.get_columns() << ", "
+              << mapped_file.get_size() << " bytes) to " << binary_file
+              << " (" << std::filesystem::file_size(binary_file) << " bytes)\n";
+  }
+  catch (const std::exception &error)
+  {
+    std::cerr << level_file << ": " << error.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
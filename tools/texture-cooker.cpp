@@ -0,0 +1,405 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <vector>
+
+#include <stb/stb_image.h>
+
+#include "cooked-texture.hpp"
+#include "hash.hpp"
+#include "mapped-file.hpp"
+
+using Format = CookedTexture::Format;
+
+struct Image
+{
+  unsigned                   width    = 0;
+  unsigned                   height   = 0;
+  unsigned                   channels = 0; // 3 or 4
+  std::vector<unsigned char> pixels;
+};
+
+static int usage()
+{
+  std::cerr << "Usage: breakthroughgl_texture_cooker [--bc] <textures "
+               "directory> <output directory>\n";
+  return 1;
+}
+
+static bool is_texture(const std::filesystem::path &file)
+{
+  const auto extension = file.extension();
+  return extension == ".png" || extension == ".jpg" || extension == ".jpeg";
+}
+
+static Image decode(std::span<const unsigned char> data)
+{
+  int            width, height, channels;
+  unsigned char *pixels = stbi_load_from_memory(data.data(),
+                                                static_cast<int>(data.size()),
+                                                &width,
+                                                &height,
+                                                &channels,
+                                                0);
+  if (!pixels)
+  {
+    throw std::runtime_error(std::string("Could not decode image: ") +
+                             stbi_failure_reason());
+  }
+  stbi_image_free(pixels);
+
+  // Grey images are expanded to RGB, grey with alpha to RGBA
+  const int desired_channels = channels == 2 || channels == 4 ? 4 : 3;
+  pixels                     = stbi_load_from_memory(data.data(),
+                                 static_cast<int>(data.size()),
+                                 &width,
+                                 &height,
+                                 &channels,
+                                 desired_channels);
+
+  Image image;
+  image.width    = static_cast<unsigned>(width);
+  image.height   = static_cast<unsigned>(height);
+  image.channels = static_cast<unsigned>(desired_channels);
+  image.pixels.assign(pixels,
+                      pixels + std::size_t(width) * height * desired_channels);
+  stbi_image_free(pixels);
+  return image;
+}
+
+/**
+ * @brief Halves an image with a 2x2 box filter.
+ *
+ * Odd edges are handled by clamping, so the last row or column is
+ * weighted twice.
+ */
+static Image downsample(const Image &image)
+{
+  Image mip;
+  mip.width    = std::max(1u, image.width / 2);
+  mip.height   = std::max(1u, image.height / 2);
+  mip.channels = image.channels;
+  mip.pixels.resize(std::size_t(mip.width) * mip.height * mip.channels);
+
+  const auto texel = [&image](unsigned x, unsigned y, unsigned c) {
+    x = std::min(x, image.width - 1);
+    y = std::min(y, image.height - 1);
+    return unsigned(
+        image.pixels[(std::size_t(y) * image.width + x) * image.channels + c]);
+  };
+
+  for (unsigned y = 0; y < mip.height; ++y)
+  {
+    for (unsigned x = 0; x < mip.width; ++x)
+    {
+      for (unsigned c = 0; c < mip.channels; ++c)
+      {
+        const auto sum = texel(2 * x, 2 * y, c) + texel(2 * x + 1, 2 * y, c) +
+                         texel(2 * x, 2 * y + 1, c) +
+                         texel(2 * x + 1, 2 * y + 1, c);
+        mip.pixels[(std::size_t(y) * mip.width + x) * mip.channels + c] =
+            static_cast<unsigned char>((sum + 2) / 4);
+      }
+    }
+  }
+
+  return mip;
+}
+
+static std::uint16_t to_rgb565(const unsigned char *color)
+{
+  return static_cast<std::uint16_t>(((color[0] * 31 + 127) / 255) << 11 |
+                                    ((color[1] * 63 + 127) / 255) << 5 |
+                                    ((color[2] * 31 + 127) / 255));
+}
+
+static std::array<int, 3> from_rgb565(std::uint16_t color)
+{
+  const int r = (color >> 11) & 31;
+  const int g = (color >> 5) & 63;
+  const int b = color & 31;
+  return {(r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)};
+}
+
+/**
+ * @brief Encodes the color part of a 4x4 block.
+ *
+ * The endpoints are the corners of the color bounding box, inset a
+ * little to reduce the error of the interpolated colors. This is the
+ * classic fast encoder and good enough for the art in this game.
+ */
+static void encode_color_block(const unsigned char (&block)[16][4],
+                               unsigned char *out)
+{
+  unsigned char min[3] = {255, 255, 255};
+  unsigned char max[3] = {0, 0, 0};
+  for (const auto &texel : block)
+  {
+    for (int c = 0; c < 3; ++c)
+    {
+      min[c] = std::min(min[c], texel[c]);
+      max[c] = std::max(max[c], texel[c]);
+    }
+  }
+
+  for (int c = 0; c < 3; ++c)
+  {
+    const int inset = (max[c] - min[c]) / 16;
+    min[c]          = static_cast<unsigned char>(min[c] + inset);
+    max[c]          = static_cast<unsigned char>(max[c] - inset);
+  }
+
+  auto color0 = to_rgb565(max);
+  auto color1 = to_rgb565(min);
+  // color0 > color1 selects the four color mode
+  if (color0 < color1)
+    std::swap(color0, color1);
+
+  std::uint32_t indices = 0;
+  if (color0 != color1)
+  {
+    const auto c0 = from_rgb565(color0);
+    const auto c1 = from_rgb565(color1);
+
+    std::array<std::array<int, 3>, 4> palette;
+    for (int c = 0; c < 3; ++c)
+    {
+      palette[0][c] = c0[c];
+      palette[1][c] = c1[c];
+      palette[2][c] = (2 * c0[c] + c1[c]) / 3;
+      palette[3][c] = (c0[c] + 2 * c1[c]) / 3;
+    }
+
+    for (int i = 0; i < 16; ++i)
+    {
+      int best_index    = 0;
+      int best_distance = std::numeric_limits<int>::max();
+      for (int p = 0; p < 4; ++p)
+      {
+        int distance = 0;
+        for (int c = 0; c < 3; ++c)
+        {
+          const int d = block[i][c] - palette[p][c];
+          distance += d * d;
+        }
+        if (distance < best_distance)
+        {
+          best_distance = distance;
+          best_index    = p;
+        }
+      }
+      indices |= std::uint32_t(best_index) << (2 * i);
+    }
+  }
+
+  out[0] = static_cast<unsigned char>(color0 & 0xff);
+  out[1] = static_cast<unsigned char>(color0 >> 8);
+  out[2] = static_cast<unsigned char>(color1 & 0xff);
+  out[3] = static_cast<unsigned char>(color1 >> 8);
+  for (int i = 0; i < 4; ++i)
+    out[4 + i] = static_cast<unsigned char>(indices >> (8 * i));
+}
+
+/**
+ * @brief Encodes the alpha part of a BC3 block.
+ */
+static void encode_alpha_block(const unsigned char (&block)[16][4],
+                               unsigned char *out)
+{
+  unsigned char min = 255, max = 0;
+  for (const auto &texel : block)
+  {
+    min = std::min(min, texel[3]);
+    max = std::max(max, texel[3]);
+  }
+
+  // alpha0 > alpha1 selects eight interpolated values
+  std::array<int, 8> palette;
+  palette[0] = max;
+  palette[1] = min;
+  for (int i = 1; i < 7; ++i)
+    palette[i + 1] = ((7 - i) * max + i * min) / 7;
+
+  std::uint64_t indices = 0;
+  if (max != min)
+  {
+    for (int i = 0; i < 16; ++i)
+    {
+      int best_index    = 0;
+      int best_distance = std::numeric_limits<int>::max();
+      for (int p = 0; p < 8; ++p)
+      {
+        const int distance = std::abs(block[i][3] - palette[p]);
+        if (distance < best_distance)
+        {
+          best_distance = distance;
+          best_index    = p;
+        }
+      }
+      indices |= std::uint64_t(best_index) << (3 * i);
+    }
+  }
+
+  out[0] = max;
+  out[1] = min;
+  for (int i = 0; i < 6; ++i)
+    out[2 + i] = static_cast<unsigned char>(indices >> (8 * i));
+}
+
+static std::vector<unsigned char> encode_bc(const Image &image, Format format)
+{
+  const auto block_size = format == Format::BC1 ? 8 : 16;
+
+  std::vector<unsigned char> data(
+      CookedTexture::level_size(format, image.width, image.height));
+  auto out = data.data();
+
+  for (unsigned block_y = 0; block_y < image.height; block_y += 4)
+  {
+    for (unsigned block_x = 0; block_x < image.width; block_x += 4)
+    {
+      // Blocks reaching over the edge repeat the last row and column
+      unsigned char block[16][4];
+      for (unsigned y = 0; y < 4; ++y)
+      {
+        for (unsigned x = 0; x < 4; ++x)
+        {
+          const auto src_x = std::min(block_x + x, image.width - 1);
+          const auto src_y = std::min(block_y + y, image.height - 1);
+          const auto texel =
+              &image.pixels[(std::size_t(src_y) * image.width + src_x) *
+                            image.channels];
+          block[y * 4 + x][0] = texel[0];
+          block[y * 4 + x][1] = texel[1];
+          block[y * 4 + x][2] = texel[2];
+          block[y * 4 + x][3] = image.channels == 4 ? texel[3] : 255;
+        }
+      }
+
+      if (format == Format::BC3)
+      {
+        encode_alpha_block(block, out);
+        encode_color_block(block, out + 8);
+      }
+      else
+      {
+        encode_color_block(block, out);
+      }
+      out += block_size;
+    }
+  }
+
+  return data;
+}
+
+static Format target_format(unsigned channels, bool compress)
+{
+  if (compress)
+    return channels == 4 ? Format::BC3 : Format::BC1;
+  return channels == 4 ? Format::RGBA8 : Format::RGB8;
+}
+
+/**
+ * @brief Checks whether an existing cooked texture can be kept.
+ *
+ * It is up to date if it was cooked from the same source and with the
+ * same compression setting.
+ */
+static bool is_up_to_date(const std::filesystem::path &cooked_file,
+                          std::uint64_t                source_hash,
+                          bool                         compress)
+{
+  if (!std::filesystem::exists(cooked_file))
+    return false;
+
+  try
+  {
+    MappedFile    mapped_file(cooked_file.string());
+    CookedTexture cooked(mapped_file.data());
+    return cooked.get_source_hash() == source_hash &&
+           cooked.is_compressed() == compress;
+  }
+  catch (const std::runtime_error &)
+  {
+    return false;
+  }
+}
+
+static void cook(const std::filesystem::path &source_file,
+                 const std::filesystem::path &cooked_file,
+                 bool                         compress)
+{
+  MappedFile source(source_file.string());
+  const auto source_hash = hash_fnv1a(source.data());
+
+  if (is_up_to_date(cooked_file, source_hash, compress))
+  {
+    std::cout << "Up to date " << cooked_file.generic_string() << "\n";
+    return;
+  }
+
+  std::vector<Image> mips{decode(source.data())};
+  while (mips.back().width > 1 || mips.back().height > 1)
+    mips.push_back(downsample(mips.back()));
+
+  const auto format = target_format(mips[0].channels, compress);
+
+  std::vector<std::vector<unsigned char>> level_data;
+  std::vector<CookedTexture::Level>       levels;
+  for (const auto &mip : mips)
+  {
+    level_data.push_back(compress ? encode_bc(mip, format) : mip.pixels);
+    levels.push_back({mip.width, mip.height, level_data.back()});
+  }
+
+  std::filesystem::create_directories(cooked_file.parent_path());
+  CookedTexture::write(cooked_file.string(), format, source_hash, levels);
+
+  std::cout << "Cooked " << cooked_file.generic_string() << " ("
+            << mips[0].width << "x" << mips[0].height << ", " << levels.size()
+            << " levels)\n";
+}
+
+int main(int argc, char *argv[])
+{
+  std::vector<std::string> args(argv + 1, argv + argc);
+
+  bool compress = false;
+  if (!args.empty() && args[0] == "--bc")
+  {
+    compress = true;
+    args.erase(args.begin());
+  }
+
+  if (args.size() != 2)
+    return usage();
+
+  const std::filesystem::path textures_directory = args[0];
+  const std::filesystem::path output_directory   = args[1];
+
+  try
+  {
+    for (const auto &entry :
+         std::filesystem::recursive_directory_iterator(textures_directory))
+    {
+      if (!entry.is_regular_file() || !is_texture(entry.path()))
+        continue;
+
+      auto cooked_file =
+          output_directory /
+          std::filesystem::relative(entry.path(), textures_directory);
+      cooked_file += COOKED_TEXTURE_EXTENSION;
+
+      cook(entry.path(), cooked_file, compress);
+    }
+  }
+  catch (const std::exception &e)
+  {
+    std::cerr << e.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}